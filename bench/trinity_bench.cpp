@@ -0,0 +1,495 @@
+// Google Benchmark suite for the audio path and the spectrum kernels.
+// processBlock runs across block sizes, sample rates, channel counts and solo
+// modes, and the release/prepare cycle under each retention policy; the
+// crossover tree, the loudness meter, the test signal generator, every
+// SpectrumProcessing function and UiMagnitudeProcessor::process are measured
+// on their own. Output defaults to JSON so runs can be compared between builds:
+//
+//   trinity_bench --benchmark_out=before.json [--benchmark_filter=...]
+
+#include <JuceHeader.h>
+#include <benchmark/benchmark.h>
+#include <spdlog/sinks/null_sink.h>
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <array>
+#include <string>
+#include <vector>
+
+#include "TrinityProcessor.h"
+#include "services/AudioProcessorTest.h"
+#include "services/CrossoverTree.h"
+#include "services/LoudnessMeter.h"
+#include "services/SpectrumProcessing.h"
+#include "services/UiMagnitudeProcessor.h"
+
+namespace
+{
+    constexpr int fftSize = 2048;  // matches TrinityAudioProcessor
+    constexpr int numBins = fftSize / 2;
+    constexpr double kernelSampleRate = 48000.0;
+    constexpr double crossoverGlideSeconds = 0.05;  // matches TrinityAudioProcessor
+
+    // Reproducible pseudo-random content in [-amplitude, amplitude]
+    std::vector<float> makeNoise(size_t count, float amplitude, int64 seed)
+    {
+        Random random(seed);
+        std::vector<float> values(count);
+        for (float& value : values)
+        {
+            value = (random.nextFloat() * 2.0f - 1.0f) * amplitude;
+        }
+        return values;
+    }
+
+    // Power spectrum with a sloped floor, like real programme material
+    std::vector<float> makePowerSpectrum()
+    {
+        std::vector<float> power = makeNoise(numBins, 1.0f, 0x5eed);
+        for (size_t bin = 0; bin < power.size(); ++bin)
+        {
+            power[bin] = std::abs(power[bin]) * 1.0e-3f / static_cast<float>(1 + bin);
+        }
+        return power;
+    }
+
+    struct BandLayout
+    {
+        std::vector<double> f0Hz;
+        std::vector<double> f1Hz;
+        std::vector<int> binStart;
+        std::vector<int> binEnd;
+
+        explicit BandLayout(int numBands)
+        {
+            SpectrumProcessing::computeLogBandEdges(kernelSampleRate, fftSize, 61, numBands, f0Hz, f1Hz, binStart, binEnd);
+        }
+    };
+
+    int allowedEndBin()
+    {
+        return SpectrumProcessing::computeAllowedEndBin(kernelSampleRate, fftSize, 61);
+    }
+
+    // Pre-filled copies of an input that a kernel overwrites in place, handed
+    // out in turn. Once all have been used the pool is refilled with timing
+    // paused, so the pause is paid once per pool rather than per iteration.
+    template <typename Buffer>
+    class InputPool
+    {
+    public:
+        // Copies enough to spread the pause out, few enough to stay in cache
+        static constexpr size_t poolBytes = 256 * 1024;
+
+        static size_t copiesFor(size_t bytesPerCopy) noexcept
+        {
+            return std::max<size_t>(2, poolBytes / std::max<size_t>(1, bytesPerCopy));
+        }
+
+        InputPool(const Buffer& sourceToCopy, size_t numCopies)
+            : source(sourceToCopy),
+              copies(std::max<size_t>(1, numCopies), sourceToCopy)
+        {
+        }
+
+        // onRefill runs inside the pause, before the first copy is handed out again
+        template <typename OnRefill>
+        Buffer& next(benchmark::State& state, OnRefill&& onRefill)
+        {
+            if (this->nextCopy == this->copies.size())
+            {
+                state.PauseTiming();
+                for (Buffer& copy : this->copies)
+                {
+                    copy = this->source;
+                }
+                onRefill();
+                state.ResumeTiming();
+                this->nextCopy = 0;
+            }
+            return this->copies[this->nextCopy++];
+        }
+
+        Buffer& next(benchmark::State& state)
+        {
+            return this->next(state, [] {});
+        }
+
+    private:
+        const Buffer source;
+        std::vector<Buffer> copies;
+        size_t nextCopy { 0 };
+    };
+
+    AudioBuffer<float> makeNoiseBlock(int numChannels, int blockSize)
+    {
+        const std::vector<float> noise = makeNoise(static_cast<size_t>(blockSize), 0.25f, 0x7249);
+        AudioBuffer<float> block(numChannels, blockSize);
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            block.copyFrom(channel, 0, noise.data(), blockSize);
+        }
+        return block;
+    }
+
+    size_t blockBytes(int numChannels, int blockSize) noexcept
+    {
+        return static_cast<size_t>(numChannels) * static_cast<size_t>(blockSize) * sizeof(float);
+    }
+
+    // ===== processBlock =====
+
+    // Args: block size, sample rate (Hz), channels, SoloMode
+    void BM_ProcessBlock(benchmark::State& state)
+    {
+        const int blockSize = static_cast<int>(state.range(0));
+        const double sampleRate = static_cast<double>(state.range(1));
+        const int numChannels = static_cast<int>(state.range(2));
+        const auto soloMode = static_cast<SoloMode>(state.range(3));
+
+        TrinityAudioProcessor processor;
+        processor.setPlayConfigDetails(numChannels, numChannels, sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+        processor.setSoloMode(soloMode);
+
+        InputPool<AudioBuffer<float>> blocks(makeNoiseBlock(numChannels, blockSize),
+                                             InputPool<AudioBuffer<float>>::copiesFor(blockBytes(numChannels, blockSize)));
+        MidiBuffer midi;
+        for (auto _ : state)
+        {
+            processor.processBlock(blocks.next(state), midi);
+            benchmark::ClobberMemory();
+        }
+        processor.releaseResources();
+
+        state.SetItemsProcessed(state.iterations() * blockSize * numChannels);
+        // Seconds of audio per second of processing, i.e. the realtime factor
+        state.counters["realtime_x"] = benchmark::Counter(static_cast<double>(blockSize) / sampleRate,
+                                                          benchmark::Counter::kIsIterationInvariantRate);
+    }
+    BENCHMARK(BM_ProcessBlock)
+        ->ArgNames({ "block", "rate", "channels", "solo" })
+        ->ArgsProduct({ benchmark::CreateRange(16, 4096, 4),
+                        { 44100, 48000, 96000, 192000 },
+                        { 1, 2, 8 },
+                        { static_cast<int64_t>(SoloMode::None), static_cast<int64_t>(SoloMode::Band1),
+                          static_cast<int64_t>(SoloMode::Band2), static_cast<int64_t>(SoloMode::Band3) } });
+
+    // Stereo processBlock with both crossover cutoffs gliding the whole time,
+    // against BM_ProcessBlock at the same size for the retuning cost.
+    // Args: block size
+    void BM_ProcessBlockCrossoverGlide(benchmark::State& state)
+    {
+        const int blockSize = static_cast<int>(state.range(0));
+        constexpr double sampleRate = 48000.0;
+
+        TrinityAudioProcessor processor;
+        processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        // Alternate targets at every refill, which comes round within one
+        // glide, so the glide never settles
+        const auto blocksPerGlide = static_cast<size_t>(crossoverGlideSeconds * sampleRate) / static_cast<size_t>(blockSize);
+        InputPool<AudioBuffer<float>> blocks(makeNoiseBlock(2, blockSize),
+                                             std::min(blocksPerGlide, InputPool<AudioBuffer<float>>::copiesFor(blockBytes(2, blockSize))));
+        MidiBuffer midi;
+        bool raised = false;
+        const auto retarget = [&processor, &raised]
+        {
+            raised = !raised;
+            processor.setCrossoverFrequencies(raised ? CrossoverFrequencies::withCutoffs({ 400.0f, 4000.0f }) : CrossoverFrequencies {});
+        };
+        retarget();
+        for (auto _ : state)
+        {
+            processor.processBlock(blocks.next(state, retarget), midi);
+            benchmark::ClobberMemory();
+        }
+        processor.releaseResources();
+        state.SetItemsProcessed(state.iterations() * blockSize * 2);
+    }
+    BENCHMARK(BM_ProcessBlockCrossoverGlide)
+        ->ArgNames({ "block" })
+        ->Arg(64)->Arg(512);
+
+    // The crossover tree alone, summing all bands back into the buffer.
+    // Args: band count, channels (512-sample blocks at 48 kHz)
+    void BM_CrossoverTree(benchmark::State& state)
+    {
+        const int numBands = static_cast<int>(state.range(0));
+        const int numChannels = static_cast<int>(state.range(1));
+        constexpr int blockSize = 512;
+
+        CrossoverFrequencies frequencies;
+        frequencies.numBands = numBands;
+        CrossoverTree crossover;
+        crossover.prepare(48000.0, numChannels);
+        crossover.setCutoffs(frequencies.constrainedTo(48000.0));
+
+        AudioBuffer<float> buffer(numChannels, blockSize);
+        const std::vector<float> noise = makeNoise(static_cast<size_t>(blockSize), 0.25f, 0x5150);
+        std::array<float, CrossoverTree::maxBands> bandPeaks {};
+        CrossoverTree::BandTaps taps;
+        taps.peaks = bandPeaks.data();
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            buffer.copyFrom(channel, 0, noise.data(), blockSize);
+        }
+        for (auto _ : state)
+        {
+            crossover.process(buffer.getArrayOfReadPointers(), buffer.getArrayOfWritePointers(), numChannels, 0,
+                              blockSize, -1, taps);
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * blockSize * numChannels);
+    }
+    BENCHMARK(BM_CrossoverTree)
+        ->ArgNames({ "bands", "channels" })
+        ->ArgsProduct({ { 2, 3, 8 }, { 1, 2, 8 } });
+
+    // K-weighting and windowed loudness for the input plus each band, as
+    // processBlock runs it. Args: signals (1 + bands), channels
+    void BM_LoudnessMeter(benchmark::State& state)
+    {
+        const int numSignals = static_cast<int>(state.range(0));
+        const int numChannels = static_cast<int>(state.range(1));
+        constexpr int blockSize = 512;
+
+        LoudnessMeter meter;
+        meter.prepare(48000.0, numChannels);
+        meter.setNumSignals(numSignals);
+        const int frameStride = LoudnessMeter::maxSignals * numChannels;
+        const std::vector<float> noise = makeNoise(static_cast<size_t>(blockSize * frameStride), 0.25f, 0x1770);
+        for (auto _ : state)
+        {
+            meter.process(noise.data(), frameStride, blockSize);
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * blockSize * numSignals * numChannels);
+    }
+    BENCHMARK(BM_LoudnessMeter)
+        ->ArgNames({ "signals", "channels" })
+        ->ArgsProduct({ { 1, 4, 9 }, { 1, 2, 8 } });
+
+    // ===== prepareToPlay / releaseResources =====
+
+    // One host suspend/resume: releaseResources followed by prepareToPlay.
+    // Args: MemoryRetentionPolicy, what changes between cycles
+    // (0 nothing, 1 sample rate 44.1/48 kHz, 2 block size 256/512)
+    void BM_ReleaseAndPrepare(benchmark::State& state)
+    {
+        const auto policy = static_cast<MemoryRetentionPolicy>(state.range(0));
+        const int change = static_cast<int>(state.range(1));
+
+        TrinityAudioProcessor processor;
+        processor.setPlayConfigDetails(2, 2, 48000.0, 512);
+        processor.setMemoryRetentionPolicy(policy);
+        processor.prepareToPlay(48000.0, 512);
+        bool alternate = false;
+        for (auto _ : state)
+        {
+            alternate = !alternate;
+            const double sampleRate = change == 1 && alternate ? 44100.0 : 48000.0;
+            const int blockSize = change == 2 && alternate ? 256 : 512;
+            processor.releaseResources();
+            processor.prepareToPlay(sampleRate, blockSize);
+            benchmark::ClobberMemory();
+        }
+        processor.releaseResources();
+    }
+    BENCHMARK(BM_ReleaseAndPrepare)
+        ->ArgNames({ "policy", "change" })
+        ->ArgsProduct({ { static_cast<int64_t>(MemoryRetentionPolicy::RetainBuffers),
+                          static_cast<int64_t>(MemoryRetentionPolicy::ReleaseAll) },
+                        { 0, 1, 2 } })
+        ->Unit(benchmark::kMicrosecond);
+
+    // ===== Test signal generator =====
+
+    // Args: TestSignalType, block size (stereo, fixed seed)
+    void BM_TestSignal(benchmark::State& state)
+    {
+        const int signalType = static_cast<int>(state.range(0));
+        const int blockSize = static_cast<int>(state.range(1));
+        AudioTestProcessor generator;
+        generator.setType(signalType);
+        generator.prepare(48000.0, 20000.0);
+        AudioBuffer<float> buffer(2, blockSize);
+        for (auto _ : state)
+        {
+            generator.generate(buffer);
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * blockSize);
+    }
+    BENCHMARK(BM_TestSignal)
+        ->ArgNames({ "type", "block" })
+        ->ArgsProduct({ { kSine17k, kWhiteNoise, kPinkNoise, kLogSweep, kMls, kSyncSweep }, { 64, 512 } });
+
+    // ===== SpectrumProcessing kernels =====
+
+    void BM_ComputeAllowedEndBin(benchmark::State& state)
+    {
+        int hiGuardBins = 61;
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(hiGuardBins);
+            benchmark::DoNotOptimize(SpectrumProcessing::computeAllowedEndBin(kernelSampleRate, fftSize, hiGuardBins));
+        }
+    }
+    BENCHMARK(BM_ComputeAllowedEndBin);
+
+    void BM_ComputeLogBandEdges(benchmark::State& state)
+    {
+        const int numBands = static_cast<int>(state.range(0));
+        std::vector<double> f0Hz, f1Hz;
+        std::vector<int> binStart, binEnd;
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(SpectrumProcessing::computeLogBandEdges(kernelSampleRate, fftSize, 61, numBands,
+                                                                            f0Hz, f1Hz, binStart, binEnd));
+            benchmark::ClobberMemory();
+        }
+    }
+    BENCHMARK(BM_ComputeLogBandEdges)->ArgName("bands")->Arg(48)->Arg(96)->Arg(192);
+
+    void BM_ZeroStrictlyAbove(benchmark::State& state)
+    {
+        std::vector<float> power = makePowerSpectrum();
+        const int allowedEnd = allowedEndBin();
+        for (auto _ : state)
+        {
+            SpectrumProcessing::zeroStrictlyAbove(power, allowedEnd);
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * numBins);
+    }
+    BENCHMARK(BM_ZeroStrictlyAbove);
+
+    void BM_FrequencySmoothTriangular(benchmark::State& state)
+    {
+        const bool enabled = state.range(0) != 0;
+        const std::vector<float> power = makePowerSpectrum();
+        std::vector<float> smoothed(power.size(), 0.0f);
+        const int allowedEnd = allowedEndBin();
+        for (auto _ : state)
+        {
+            SpectrumProcessing::frequencySmoothTriangularIfEnabled(power, smoothed, allowedEnd, enabled);
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * numBins);
+    }
+    BENCHMARK(BM_FrequencySmoothTriangular)->ArgName("enabled")->Arg(0)->Arg(1);
+
+    void BM_ApplyCosineTaper(benchmark::State& state)
+    {
+        const float taperPercent = static_cast<float>(state.range(0)) / 100.0f;
+        // Tapering in place would decay the same bins towards denormals and zero
+        InputPool<std::vector<float>> spectra(makePowerSpectrum(),
+                                              InputPool<std::vector<float>>::copiesFor(static_cast<size_t>(numBins) * sizeof(float)));
+        const int allowedEnd = allowedEndBin();
+        for (auto _ : state)
+        {
+            SpectrumProcessing::applyCosineTaper(spectra.next(state), allowedEnd, taperPercent);
+            benchmark::ClobberMemory();
+        }
+    }
+    BENCHMARK(BM_ApplyCosineTaper)->ArgName("taper_percent")->Arg(2)->Arg(20);
+
+    void BM_BandMeanPower(benchmark::State& state)
+    {
+        const BandLayout layout(96);
+        const std::vector<float> power = makePowerSpectrum();
+        const int allowedEnd = allowedEndBin();
+        const double binHz = kernelSampleRate / fftSize;
+        const int band = static_cast<int>(state.range(0));
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(SpectrumProcessing::bandMeanPower(power, allowedEnd, binHz, layout.f0Hz, layout.f1Hz, band));
+        }
+    }
+    BENCHMARK(BM_BandMeanPower)->ArgName("band")->Arg(0)->Arg(48)->Arg(95);
+
+    void BM_AggregateBandsFractional(benchmark::State& state)
+    {
+        const int numBands = static_cast<int>(state.range(0));
+        const BandLayout layout(numBands);
+        const std::vector<float> power = makePowerSpectrum();
+        std::vector<float> bands(static_cast<size_t>(numBands), 0.0f);
+        std::vector<float> bandsPreSmooth(static_cast<size_t>(numBands), 0.0f);
+        const int allowedEnd = allowedEndBin();
+        for (auto _ : state)
+        {
+            SpectrumProcessing::aggregateBandsFractional(power, allowedEnd, kernelSampleRate / fftSize,
+                                                         layout.f0Hz, layout.f1Hz, -120.0f, 0.0f,
+                                                         bands, bandsPreSmooth);
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * numBands);
+    }
+    BENCHMARK(BM_AggregateBandsFractional)->ArgName("bands")->Arg(48)->Arg(96)->Arg(192);
+
+    void BM_SmoothBandsInPlace(benchmark::State& state)
+    {
+        const int numBands = static_cast<int>(state.range(0));
+        InputPool<std::vector<float>> bands(makeNoise(static_cast<size_t>(numBands), 0.5f, 0xba5d),
+                                            InputPool<std::vector<float>>::copiesFor(static_cast<size_t>(numBands) * sizeof(float)));
+        for (auto _ : state)
+        {
+            SpectrumProcessing::smoothBandsInPlace(bands.next(state), true);
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * numBands);
+    }
+    BENCHMARK(BM_SmoothBandsInPlace)->ArgName("bands")->Arg(48)->Arg(96)->Arg(192);
+
+    // ===== UI kernels =====
+
+    void BM_UiMagnitudeProcessor(benchmark::State& state)
+    {
+        const int numBands = static_cast<int>(state.range(0));
+        const std::vector<float> frameA = makeNoise(static_cast<size_t>(numBands), 0.5f, 1);
+        const std::vector<float> frameB = makeNoise(static_cast<size_t>(numBands), 0.5f, 2);
+        std::vector<float> smoothed, peaks, scratch;
+        const UiDynamicsSettings settings;
+        bool useA = true;
+        for (auto _ : state)
+        {
+            const std::vector<float>& frame = useA ? frameA : frameB;
+            useA = !useA;
+            benchmark::DoNotOptimize(UiMagnitudeProcessor::process(frame, smoothed, peaks, scratch, settings, 1000.0f / 60.0f));
+        }
+        state.SetItemsProcessed(state.iterations() * numBands);
+    }
+    BENCHMARK(BM_UiMagnitudeProcessor)->ArgName("bands")->Arg(48)->Arg(96)->Arg(192)->Arg(1024);
+}
+
+int main(int argc, char** argv)
+{
+    ScopedJuceInitialiser_GUI juceInitialiser;
+    // Keep the processor's log lines out of the JSON on stdout
+    spdlog::create<spdlog::sinks::null_sink_mt>("Trinity");
+
+    // JSON unless the caller picked a format
+    std::vector<char*> args(argv, argv + argc);
+    std::string defaultFormat = "--benchmark_format=json";
+    bool hasFormat = false;
+    for (int argIndex = 1; argIndex < argc; ++argIndex)
+    {
+        hasFormat = hasFormat || std::string(argv[argIndex]).rfind("--benchmark_format", 0) == 0;
+    }
+    if (!hasFormat)
+    {
+        args.push_back(defaultFormat.data());
+    }
+    int argCount = static_cast<int>(args.size());
+
+    benchmark::Initialize(&argCount, args.data());
+    if (benchmark::ReportUnrecognizedArguments(argCount, args.data()))
+    {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
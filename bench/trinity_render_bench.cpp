@@ -0,0 +1,268 @@
+// Headless render benchmark for the editor components.
+// Renders GraphicalSpectrumAnalyzer, SpectrogramView, AudioMeter,
+// AudioSpectrumMeters and the full editor into offscreen images at several
+// sizes and band counts, and prints ns/frame percentiles as CSV.
+//
+//   trinity_render_bench [--frames N] [--warmup N]
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+#include "TrinityProcessor.h"
+#include "TrinityEditor.h"
+#include "components/AudioMeter.h"
+#include "components/AudioSpectrumMeters.h"
+#include "components/GraphicalSpectrumAnalyzer.h"
+#include "components/SpectrogramView.h"
+
+namespace
+{
+    struct RenderSize
+    {
+        int width;
+        int height;
+    };
+
+    constexpr RenderSize renderSizes[] { { 700, 800 }, { 1400, 1600 }, { 3840, 2160 } };
+    constexpr int bandCounts[] { 48, 96, 192 };
+    constexpr float frameMs = 1000.0f / 60.0f;
+
+    struct BenchOptions
+    {
+        int frames { 240 };
+        int warmupFrames { 30 };
+    };
+
+    BenchOptions parseOptions(int argc, char* argv[])
+    {
+        BenchOptions options;
+        for (int argIndex = 1; argIndex + 1 < argc; ++argIndex)
+        {
+            const String arg(argv[argIndex]);
+            if (arg == "--frames")
+            {
+                options.frames = jmax(1, String(argv[++argIndex]).getIntValue());
+            }
+            else if (arg == "--warmup")
+            {
+                options.warmupFrames = jmax(0, String(argv[++argIndex]).getIntValue());
+            }
+        }
+        return options;
+    }
+
+    // Deterministic synthetic spectrum: sloped floor, ripple and a drifting peak,
+    // so every frame is new and the ballistics never settle.
+    class SyntheticSpectrum
+    {
+    public:
+        explicit SyntheticSpectrum(int numBands)
+            : values(static_cast<size_t>(numBands), 0.0f)
+        {
+        }
+
+        SpectrumFrameView next()
+        {
+            ++this->sequence;
+            const float time = static_cast<float>(this->sequence) * 0.05f;
+            const int numBands = static_cast<int>(this->values.size());
+            const float peakCentre = 0.5f + 0.3f * std::sin(time * 0.7f);
+            for (int band = 0; band < numBands; ++band)
+            {
+                const float position = static_cast<float>(band) / static_cast<float>(jmax(1, numBands - 1));
+                const float floorLevel = 0.75f - 0.35f * position;
+                const float ripple = 0.08f * std::sin(time + position * 23.0f);
+                const float peakDistance = (position - peakCentre) * 12.0f;
+                const float peak = 0.2f * std::exp(-peakDistance * peakDistance);
+                this->values[static_cast<size_t>(band)] = jlimit(0.0f, 1.0f, floorLevel + ripple + peak);
+            }
+            return { this->values.data(), numBands, this->sequence };
+        }
+
+    private:
+        std::vector<float> values;
+        uint64_t sequence { 0 };
+    };
+
+    double percentile(const std::vector<double>& sorted, double fraction)
+    {
+        const auto index = static_cast<size_t>(std::round(fraction * static_cast<double>(sorted.size() - 1)));
+        return sorted[index];
+    }
+
+    void printHeader()
+    {
+        std::printf("component,width,height,bands,frames,mean_ns,p50_ns,p90_ns,p99_ns,max_ns\n");
+    }
+
+    void report(const char* component, const RenderSize& size, int bands, std::vector<double> frameNs)
+    {
+        if (frameNs.empty())
+        {
+            return;
+        }
+        std::sort(frameNs.begin(), frameNs.end());
+        double sum = 0.0;
+        for (double value : frameNs)
+        {
+            sum += value;
+        }
+        std::printf("%s,%d,%d,%d,%d,%.0f,%.0f,%.0f,%.0f,%.0f\n",
+                    component, size.width, size.height, bands, static_cast<int>(frameNs.size()),
+                    sum / static_cast<double>(frameNs.size()),
+                    percentile(frameNs, 0.50), percentile(frameNs, 0.90),
+                    percentile(frameNs, 0.99), frameNs.back());
+        std::fflush(stdout);
+    }
+
+    // Step UI state, then paint the whole component into the image; both are timed.
+    std::vector<double> runRenderLoop(Component& component,
+                                      Image& image,
+                                      const BenchOptions& options,
+                                      const std::function<void()>& stepFrame,
+                                      const std::function<void()>& untimedSetup = {})
+    {
+        std::vector<double> frameNs;
+        frameNs.reserve(static_cast<size_t>(options.frames));
+        for (int frame = 0; frame < options.warmupFrames + options.frames; ++frame)
+        {
+            if (untimedSetup)
+            {
+                untimedSetup();
+            }
+            Graphics graphics(image);
+            const int64 startTicks = Time::getHighResolutionTicks();
+            stepFrame();
+            component.paintEntireComponent(graphics, true);
+            const int64 endTicks = Time::getHighResolutionTicks();
+            if (frame >= options.warmupFrames)
+            {
+                frameNs.push_back(Time::highResolutionTicksToSeconds(endTicks - startTicks) * 1.0e9);
+            }
+        }
+        return frameNs;
+    }
+
+    void benchAnalyzer(const RenderSize& size, int bands, const BenchOptions& options)
+    {
+        GraphicalSpectrumAnalyzer analyzer;
+        analyzer.setBounds(0, 0, size.width, size.height);
+        analyzer.setFrequencyRange(20.0f, 20000.0f);
+        SyntheticSpectrum spectrum(bands);
+        Image image(Image::ARGB, size.width, size.height, true);
+        report("GraphicalSpectrumAnalyzer", size, bands,
+               runRenderLoop(analyzer, image, options, [&] { analyzer.setFrame(spectrum.next(), frameMs); }));
+    }
+
+    void benchSpectrogram(const RenderSize& size, int bands, const BenchOptions& options)
+    {
+        SpectrogramView spectrogram;
+        spectrogram.setBounds(0, 0, size.width, size.height);
+        SyntheticSpectrum spectrum(bands);
+        Image image(Image::ARGB, size.width, size.height, true);
+        report("SpectrogramView", size, bands,
+               runRenderLoop(spectrogram, image, options, [&] { spectrogram.setFrame(spectrum.next()); }));
+    }
+
+    void benchMeter(const RenderSize& size, const BenchOptions& options)
+    {
+        AudioMeter meter;
+        float level = 0.0f;
+        int frameIndex = 0;
+        meter.setLevelPointer(&level);
+        meter.setLabel("Total");
+        meter.setBounds(0, 0, size.width, size.height);
+        Image image(Image::ARGB, size.width, size.height, true);
+        report("AudioMeter", size, 1,
+               runRenderLoop(meter, image, options, [&]
+               {
+                   level = 0.5f + 0.45f * std::sin(static_cast<float>(++frameIndex) * 0.1f);
+                   meter.advanceFrame(frameMs);
+               }));
+    }
+
+    void benchMeterGroup(const RenderSize& size, const BenchOptions& options)
+    {
+        std::array<float, 4> levels {};
+        std::array<MeterInfo, 4> infos {
+            MeterInfo { &levels[0], "Total" },
+            MeterInfo { &levels[1], "Low" },
+            MeterInfo { &levels[2], "Mid" },
+            MeterInfo { &levels[3], "High" },
+        };
+        AudioSpectrumMeters meters;
+        meters.setMeters(infos);
+        meters.setBounds(0, 0, size.width, size.height);
+        int frameIndex = 0;
+        Image image(Image::ARGB, size.width, size.height, true);
+        report("AudioSpectrumMeters", size, 4,
+               runRenderLoop(meters, image, options, [&]
+               {
+                   ++frameIndex;
+                   for (size_t meterIndex = 0; meterIndex < levels.size(); ++meterIndex)
+                   {
+                       const float phase = static_cast<float>(frameIndex) * 0.1f + static_cast<float>(meterIndex);
+                       levels[meterIndex] = 0.5f + 0.45f * std::sin(phase);
+                   }
+                   meters.advanceFrame(frameMs);
+               }));
+    }
+
+    void benchEditor(const RenderSize& size, const BenchOptions& options)
+    {
+        constexpr double sampleRate = 48000.0;
+        constexpr int blockSize = 2048; // one analysis frame per rendered frame
+        TrinityAudioProcessor processor;
+        processor.prepareToPlay(sampleRate, blockSize);
+        AudioBuffer<float> audio(2, blockSize);
+        MidiBuffer midi;
+        Random random(0x7249);
+
+        auto editor = std::make_unique<TrinityAudioProcessorEditor>(processor);
+        editor->setSize(size.width, size.height);
+        Image image(Image::ARGB, size.width, size.height, true);
+
+        // Feeding audio is not part of the UI cost, so it runs untimed
+        auto feedAudio = [&]
+        {
+            for (int channel = 0; channel < audio.getNumChannels(); ++channel)
+            {
+                float* samples = audio.getWritePointer(channel);
+                for (int sampleIndex = 0; sampleIndex < blockSize; ++sampleIndex)
+                {
+                    samples[sampleIndex] = (random.nextFloat() * 2.0f - 1.0f) * 0.25f;
+                }
+            }
+            processor.processBlock(audio, midi);
+        };
+        report("TrinityAudioProcessorEditor", size, 96,
+               runRenderLoop(*editor, image, options, [&] { editor->renderFrame(frameMs); }, feedAudio));
+        editor.reset();
+        processor.releaseResources();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    ScopedJuceInitialiser_GUI juceInitialiser;
+    const BenchOptions options = parseOptions(argc, argv);
+
+    printHeader();
+    for (const RenderSize& size : renderSizes)
+    {
+        for (int bands : bandCounts)
+        {
+            benchAnalyzer(size, bands, options);
+            benchSpectrogram(size, bands, options);
+        }
+        benchMeter(size, options);
+        benchMeterGroup(size, options);
+        benchEditor(size, options);
+    }
+    return 0;
+}
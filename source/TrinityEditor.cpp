@@ -3,21 +3,26 @@
 #include <vector>
 #include <cmath>
 #include "services/LevelColourScale.h"
+#include "services/UiBallistics.h"
 
 void TrinityAudioProcessorEditor::initSpectrumAnalyzerControls()
 {
-    // Add spectrum analyzer
+    // Add spectrum analyzer and its scrolling history underneath
     this->addAndMakeVisible(this->spectrumAnalyzer);
+    this->addAndMakeVisible(this->spectrogram);
 
     // Controls: Test Signal + type, Debug CSV
     this->addAndMakeVisible(this->btnTestEnabled);
     this->addAndMakeVisible(this->cbxTestType);
-    this->addAndMakeVisible(this->btnDebugCsv);
+    this->addAndMakeVisible(this->btnDebugCapture);
+    this->addAndMakeVisible(this->btnSpikeCatcher);
+    this->addAndMakeVisible(this->btnResetLoudness);
 
-    // Solo buttons
-    this->addAndMakeVisible(this->btnSoloLow);
-    this->addAndMakeVisible(this->btnSoloMid);
-    this->addAndMakeVisible(this->btnSoloHigh);
+    // Solo buttons; the band count decides which are visible
+    for (ToggleButton& soloButton : this->soloButtons)
+    {
+        this->addChildComponent(soloButton);
+    }
 
     // Diagnostics toggles and sliders
     this->addAndMakeVisible(this->btnUiSmooth);
@@ -34,8 +39,12 @@ void TrinityAudioProcessorEditor::initSpectrumAnalyzerButtons()
     this->cbxTestType.addItem("Sine 17 kHz",  kSine17k);
     this->cbxTestType.addItem("Sine 19 kHz",  kSine19k);
     this->cbxTestType.addItem("White noise",  kWhiteNoise);
-    this->cbxTestType.addItem("Pink-ish noise", kPinkNoise);
+    this->cbxTestType.addItem("Pink noise",   kPinkNoise);
     this->cbxTestType.addItem("Log sweep",    kLogSweep);
+    this->cbxTestType.addItem("Multitone",    kMultitone);
+    this->cbxTestType.addItem("Impulse",      kImpulse);
+    this->cbxTestType.addItem("MLS",          kMls);
+    this->cbxTestType.addItem("Sync sweep",   kSyncSweep);
     this->cbxTestType.setSelectedId(kSine17k, dontSendNotification);
 }
 
@@ -46,21 +55,36 @@ TrinityAudioProcessorEditor::TrinityAudioProcessorEditor(
 {
     // Increase default editor size for better readability and less cramped UI
     this->setSize(700, 800);
-    this->startTimerHz(30);
-    this->meters = {
-        MeterInfo { &this->displayTotal, "Total" },
-        MeterInfo { &this->displayLow,   "Low"   },
-        MeterInfo { &this->displayMid,   "Mid"   },
-        MeterInfo { &this->displayHigh,  "High"  },
-    };
+    this->framePacer.reset(nowSeconds());
+#if TRINITY_HAS_VBLANK
+    this->vBlankAttachment = std::make_unique<VBlankAttachment>(this, [this]
+    {
+        const double now = nowSeconds();
+        this->lastVBlankSeconds = now;
+        this->setTimerDriven(false);
+        this->onFrameTick(now);
+    });
+#else
+    this->setTimerDriven(true);
+#endif
+    this->updateTimerRate();
+    // Band meters are labelled from the live crossover
+    for (size_t meterIndex = 0; meterIndex < this->meters.size(); ++meterIndex)
+    {
+        this->meters[meterIndex] = MeterInfo { &this->displayLevels[meterIndex], meterIndex == 0 ? "Total" : nullptr,
+                                               &this->displayRms[meterIndex], &this->displayLoudness[meterIndex] };
+    }
 
     this->initSpectrumAnalyzerControls();
 
     this->initSpectrumAnalyzerButtons();
 
-    // Add meters component and connect its four child meters to our level pointers
+    // Add meters component; updateCrossoverDisplay connects one meter per band
     this->addAndMakeVisible(this->audioMeters);
-    this->audioMeters.setMeters(this->meters);
+
+    this->addAndMakeVisible(this->deadlinePanel);
+    this->deadlinePanel.setStatsSource([this] { return this->processor.getDeadlineStats(); });
+    this->deadlinePanel.onReset = [this] { this->processor.resetDeadlineStats(); };
 
     this->btnTestEnabled.onClick = [this]
     {
@@ -72,54 +96,58 @@ TrinityAudioProcessorEditor::TrinityAudioProcessorEditor(
         this->processor.setTestType (this->cbxTestType.getSelectedId());
     };
 
-    this->btnDebugCsv.onClick = [this]
+    this->btnDebugCapture.setToggleState(this->processor.isDebugCaptureRunning(), dontSendNotification);
+    this->btnDebugCapture.onClick = [this]
     {
-        if (this->btnDebugCsv.getToggleState())
+        if (this->btnDebugCapture.getToggleState())
         {
-            this->debugHeaderWritten = false;
-            this->ensureDebugStreamOpen();
-            this->processor.setDebugCaptureEnabled (true);
+            const File captureFile = getDebugCaptureFile();
+            if (!this->processor.startDebugCapture(captureFile))
+            {
+                this->btnDebugCapture.setToggleState(false, dontSendNotification);
+            }
         }
         else
         {
-            this->debugStream.reset();
-            this->processor.setDebugCaptureEnabled (false);
+            this->processor.stopDebugCapture();
         }
     };
 
-    // Solo button wiring (mutually exclusive)
-    this->btnSoloLow.onClick = [this]
+    this->btnSpikeCatcher.setToggleState(this->processor.getSpikeCatcher().isArmed(), dontSendNotification);
+    this->btnSpikeCatcher.onClick = [this]
     {
-        const bool shouldSolo = this->btnSoloLow.getToggleState();
-        this->btnSoloMid.setToggleState(false, dontSendNotification);
-        this->btnSoloHigh.setToggleState(false, dontSendNotification);
-        this->processor.setSoloMode(shouldSolo ? SoloMode::Low
-                                               : SoloMode::None);
+        if (this->btnSpikeCatcher.getToggleState())
+        {
+            // Catch every deadline overrun: threshold is the prepared block's budget
+            const double sampleRate = this->processor.getSampleRate();
+            const double thresholdMs = sampleRate > 0.0 ? 1000.0 * this->processor.getBlockSize() / sampleRate : 10.0;
+            if (!this->processor.startSpikeCatcher(getSpikeBundleDirectory(), thresholdMs))
+            {
+                this->btnSpikeCatcher.setToggleState(false, dontSendNotification);
+            }
+        }
+        else
+        {
+            this->processor.stopSpikeCatcher();
+        }
     };
 
-    this->btnSoloMid.onClick = [this]
-    {
-        const bool shouldSolo = this->btnSoloMid.getToggleState();
-        this->btnSoloLow.setToggleState(false, dontSendNotification);
-        this->btnSoloHigh.setToggleState(false, dontSendNotification);
-        this->processor.setSoloMode(shouldSolo ? SoloMode::Mid
-                                               : SoloMode::None);
-    };
+    // Integrated loudness and range restart from the next block
+    this->btnResetLoudness.onClick = [this] { this->processor.resetLoudness(); };
 
-    this->btnSoloHigh.onClick = [this]
+    // Solo button wiring (mutually exclusive)
+    for (int band = 0; band < CrossoverFrequencies::maxBands; ++band)
     {
-        const bool shouldSolo = this->btnSoloHigh.getToggleState();
-        this->btnSoloLow.setToggleState(false, dontSendNotification);
-        this->btnSoloMid.setToggleState(false, dontSendNotification);
-        this->processor.setSoloMode(shouldSolo ? SoloMode::High
-                                               : SoloMode::None);
-    };
+        ToggleButton& soloButton = this->soloButtons[static_cast<size_t>(band)];
+        soloButton.onClick = [this, band, &soloButton]
+        {
+            this->selectSoloBand(band, soloButton.getToggleState());
+        };
+    }
 
     // Initial state
-    this->btnSoloLow.setToggleState(false, dontSendNotification);
-    this->btnSoloMid.setToggleState(false, dontSendNotification);
-    this->btnSoloHigh.setToggleState(false, dontSendNotification);
-    this->processor.setSoloMode(SoloMode::None);
+    this->selectSoloBand(0, false);
+    this->updateCrossoverDisplay();
 
     // Initialize and wire diagnostics controls
     this->btnUiSmooth.setToggleState(true, dontSendNotification);
@@ -183,55 +211,195 @@ TrinityAudioProcessorEditor::TrinityAudioProcessorEditor(
     this->TrinityAudioProcessorEditor::resized();
 }
 
-void TrinityAudioProcessorEditor::updateDisplayAndSmoothLevels()
+void TrinityAudioProcessorEditor::updateDisplayAndSmoothLevels(float elapsedMs)
 {
-    constexpr float smoothing = 0.10f;
+    constexpr float levelSmoothingMs = 316.0f;
+    const float smoothing = UiBallistics::coefficientForElapsed(levelSmoothingMs, elapsedMs);
 
     auto smooth = [smoothing](float current, float target)
     {
         return current * (1.0f - smoothing) + target * smoothing;
     };
-    this->displayTotal = smooth(this->displayTotal, this->processor.getTotalLevel());
-    this->displayLow = smooth(this->displayLow, this->processor.getLowLevel());
-    this->displayMid = smooth(this->displayMid, this->processor.getMidLevel());
-    this->displayHigh = smooth(this->displayHigh, this->processor.getHighLevel());
+
+    // Each reading covers every block since the previous frame
+    constexpr float rmsIntegrationMs = 300.0f;
+    const float rmsCoefficient = UiBallistics::coefficientForElapsed(rmsIntegrationMs, elapsedMs);
+    for (int meterIndex = 0; meterIndex < AudioSpectrumMeters::maxMeters; ++meterIndex)
+    {
+        const auto index = static_cast<size_t>(meterIndex);
+        const LevelReading reading = meterIndex == 0 ? this->processor.takeTotalLevel()
+                                                     : this->processor.takeBandLevel(meterIndex - 1);
+        if (reading.numSamples > 0)
+        {
+            this->peakTargets[index] = reading.peak;
+            this->displayMeanSquares[index] += (reading.meanSquare - this->displayMeanSquares[index]) * rmsCoefficient;
+        }
+        this->displayLevels[index] = smooth(this->displayLevels[index], this->peakTargets[index]);
+        this->displayRms[index] = std::sqrt(this->displayMeanSquares[index]);
+        this->displayLoudness[index] = this->processor.getLoudness(meterIndex);
+    }
 }
 
-void TrinityAudioProcessorEditor::timerCallback()
+void TrinityAudioProcessorEditor::selectSoloBand(int band, bool shouldSolo)
 {
-    this->updateDisplayAndSmoothLevels();
+    for (int otherBand = 0; otherBand < CrossoverFrequencies::maxBands; ++otherBand)
     {
-        std::vector<float> spectrumMagnitudes;
-        this->processor.copySpectrum(spectrumMagnitudes); // values in [0..1]
-        if (!spectrumMagnitudes.empty())
+        if (otherBand != band)
         {
-            this->spectrumAnalyzer.setMagnitudes(spectrumMagnitudes);
+            this->soloButtons[static_cast<size_t>(otherBand)].setToggleState(false, dontSendNotification);
         }
     }
+    this->processor.setSoloMode(shouldSolo ? soloModeForBand(band) : SoloMode::None);
+}
+
+double TrinityAudioProcessorEditor::nowSeconds() noexcept
+{
+    return Time::getMillisecondCounterHiRes() * 0.001;
+}
+
+void TrinityAudioProcessorEditor::timerCallback()
+{
+#if TRINITY_HAS_VBLANK
+    // VBlank is driving frames; the timer only covers hosts/platforms where it never fires.
+    const double now = nowSeconds();
+    if (this->lastVBlankSeconds >= 0.0 && now - this->lastVBlankSeconds < 0.25)
+    {
+        return;
+    }
+    this->setTimerDriven(true);
+    this->onFrameTick(now);
+#else
+    this->onFrameTick(nowSeconds());
+#endif
+}
+
+void TrinityAudioProcessorEditor::onFrameTick(double nowSeconds)
+{
+    if (!this->framePacer.isFrameDue(nowSeconds))
+    {
+        return;
+    }
+    const double elapsedSeconds = this->framePacer.beginFrame(nowSeconds);
+    this->renderFrame(static_cast<float>(elapsedSeconds * 1000.0));
+    this->updateTimerRate();
+}
+
+void TrinityAudioProcessorEditor::renderFrame(float elapsedMs)
+{
+    this->updateDisplayAndSmoothLevels(elapsedMs);
+    // Read the latest analysis frame in place; repeated frames are skipped by sequence.
+    // Both views consume the same view, valid until the next acquire.
+    const SpectrumFrameView spectrumFrame = this->processor.acquireSpectrumFrame();
+    this->spectrumAnalyzer.setFrame(spectrumFrame, elapsedMs);
+    const bool spectrogramChanged = this->spectrogram.setFrame(spectrumFrame);
 
     // Keep analyzer ticks aligned to processor's current display maximum
     this->spectrumAnalyzer.setFrequencyRange(20.0f, static_cast<float>(this->processor.getDisplayMaxHz()));
+    this->updateCrossoverDisplay();
+
+    // Advance meters UI state (peak-hold/clip); they only repaint on visible change
+    const bool metersChanged = this->audioMeters.advanceFrame(elapsedMs);
+    // The deadline panel refreshes a few times per second on its own and is
+    // not animation, so it does not hold the pacer at full rate
+    this->deadlinePanel.advanceFrame(elapsedMs);
+    const bool hadActivity = metersChanged || spectrogramChanged || this->spectrumAnalyzer.isAnimating();
+    this->framePacer.reportActivity(hadActivity);
+    if (hadActivity)
+    {
+        this->repaint(); // repaint editor backdrop; child meters repaint internally
+    }
+}
+
+void TrinityAudioProcessorEditor::updateCrossoverDisplay()
+{
+    // Whole hertz are enough for labels; this also stops a glide tail from
+    // relabelling on every frame
+    CrossoverFrequencies rounded = this->processor.getCrossoverFrequencies();
+    for (float& cutoffHz : rounded.cutoffsHz)
+    {
+        cutoffHz = std::round(cutoffHz);
+    }
+    if (rounded == this->shownCrossovers)
+    {
+        return;
+    }
+    const int numBands = rounded.numBands;
+    const bool bandCountChanged = numBands != this->shownCrossovers.numBands;
+    this->shownCrossovers = rounded;
+    this->spectrumAnalyzer.setCrossoverFrequencies(rounded);
 
-    // Throttled debug CSV snapshot
-    if (this->btnDebugCsv.getToggleState())
+    if (bandCountChanged)
     {
-        if (++this->debugFrameCounter >= 15) // ~0.5s at 30 Hz
+        this->audioMeters.setMeters(std::span<const MeterInfo>(this->meters).first(static_cast<size_t>(1 + numBands)));
+        for (int band = 0; band < CrossoverFrequencies::maxBands; ++band)
+        {
+            ToggleButton& soloButton = this->soloButtons[static_cast<size_t>(band)];
+            soloButton.setVisible(band < numBands);
+            // A soloed band that went away falls back to the full sum
+            if (band >= numBands && soloButton.getToggleState())
+            {
+                this->selectSoloBand(band, false);
+                soloButton.setToggleState(false, dontSendNotification);
+            }
+        }
+        if (!this->getLocalBounds().isEmpty())
         {
-            this->debugFrameCounter = 0;
-            this->writeDebugCsvSnapshot();
+            this->resized();
         }
     }
 
-    // Advance meters UI state (peak-hold/clip)
-    this->audioMeters.advanceFrame();
-    this->repaint(); // repaint editor backdrop; child meters repaint internally
+    // "Low <250", "Mid 250-2k", "High >2k"
+    for (int band = 0; band < numBands; ++band)
+    {
+        const String name(CrossoverFrequencies::bandName(band, numBands));
+        const String lowerHz = band > 0 ? formatCrossoverHz(rounded.cutoffsHz[static_cast<size_t>(band - 1)]) : String();
+        const String upperHz = band < numBands - 1 ? formatCrossoverHz(rounded.cutoffsHz[static_cast<size_t>(band)]) : String();
+        const String range = band == 0 ? "<" + upperHz : (band == numBands - 1 ? ">" + lowerHz : lowerHz + "-" + upperHz);
+        this->audioMeters.setLabel(band + 1, name + " " + range);
+        this->soloButtons[static_cast<size_t>(band)].setButtonText("Solo " + name);
+    }
+}
+
+String TrinityAudioProcessorEditor::formatCrossoverHz(float frequencyHz)
+{
+    // 250, 2k, 2.5k
+    if (frequencyHz < 1000.0f)
+    {
+        return String(roundToInt(frequencyHz));
+    }
+    const float kiloHertz = std::round(frequencyHz / 100.0f) / 10.0f;
+    return (kiloHertz == std::floor(kiloHertz) ? String(roundToInt(kiloHertz)) : String(kiloHertz, 1)) + "k";
+}
+
+void TrinityAudioProcessorEditor::setTimerDriven(bool isTimerDriven)
+{
+    if (isTimerDriven == this->timerDriven)
+    {
+        return;
+    }
+    // Only the timer is capped; the pacer's top rung stays open to vblank
+    this->timerDriven = isTimerDriven;
+    this->framePacer.setMaxRateHz(isTimerDriven ? timerMaxRateHz : FramePacer::rateLadderHz.front());
+}
+
+void TrinityAudioProcessorEditor::updateTimerRate()
+{
+    // While vblank drives frames the timer only watches for it stopping
+    const int targetRateHz = jlimit(1, roundToInt(timerMaxRateHz), roundToInt(this->framePacer.getTargetRateHz()));
+    if (targetRateHz != this->timerRateHz)
+    {
+        this->timerRateHz = targetRateHz;
+        this->startTimerHz(targetRateHz);
+    }
 }
 
 void TrinityAudioProcessorEditor::resized()
 {
     auto bounds = this->getLocalBounds();
     auto topArea = bounds.removeFromTop((int) std::round(bounds.getHeight() * 0.40f));
+    auto spectrogramArea = topArea.removeFromBottom((int) std::round(topArea.getHeight() * 0.30f));
     this->spectrumAnalyzer.setBounds(topArea);
+    this->spectrogram.setBounds(spectrogramArea);
 
     const int controlsHeight = 132;
     auto controlsArea = bounds.removeFromTop(controlsHeight);
@@ -241,18 +409,26 @@ void TrinityAudioProcessorEditor::resized()
 
     const int pad = 8;
     const int h1 = row1.getHeight() - pad * 2;
-    const int wTest = 130;
-    const int wType = 200;
-    const int wCsv  = 110;
     const int gap1 = pad * 2; // larger gaps for the top row
-    const int totalTopWidth = wTest + wType + wCsv + gap1 * 2;
+    // Preferred widths, scaled down together when the row is narrower
+    const int preferredTopWidth = 130 + 200 + 120 + 110 + 120;
+    const int availableTopWidth = row1.getWidth() - pad * 2 - gap1 * 4;
+    const float topScale = jmin(1.0f, (float) availableTopWidth / (float) preferredTopWidth);
+    const int wTest = (int) std::floor(130 * topScale);
+    const int wType = (int) std::floor(200 * topScale);
+    const int wCapture = (int) std::floor(120 * topScale);
+    const int wSpike = (int) std::floor(110 * topScale);
+    const int wLoudness = (int) std::floor(120 * topScale);
+    const int totalTopWidth = wTest + wType + wCapture + wSpike + wLoudness + gap1 * 4;
     const int x1Start = row1.getX() + (row1.getWidth() - totalTopWidth) / 2;
     const int y1 = row1.getY() + (row1.getHeight() - h1) / 2; // vertically center within the row
 
     int x1 = x1Start;
     this->btnTestEnabled.setBounds(x1, y1, wTest, h1); x1 += wTest + gap1;
     this->cbxTestType.setBounds(x1, y1, wType, h1);    x1 += wType + gap1;
-    this->btnDebugCsv.setBounds(x1, y1, wCsv,  h1);
+    this->btnDebugCapture.setBounds(x1, y1, wCapture,  h1); x1 += wCapture + gap1;
+    this->btnSpikeCatcher.setBounds(x1, y1, wSpike, h1); x1 += wSpike + gap1;
+    this->btnResetLoudness.setBounds(x1, y1, wLoudness, h1);
 
     // Row 2: diagnostics toggles and sliders
     const int h2 = row2.getHeight() - pad * 2;
@@ -266,143 +442,53 @@ void TrinityAudioProcessorEditor::resized()
     this->sldTaperPercent.setBounds(x2, row2.getY() + pad, sliderW, h2); x2 += sliderW + pad;
     this->sldSpecSmoothing.setBounds(x2, row2.getY() + pad, sliderW, h2);
 
-    // Row 3: Solo buttons only (own dedicated row), centered horizontally
+    // Row 3: Solo buttons only (own dedicated row), centered horizontally;
+    // narrower when many bands would not fit
+    const int numSoloButtons = jmax(1, this->shownCrossovers.numBands);
     const int h3 = row3.getHeight() - pad * 2;
-    const int soloW = 120;
-    const int gaps = 2; // between three buttons
-    const int totalSoloWidth = soloW * 3 + pad * gaps;
+    const int soloW = jmin(120, (row3.getWidth() - pad * (numSoloButtons + 1)) / numSoloButtons);
+    const int totalSoloWidth = soloW * numSoloButtons + pad * (numSoloButtons - 1);
     const int x3Start = row3.getX() + (row3.getWidth() - totalSoloWidth) / 2;
     const int y3 = row3.getY() + (row3.getHeight() - h3) / 2; // vertical centering within row
 
     int x3 = x3Start;
-    this->btnSoloLow.setBounds(x3, y3, soloW, h3); x3 += soloW + pad;
-    this->btnSoloMid.setBounds(x3, y3, soloW, h3); x3 += soloW + pad;
-    this->btnSoloHigh.setBounds(x3, y3, soloW, h3);
+    for (int band = 0; band < numSoloButtons && band < CrossoverFrequencies::maxBands; ++band)
+    {
+        this->soloButtons[static_cast<size_t>(band)].setBounds(x3, y3, soloW, h3);
+        x3 += soloW + pad;
+    }
 
-    // Remaining area is for the meters component
+    // Deadline diagnostics along the bottom, meters in the remaining area
+    const int deadlinePanelHeight = 72;
+    this->deadlinePanel.setBounds(bounds.removeFromBottom(deadlinePanelHeight));
     this->audioMeters.setBounds (bounds);
 }
 
 void TrinityAudioProcessorEditor::paint(Graphics& graphics)
 {
     using namespace juce;
+    this->paintStartTicks = Time::getHighResolutionTicks();
     graphics.fillAll(Colours::black);
 }
 
-void TrinityAudioProcessorEditor::ensureDebugStreamOpen()
-{
-    if (this->debugStream && this->debugStream->openedOk())
-    {
-        return;
-    }
-
-    File docs = File::getSpecialLocation(File::userDocumentsDirectory);
-    this->debugFile = docs.getChildFile("Trinity_Debug.csv");
-    // createOutputStream returns std::unique_ptr<FileOutputStream>; assign/move it directly
-    this->debugStream = this->debugFile.createOutputStream();
-    if (this->debugStream && this->debugStream->openedOk())
-    {
-        this->debugHeaderWritten = false;
-    }
-}
-
-String TrinityAudioProcessorEditor::getInitHeader(std::vector<float> tailPreSmooth, std::vector<float> tailPostSmooth, std::vector<float> tailPostTaper, std::vector<float> bandsPreSmooth, std::vector<float> bandsFinal)
+void TrinityAudioProcessorEditor::paintOverChildren(Graphics& graphics)
 {
-    String header = "csvVersion=2\n";
-    header += "frame,hiGuard,allowedEndBin,allowedEndHz,sampleRate,fftSize,displayMaxHz";
-    for (size_t i = 0; i < tailPreSmooth.size(); ++i)
-    {
-        header += ",preSmoothTail" + String(static_cast<int>(i));
-    }
-    for (size_t i = 0; i < tailPostSmooth.size(); ++i)
-    {
-        header += ",postSmoothTail" + String(static_cast<int>(i));
-    }
-    for (size_t i = 0; i < tailPostTaper.size(); ++i)
-    {
-        header += ",postTaperTail" + String(static_cast<int>(i));
-    }
-    for (size_t i = 0; i < bandsPreSmooth.size(); ++i)
-    {
-        header += ",bandPre" + String(static_cast<int>(i));
-    }
-    for (size_t i = 0; i < bandsFinal.size(); ++i)
-    {
-        header += ",bandFinal" + String(static_cast<int>(i));
-    }
-    header += "\n";
-    return header;
+    ignoreUnused(graphics);
+    // paint() -> children -> paintOverChildren() spans the whole editor repaint
+    const int64 elapsedTicks = Time::getHighResolutionTicks() - this->paintStartTicks;
+    this->framePacer.reportPaintCost(Time::highResolutionTicksToSeconds(elapsedTicks));
 }
 
-bool TrinityAudioProcessorEditor::isValidDebugStream()
+File TrinityAudioProcessorEditor::getDebugCaptureFile()
 {
-    return this->debugStream && this->debugStream->openedOk();
+    // A new file per capture, so instances never truncate each other's
+    const File docs = File::getSpecialLocation(File::userDocumentsDirectory);
+    const String stem = "Trinity_Debug_" + Time::getCurrentTime().formatted("%Y%m%d_%H%M%S");
+    return docs.getNonexistentChildFile(stem, DebugCaptureFile::fileExtension, false);
 }
 
-void TrinityAudioProcessorEditor::writeDebugCsvSnapshot()
+File TrinityAudioProcessorEditor::getSpikeBundleDirectory()
 {
-    this->ensureDebugStreamOpen();
-    if (!this->isValidDebugStream())
-    {
-        return;
-    }
-
-    // New extended debug data
-    std::vector<float> tailPreSmooth;
-    std::vector<float> tailPostSmooth;
-    std::vector<float> tailPostTaper;
-    std::vector<float> bandsPreSmooth;
-    std::vector<float> bandsFinal;
-    int hiGuardBinsLocal = 0;
-    int allowedEndBinLocal = 0;
-    double allowedEndHzLocal = 0.0;
-    double sampleRateHzLocal = 0.0; 
-    int fftSizeLocal = 0;
-    double displayMaxHzLocal = 0.0;
-    this->processor.copyDebugData(tailPreSmooth, tailPostSmooth, tailPostTaper,
-                                  bandsPreSmooth, bandsFinal,
-                                  hiGuardBinsLocal, allowedEndBinLocal, allowedEndHzLocal,
-                                  sampleRateHzLocal, fftSizeLocal, displayMaxHzLocal);
-
-    if (!this->debugHeaderWritten)
-    {
-        String header = getInitHeader(tailPreSmooth,
-                                   tailPostSmooth,
-                                   tailPostTaper,
-                                   bandsPreSmooth,
-                                   bandsFinal);
-        // writeString is portable across JUCE versions
-        this->debugStream->writeString(header);
-        this->debugHeaderWritten = true;
-    }
-
-    static long long csvFrameIndex = 0;
-    String line;
-    line = line << ++csvFrameIndex << "," << hiGuardBinsLocal << "," <<
-        allowedEndBinLocal << "," << allowedEndHzLocal
-        << "," << sampleRateHzLocal << "," << fftSizeLocal << "," <<
-        displayMaxHzLocal;
-    for (float value : tailPreSmooth)
-    {
-        line << "," << value;
-    }
-    for (float value : tailPostSmooth)
-    {
-        line << "," << value;
-    }
-    for (float value : tailPostTaper)
-    {
-        line << "," << value;
-    }
-    for (float value : bandsPreSmooth)
-    {
-        line << "," << value;
-    }
-    for (float value : bandsFinal)
-    {
-        line << "," << value;
-    }
-    line << "\n";
-    this->debugStream->writeString(line);
-    this->debugStream->flush();
+    const File docs = File::getSpecialLocation(File::userDocumentsDirectory);
+    return docs.getChildFile("Trinity_Spikes");
 }
@@ -3,9 +3,20 @@
 #include <JuceHeader.h>
 #include <array>
 
+#include "models/BandFrequencies.h"
 #include "models/MeterInfo.h"
 #include "components/GraphicalSpectrumAnalyzer.h"
 #include "components/AudioSpectrumMeters.h"
+#include "components/SpectrogramView.h"
+#include "components/DeadlinePanel.h"
+#include "services/FramePacer.h"
+
+// VBlankAttachment is available from JUCE 7; older versions fall back to the timer.
+#if JUCE_MAJOR_VERSION >= 7
+#define TRINITY_HAS_VBLANK 1
+#else
+#define TRINITY_HAS_VBLANK 0
+#endif
 
 class TrinityAudioProcessor;
 
@@ -16,32 +27,71 @@ public:
     void initSpectrumAnalyzerControls();
     void initSpectrumAnalyzerButtons();
     explicit TrinityAudioProcessorEditor(TrinityAudioProcessor& processorRef);
-    void updateDisplayAndSmoothLevels();
+    void updateDisplayAndSmoothLevels(float elapsedMs);
     ~TrinityAudioProcessorEditor() override = default;
 
+    // Advance UI state by one frame of elapsedMs. Normally driven by the frame
+    // pacer; public so headless tools can step frames without a message loop.
+    void renderFrame(float elapsedMs);
+
     void paint(Graphics& graphics) override;
+    void paintOverChildren(Graphics& graphics) override;
     void resized() override;
 
 private:
     TrinityAudioProcessor& processor;
     void timerCallback() override;
-    float displayTotal { 0.0f };
-    float displayLow { 0.0f };
-    float displayMid { 0.0f };
-    float displayHigh { 0.0f };
-    std::array<MeterInfo, 4> meters;
+
+    // ===== Frame pacing =====
+    // Frames are driven by the display's vblank where available, with the
+    // timer as a fallback; the pacer decides which ticks actually render.
+    void onFrameTick(double nowSeconds);
+    void setTimerDriven(bool isTimerDriven);
+    void updateTimerRate();
+    static double nowSeconds() noexcept;
+
+    // The message-thread timer cannot usefully exceed 60 Hz; vblank can
+    static constexpr double timerMaxRateHz = 60.0;
+
+    FramePacer framePacer;
+    bool timerDriven { false };
+    int timerRateHz { 0 };
+    int64 paintStartTicks { 0 };
+#if TRINITY_HAS_VBLANK
+    std::unique_ptr<VBlankAttachment> vBlankAttachment;
+    double lastVBlankSeconds { -1.0 };
+#endif
+
+    // Smoothed meter levels: total, then one per crossover band
+    std::array<float, AudioSpectrumMeters::maxMeters> displayLevels {};
+    // Largest sample since the previous frame, held over frames without audio
+    std::array<float, AudioSpectrumMeters::maxMeters> peakTargets {};
+    // RMS integrated from the exact mean squares taken each frame
+    std::array<float, AudioSpectrumMeters::maxMeters> displayMeanSquares {};
+    std::array<float, AudioSpectrumMeters::maxMeters> displayRms {};
+    // Loudness as the processor last published it, one per meter
+    std::array<LoudnessReading, AudioSpectrumMeters::maxMeters> displayLoudness {};
+    std::array<MeterInfo, AudioSpectrumMeters::maxMeters> meters;
+    // Band tints, meters, labels and solo buttons follow the processor's live
+    // crossover; band count 0 forces the first update
+    CrossoverFrequencies shownCrossovers { 0, {} };
+    void updateCrossoverDisplay();
+    static String formatCrossoverHz(float frequencyHz);
     GraphicalSpectrumAnalyzer spectrumAnalyzer;
+    SpectrogramView spectrogram;
     AudioSpectrumMeters audioMeters;
+    DeadlinePanel deadlinePanel;  // processBlock load and overruns
 
-    // Controls for built-in test signal and debug CSV
+    // Controls for built-in test signal and debug capture
     ToggleButton btnTestEnabled { "Test Signal" };
     ComboBox    cbxTestType;
-    ToggleButton btnDebugCsv { "Debug CSV" };
+    ToggleButton btnDebugCapture { "Debug Capture" };
+    ToggleButton btnSpikeCatcher { "Spike Catch" };
+    TextButton btnResetLoudness { "Reset Loudness" };
 
-    // Solo buttons for bands
-    ToggleButton btnSoloLow  { "Solo Low" };
-    ToggleButton btnSoloMid  { "Solo Mid" };
-    ToggleButton btnSoloHigh { "Solo High" };
+    // Solo buttons, one per crossover band (mutually exclusive)
+    std::array<ToggleButton, CrossoverFrequencies::maxBands> soloButtons;
+    void selectSoloBand(int band, bool shouldSolo);
 
     // A/B diagnostics controls (Standalone convenience)
     ToggleButton btnUiSmooth { "UI Smooth" };
@@ -52,19 +102,10 @@ private:
     Slider sldTaperPercent;       // 0..0.2
     Slider sldSpecSmoothing;      // 0..1
 
-    // Debug CSV state
-    int debugFrameCounter { 0 };
-    bool debugHeaderWritten { false };
-    std::unique_ptr<FileOutputStream> debugStream;
-    File debugFile;
-
-    void writeDebugCsvSnapshot();
-    void ensureDebugStreamOpen();
-    static String getInitHeader(std::vector<float> tailPreSmooth,
-                             std::vector<float> tailPostSmooth,
-                             std::vector<float> tailPostTaper,
-                             std::vector<float> bandsPreSmooth,
-                             std::vector<float> bandsFinal);
-    bool isValidDebugStream();
+    // New capture file in the user's documents, unique per capture; convert
+    // with trinity_capture_to_csv
+    static File getDebugCaptureFile();
+    // Spike bundles in the user's documents; replay with trinity_render --replay
+    static File getSpikeBundleDirectory();
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TrinityAudioProcessorEditor)
 };
@@ -1,11 +1,13 @@
 #include "TrinityProcessor.h"
 #include "TrinityEditor.h"
 #include "models/BandFrequencies.h"
+#include "services/RealtimeSanitizer.h"
+#include "services/SharedSpectrumResources.h"
+#include "services/TraceRecorder.h"
 #include "services/SpectrumProcessing.h"
+#include <algorithm>
 #include <cmath>
-#include <spdlog/sinks/stdout_color_sinks-inl.h>
-
-
+#include <utility>
 
 TrinityAudioProcessor::TrinityAudioProcessor()
     : AudioProcessor(
@@ -13,76 +15,187 @@ TrinityAudioProcessor::TrinityAudioProcessor()
             .withInput("Input",  AudioChannelSet::stereo(), true)
             .withOutput("Output", AudioChannelSet::stereo(), true))
 {
-    this->console->set_level(spdlog::level::debug);
-    this->console->info("Trinity Audio Processor started");
+    this->console.info("Trinity Audio Processor started");
+    const CrossoverFrequencies defaults;
+    this->bandCount = new AudioParameterInt(ParameterID { "bands", 1 }, "Bands", CrossoverFrequencies::minBands,
+                                            CrossoverFrequencies::maxBands, defaults.numBands);
+    this->addParameter(this->bandCount);
+    // One range for every cutoff, log-skewed so its middle is the geometric
+    // centre; ordering is enforced by CrossoverFrequencies::constrainedTo
+    NormalisableRange<float> cutoffRange(CrossoverFrequencies::minHz, CrossoverFrequencies::maxHz);
+    cutoffRange.setSkewForCentre(std::sqrt(CrossoverFrequencies::minHz * CrossoverFrequencies::maxHz));
+    for (int cutoff = 0; cutoff < CrossoverFrequencies::maxCutoffs; ++cutoff)
+    {
+        const String number(cutoff + 1);
+        auto* parameter = new AudioParameterFloat(ParameterID { "crossover" + number + "Hz", 1 }, "Crossover " + number,
+                                                  cutoffRange, defaults.cutoffsHz[static_cast<size_t>(cutoff)],
+                                                  AudioParameterFloatAttributes().withLabel("Hz"));
+        this->cutoffParameters[static_cast<size_t>(cutoff)] = parameter;
+        this->addParameter(parameter);
+    }
+    this->publishLiveCrossover();
+
+    this->deadlineMonitor.setOverrunLog(&this->console);
+    // Band count is fixed, so the UI hand-off is sized once and never reallocated
+    // while an editor may be reading from it.
+    this->spectrumFrames.allocate(this->numBands);
 }
 
-void TrinityAudioProcessor::initDspProcessSpec(double sampleRate, int samplesPerBlock, dsp::ProcessSpec& spec)
+CrossoverFrequencies TrinityAudioProcessor::getCrossoverTargets(double sampleRate) const noexcept
 {
-    spec.sampleRate = sampleRate;
-    spec.maximumBlockSize = static_cast<uint32> (samplesPerBlock);
-    spec.numChannels = 1;
+    CrossoverFrequencies targets;
+    targets.numBands = this->bandCount->get();
+    for (size_t cutoff = 0; cutoff < targets.cutoffsHz.size(); ++cutoff)
+    {
+        targets.cutoffsHz[cutoff] = this->cutoffParameters[cutoff]->get();
+    }
+    return targets.constrainedTo(sampleRate);
 }
 
-void TrinityAudioProcessor::initCrossoverFilters(dsp::ProcessSpec spec)
+void TrinityAudioProcessor::snapCrossover(const CrossoverFrequencies& cutoffs) noexcept
 {
-    initCrossoverFilter(spec, this->lowMidCrossover, BandFrequencies::LowBandEndHz);
-    initCrossoverFilter(spec, this->midHighCrossover, BandFrequencies::MidBandEndHz);
+    for (size_t cutoff = 0; cutoff < this->cutoffGlides.size(); ++cutoff)
+    {
+        this->cutoffGlides[cutoff].setCurrentAndTargetValue(cutoffs.cutoffsHz[cutoff]);
+    }
+    this->glidingCutoffs = cutoffs;
+    this->crossover.setCutoffs(cutoffs);
+    // Band loudness follows the bands; a new count measures from scratch
+    this->loudness.setNumSignals(1 + this->crossover.getNumBands());
 }
 
-void TrinityAudioProcessor::initCrossoverFilter(dsp::ProcessSpec spec, auto& crossover, BandFrequencies bandCutoff)
+bool TrinityAudioProcessor::isCrossoverGliding() const noexcept
 {
+    for (int cutoff = 0; cutoff < this->glidingCutoffs.getNumCutoffs(); ++cutoff)
+    {
+        if (this->cutoffGlides[static_cast<size_t>(cutoff)].isSmoothing())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void TrinityAudioProcessor::publishLiveCrossover() noexcept
+{
+    for (size_t cutoff = 0; cutoff < this->liveCutoffsHz.size(); ++cutoff)
+    {
+        this->liveCutoffsHz[cutoff].store(this->glidingCutoffs.cutoffsHz[cutoff]);
+    }
+    this->liveNumBands.store(this->glidingCutoffs.numBands);
+}
 
-    for (dsp::LinkwitzRileyFilter<float>& filter : crossover)
+CrossoverFrequencies TrinityAudioProcessor::getCrossoverFrequencies() const noexcept
+{
+    CrossoverFrequencies live;
+    live.numBands = this->liveNumBands.load();
+    for (size_t cutoff = 0; cutoff < live.cutoffsHz.size(); ++cutoff)
     {
-        filter.reset();
-        filter.setType(dsp::LinkwitzRileyFilterType::lowpass);
-        float bandCutoffHz = static_cast<float>(bandCutoff);
-        filter.setCutoffFrequency(bandCutoffHz);
-        filter.prepare(spec);
+        live.cutoffsHz[cutoff] = this->liveCutoffsHz[cutoff].load();
+    }
+    return live;
+}
+
+void TrinityAudioProcessor::setCrossoverFrequencies(CrossoverFrequencies frequencies)
+{
+    const auto setParameter = [](RangedAudioParameter& parameter, float value)
+    {
+        parameter.beginChangeGesture();
+        parameter.setValueNotifyingHost(parameter.convertTo0to1(value));
+        parameter.endChangeGesture();
+    };
+    setParameter(*this->bandCount, static_cast<float>(frequencies.numBands));
+    for (size_t cutoff = 0; cutoff < frequencies.cutoffsHz.size(); ++cutoff)
+    {
+        setParameter(*this->cutoffParameters[cutoff], frequencies.cutoffsHz[cutoff]);
     }
 }
 
 void TrinityAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
-    ignoreUnused(samplesPerBlock);
-    dsp::ProcessSpec spec;
-    initDspProcessSpec(sampleRate, samplesPerBlock, spec);
-    this->initCrossoverFilters(spec);
+    // Rebuild only what the new configuration invalidates. Buffers kept by
+    // releaseResources are refilled in place: the arena keeps its block for
+    // the same plan and setSize(..., avoidReallocating) does not allocate.
+    const double newSampleRate = sampleRate > 0.0 ? sampleRate : 44100.0;
+    const int numDoubleChannels = jmax(1, getTotalNumInputChannels(), getTotalNumOutputChannels());
+    const bool rateChanged = !this->resourcesAllocated || newSampleRate != this->currentSampleRate;
+    const bool blockSizeChanged = !this->resourcesAllocated || samplesPerBlock != this->preparedBlockSize;
+    const bool channelsChanged = !this->resourcesAllocated || numDoubleChannels != this->preparedChannels;
+
+    // The crossover starts at its targets; only later parameter changes glide
+    if (rateChanged || channelsChanged)
+    {
+        this->crossover.prepare(newSampleRate, jmax(2, numDoubleChannels));
+        this->loudness.prepare(newSampleRate, this->crossover.getNumChannels());
+        this->loudnessFrameStride = LoudnessMeter::maxSignals * this->crossover.getNumChannels();
+        this->loudnessFrames.assign(static_cast<size_t>(crossoverSubBlock * this->loudnessFrameStride), 0.0f);
+    }
+    this->crossover.reset();
+    this->loudness.reset();
+    this->loudnessResetRequested.store(false);
+    for (auto& glide : this->cutoffGlides)
+    {
+        glide.reset(newSampleRate / crossoverSubBlock, crossoverGlideSeconds);
+    }
+    this->snapCrossover(this->getCrossoverTargets(newSampleRate));
+    this->publishLiveCrossover();
 
-    // Initialise FFT resources
-    this->fft = std::make_unique<dsp::FFT> (fftOrder);
+    // Initialise FFT resources: the plan is per instance, the window is shared
+    if (this->fft == nullptr)
+    {
+        this->fft = std::make_unique<dsp::FFT>(fftOrder);
+    }
     // Use non-normalised Hann and handle coherent gain explicitly in our scaling (4/N one-sided)
-    this->window = std::make_unique<dsp::WindowingFunction<float>> (fftSize, dsp::WindowingFunction<float>::hann, false);
-
-    this->fifo.assign(fftSize, 0.0f);
-    this->fftTime.assign(fftSize, 0.0f);
-    this->fftData.assign(2 * fftSize, 0.0f);
-    // spectrum holds log-averaged bands for UI; will be sized in buildLogBands
-    this->spectrum.clear();
-    this->spectrumPowerSmoothed.assign(fftSize / 2, 0.0f);
+    if (this->window == nullptr)
+    {
+        this->window = SharedSpectrumResources::getWindow(fftSize, dsp::WindowingFunction<float>::hann, false);
+    }
+
+    this->allocateAnalysisArena();
     this->fifoIndex = 0;
 
     // Set current SR and (re)build band mapping for log display
-    this->currentSampleRate = sampleRate > 0.0 ? sampleRate : 44100.0;
-    // Compute guarded bins near Nyquist based on guardPercent (proportional with minimum)
+    if (this->preparedSampleRate > 0.0 && sampleRate != this->preparedSampleRate)
     {
-        const int numBins = fftSize / 2;
-        const float guardPercentClamped = jlimit(0.0f, 0.2f, this->guardPercent.load());
-        this->hiGuardBins = jmax(8, static_cast<int>(std::floor(static_cast<double>(numBins) * static_cast<double>(guardPercentClamped))));
+        this->console.post(RealtimeLogEvent::sampleRateChange(this->preparedSampleRate, sampleRate));
     }
-    this->buildLogBands();
-
-    this->testSignalGenerator.prepare(this->currentSampleRate, this->displayMaxHz);
+    this->preparedSampleRate = sampleRate;
+    this->currentSampleRate = newSampleRate;
+    // The audio thread is stopped, so layouts kept alive for it can go
+    this->retiredBandLayouts.clear();
+    this->selectBandLayout(this->guardPercent.load());
+    this->pipelineCapture.prepare(fftSize / 2, this->numBands);
+
+    this->testSignalGenerator.prepare(this->currentSampleRate, this->bandLayout->displayMaxHz);
+    this->deadlineMonitor.prepare(this->currentSampleRate, samplesPerBlock);
+    // Blocks up to the announced size are expected; larger ones get logged
+    this->preparedBlockSize = samplesPerBlock;
+    this->preparedChannels = numDoubleChannels;
+    this->largestBlockSeen = samplesPerBlock;
 
     // Pre-size reusable temporary buffers to avoid allocations in audio thread
     {
-        const int numBins = fftSize / 2;
-        this->tempPowerForAggregation.assign (numBins, 0.0f);
-        this->tempBands.assign (static_cast<size_t>(this->numBands), 0.0f);
-        this->tempBandsPreSmooth.assign (static_cast<size_t>(this->numBands), 0.0f);
-        this->tempBandsSmooth.assign (static_cast<size_t>(this->numBands), 0.0f);
-        this->tempDoubleBuffer.setSize (0, 0); // ensure no lingering allocation
+        // processBlock(double) converts through this in chunks of at most samplesPerBlock
+        this->tempDoubleBuffer.setSize (numDoubleChannels, jmax(1, samplesPerBlock), false, true, true);
+        // Resizing the spike ring restarts its writer thread; an unchanged
+        // configuration only needs a fresh history
+        if (rateChanged || blockSizeChanged || channelsChanged)
+        {
+            this->spikeCatcher.prepare(this->currentSampleRate, numDoubleChannels, samplesPerBlock);
+        }
+        else
+        {
+            this->spikeCatcher.restartHistory();
+        }
+    }
+    this->resourcesAllocated = true;
+    // Hosts re-prepare often; an unchanged footprint is not worth a line each time
+    const size_t footprintBytes = this->getMemoryFootprint().getInstanceBytes();
+    if (footprintBytes != this->loggedFootprintBytes)
+    {
+        this->loggedFootprintBytes = footprintBytes;
+        this->console.debug("Memory footprint: {} KiB per instance, analysis arena {} KiB",
+                            footprintBytes / 1024, this->analysisArena.getBytesReserved() / 1024);
     }
 
     // Reset DC remover (leaky mean)
@@ -118,7 +231,12 @@ bool TrinityAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) c
 void TrinityAudioProcessor::processBlock(AudioBuffer<float>& buffer,
                                          MidiBuffer& midi)
 {
+    TRINITY_REALTIME_SCOPE;
+    const DeadlineMonitor::ScopedMeasurement deadline(this->deadlineMonitor, buffer.getNumSamples());
+    const SpikeCatcher::ScopedBlock spikeBlock(this->spikeCatcher, buffer,
+                                               [this] { return this->getParameterSnapshot(); });
     ScopedNoDenormals noDenormals;
+    TRINITY_TRACE_SCOPE(ProcessBlock);
     ignoreUnused(midi);
 
     for (int channel = getTotalNumInputChannels(); channel < getTotalNumOutputChannels(); ++channel)
@@ -129,87 +247,131 @@ void TrinityAudioProcessor::processBlock(AudioBuffer<float>& buffer,
     const int numChannels = buffer.getNumChannels();
     const int numSamples = buffer.getNumSamples();
 
+    // Host behaviour worth a log line; posting is wait-free
+    if (numChannels != this->lastBlockChannels)
+    {
+        if (this->lastBlockChannels > 0)
+        {
+            this->console.post(RealtimeLogEvent::channelLayoutChange(this->lastBlockChannels, numChannels));
+        }
+        this->lastBlockChannels = numChannels;
+    }
+    if (numSamples > this->largestBlockSeen)
+    {
+        this->largestBlockSeen = numSamples;
+        this->console.post(RealtimeLogEvent::oversizedBlock(numSamples, this->preparedBlockSize));
+    }
+
     // Optional: generate built-in test signal (Standalone convenience)
     if (this->testSignalGenerator.isEnabled())
     {
+        TRINITY_TRACE_SCOPE(TestSignal);
         this->generateTestSignal (buffer);
     }
 
     float totalPeak = 0.0f;
+    float totalSumOfSquares = 0.0f;
 
-    for (int channel = 0; channel < numChannels; ++channel)
     {
-        const float* readPtr = buffer.getReadPointer(channel);
-        for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex)
+        TRINITY_TRACE_SCOPE(PeakScan);
+        for (int channel = 0; channel < numChannels; ++channel)
         {
-            const float absValue = std::abs(readPtr[sampleIndex]);
-            if (absValue > totalPeak)
+            const float* readPtr = buffer.getReadPointer(channel);
+            for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex)
             {
-                totalPeak = absValue;
+                const float absValue = std::abs(readPtr[sampleIndex]);
+                if (absValue > totalPeak)
+                {
+                    totalPeak = absValue;
+                }
+                totalSumOfSquares += absValue * absValue;
             }
         }
     }
 
-    float lowPeak = 0.0f;
-    float midPeak = 0.0f;
-    float highPeak = 0.0f;
+    std::array<float, CrossoverFrequencies::maxBands> bandPeaks {};
+    std::array<float, CrossoverFrequencies::maxBands> bandSumsOfSquares {};
+    const int soloBand = getSoloBand(this->soloMode.load());
+    // Channels beyond the prepared layout have no filter state and pass through
+    const int numCrossoverChannels = jmin(numChannels, this->crossover.getNumChannels());
 
-    const auto currentSolo = this->soloMode.load();
+    const CrossoverFrequencies cutoffTargets = this->getCrossoverTargets(this->currentSampleRate);
+    if (cutoffTargets.numBands != this->glidingCutoffs.numBands)
+    {
+        // A different band count is a different tree; nothing to glide from
+        this->snapCrossover(cutoffTargets);
+    }
+    for (int cutoff = 0; cutoff < cutoffTargets.getNumCutoffs(); ++cutoff)
+    {
+        this->cutoffGlides[static_cast<size_t>(cutoff)].setTargetValue(cutoffTargets.cutoffsHz[static_cast<size_t>(cutoff)]);
+    }
 
-    for (int channel = 0; channel < numChannels; ++channel)
+    if (this->loudnessResetRequested.exchange(false))
     {
-        float* writePtr = buffer.getWritePointer(channel);
+        this->loudness.reset();
+    }
 
-        for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex)
+    {
+        TRINITY_TRACE_SCOPE(Crossover);
+        float* const* channelData = buffer.getArrayOfWritePointers();
+        // Loudness frames: the input channels first, then the crossover
+        // writes every band's channels behind them
+        CrossoverTree::BandTaps taps;
+        taps.peaks = bandPeaks.data();
+        taps.sumsOfSquares = bandSumsOfSquares.data();
+        taps.frameStride = this->loudnessFrameStride;
+        const int loudnessChannels = this->loudness.getNumChannels();
+        for (int subBlockStart = 0; subBlockStart < numSamples; subBlockStart += crossoverSubBlock)
         {
-            const float inSample = writePtr[sampleIndex];
-
-            float lowSample = 0.0f;
-            float residual = 0.0f;
-            float midSample = 0.0f;
-            float highSample = 0.0f;
-
-            this->lowMidCrossover[channel].processSample(0, inSample, lowSample, residual);
-            this->midHighCrossover[channel].processSample(0, residual, midSample, highSample);
-
-            const float lowSamplePeak = std::abs(lowSample);
-            const float midSamplePeak = std::abs(midSample);
-            const float highSamplePeak = std::abs(highSample);
-
-            if (lowSamplePeak > lowPeak) lowPeak = lowSamplePeak;
-            if (midSamplePeak > midPeak) midPeak = midSamplePeak;
-            if (highSamplePeak > highPeak) highPeak = highSamplePeak;
-
-            float outSample = 0.0f;
-            switch (currentSolo)
+            const int subBlockSamples = jmin(crossoverSubBlock, numSamples - subBlockStart);
+            if (this->isCrossoverGliding())
+            {
+                for (int cutoff = 0; cutoff < this->glidingCutoffs.getNumCutoffs(); ++cutoff)
+                {
+                    this->glidingCutoffs.cutoffsHz[static_cast<size_t>(cutoff)] = this->cutoffGlides[static_cast<size_t>(cutoff)].getNextValue();
+                }
+                this->crossover.setCutoffs(this->glidingCutoffs);
+            }
+            if (numCrossoverChannels <= 0)
             {
-                case SoloMode::Low:
-                    outSample = lowSample;
-                    break;
-                case SoloMode::Mid:
-                    outSample = midSample;
-                    break;
-                case SoloMode::High:
-                    outSample = highSample;
-                    break;
-                case SoloMode::None:
-                default:
-                    outSample = lowSample + midSample + highSample;
-                    break;
+                continue;  // not prepared
             }
-
-            writePtr[sampleIndex] = outSample;
+            float* frames = this->loudnessFrames.data();
+            for (int sampleIndex = 0; sampleIndex < subBlockSamples; ++sampleIndex)
+            {
+                float* frame = frames + sampleIndex * this->loudnessFrameStride;
+                for (int channel = 0; channel < loudnessChannels; ++channel)
+                {
+                    frame[channel] = channel < numCrossoverChannels ? channelData[channel][subBlockStart + sampleIndex] : 0.0f;
+                }
+            }
+            taps.frames = frames + loudnessChannels;
+            this->crossover.process(channelData, channelData, numCrossoverChannels, subBlockStart, subBlockSamples, soloBand,
+                                    taps);
+            this->loudness.process(frames, this->loudnessFrameStride, subBlockSamples);
         }
     }
+    this->publishLiveCrossover();
 
-    this->totalLevel.store(jlimit(0.0f, 1.0f, totalPeak));
-    this->lowLevel.store(jlimit(0.0f, 1.0f, lowPeak));
-    this->midLevel.store(jlimit(0.0f, 1.0f, midPeak));
-    this->highLevel.store(jlimit(0.0f, 1.0f, highPeak));
+    // Accumulate rather than overwrite: the editor takes whatever arrived
+    // since its last frame, so no block's peak goes unseen
+    this->totalMeter.accumulate(totalPeak, totalSumOfSquares, numSamples * numChannels);
+    const int numMeteredBands = this->crossover.getNumBands();
+    for (int band = 0; band < numMeteredBands; ++band)
+    {
+        const auto bandIndex = static_cast<size_t>(band);
+        this->bandMeters[bandIndex].accumulate(bandPeaks[bandIndex], bandSumsOfSquares[bandIndex],
+                                               numSamples * numCrossoverChannels);
+    }
 
     // ===== Accumulate mono samples for FFT =====
-    if (this->fft && this->window)
+    // The sequence is odd while this block may hold a layout (see selectBandLayout)
+    this->layoutReaderSequence.fetch_add(1);
+    const SpectrumBandLayout* layout = this->activeBandLayout.load();
+    if (this->fft && this->window && layout != nullptr)
     {
+        // Frame analysis below nests inside this event
+        TRINITY_TRACE_SCOPE(MonoAccumulate);
         for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex)
         {
             // simple mono mixdown: average of channels
@@ -223,17 +385,21 @@ void TrinityAudioProcessor::processBlock(AudioBuffer<float>& buffer,
 
             if (this->fifoIndex >= fftSize)
             {
-                // Prepare time-domain buffer
-                FloatVectorOperations::copy(this->fftTime.data(), this->fifo.data(), fftSize);
-                this->window->multiplyWithWindowingTable(this->fftTime.data(), fftSize);
-
-                // Copy to complex buffer (real, imag)
-                FloatVectorOperations::clear(this->fftData.data(), (int) this->fftData.size());
-                for (int timeSampleIndex = 0; timeSampleIndex < fftSize; ++timeSampleIndex)
-                    this->fftData[(size_t) (2 * timeSampleIndex)] = this->fftTime[(size_t) timeSampleIndex];
-
-                // Perform forward FFT in-place; ignore negative frequencies to avoid mirror artefacts
-                this->fft->performRealOnlyForwardTransform(this->fftData.data(), true);
+                // Window and transform
+                {
+                    TRINITY_TRACE_SCOPE(WindowFft);
+                    // Prepare time-domain buffer
+                    FloatVectorOperations::copy(this->fftTime.data(), this->fifo.data(), fftSize);
+                    this->window->multiplyWithWindowingTable(this->fftTime.data(), fftSize);
+
+                    // Copy to complex buffer (real, imag)
+                    FloatVectorOperations::clear(this->fftData.data(), (int) this->fftData.size());
+                    for (int timeSampleIndex = 0; timeSampleIndex < fftSize; ++timeSampleIndex)
+                        this->fftData[(size_t) (2 * timeSampleIndex)] = this->fftTime[(size_t) timeSampleIndex];
+
+                    // Perform forward FFT in-place; ignore negative frequencies to avoid mirror artefacts
+                    this->fft->performRealOnlyForwardTransform(this->fftData.data(), true);
+                }
 
                 // Compute magnitudes for first half (bins 0..N/2-1)
                 const int numBins = fftSize / 2;
@@ -242,120 +408,143 @@ void TrinityAudioProcessor::processBlock(AudioBuffer<float>& buffer,
                 constexpr float maxDb = 0.0f;
 
                 // Per-bin linear power smoothing (reduces bias and HF jitter)
-                for (int bin = 0; bin < numBins; ++bin)
                 {
-                    const float real = this->fftData[static_cast<size_t>(2 * bin)];
-                    const float imag = this->fftData[static_cast<size_t>(2 * bin + 1)];
-                    // One-sided scaling with Hann coherent gain compensation:
-                    // bins 1..N/2-1 use 4/N; DC and Nyquist would use 2/N, but we skip them.
-                    const float perBinScale = 4.0f / static_cast<float>(fftSize);
-                    const float mag = std::sqrt(real * real + imag * imag) * perBinScale;
-                    const float power = mag * mag; // linear power
-
-                    const float prev = this->spectrumPowerSmoothed[(size_t) bin];
-                    const float smoothingCoeff = this->specSmoothing;
-                    this->spectrumPowerSmoothed[(size_t) bin] = prev * (1.0f - smoothingCoeff) + power * smoothingCoeff;
+                    TRINITY_TRACE_SCOPE(PowerSmoothing);
+                    float* rawPowerCapture = this->pipelineCapture.beginStage(PipelineStage::RawPower, numBins);
+                    for (int bin = 0; bin < numBins; ++bin)
+                    {
+                        const float real = this->fftData[static_cast<size_t>(2 * bin)];
+                        const float imag = this->fftData[static_cast<size_t>(2 * bin + 1)];
+                        // One-sided scaling with Hann coherent gain compensation:
+                        // bins 1..N/2-1 use 4/N; DC and Nyquist would use 2/N, but we skip them.
+                        const float perBinScale = 4.0f / static_cast<float>(fftSize);
+                        const float mag = std::sqrt(real * real + imag * imag) * perBinScale;
+                        const float power = mag * mag; // linear power
+                        if (rawPowerCapture != nullptr)
+                        {
+                            rawPowerCapture[bin] = power;
+                        }
+
+                        const float prev = this->spectrumPowerSmoothed[(size_t) bin];
+                        const float smoothingCoeff = this->specSmoothing;
+                        this->spectrumPowerSmoothed[(size_t) bin] = prev * (1.0f - smoothingCoeff) + power * smoothingCoeff;
+                    }
+                    if (rawPowerCapture != nullptr)
+                    {
+                        this->pipelineCapture.publish(PipelineStage::RawPower);
+                    }
+                    this->pipelineCapture.capture(PipelineStage::PerBinSmoothed, this->spectrumPowerSmoothed.data(), numBins);
                 }
 
-                // Capture tail before any freq smoothing/taper for CSV (optional)
-                const int captureCount = 64;
-                const int allowedEndRaw = numBins - 1; // before guard/taper
-                const int startRaw = jlimit (0, allowedEndRaw, allowedEndRaw - (captureCount - 1));
-                if (this->debugBin.debugCaptureEnabled.load())
+                // Debug record for this frame, filled in place as the stages run (null when not capturing)
+                DebugFrameRecord* debugRecord = this->debugRecorder.beginRecord();
+                ++this->analysisFrameIndex;
+
+                // Capture tail before any freq smoothing/taper
+                if (debugRecord != nullptr)
                 {
-                    const SpinLock::ScopedLockType sl (this->spectrumLock);
-                    this->debugBin.debugTailBinsPreSmooth.resize ((size_t) (allowedEndRaw - startRaw + 1));
-                    int destIndex = 0;
-                    for (int bin = startRaw; bin <= allowedEndRaw; ++bin)
-                    {
-                        this->debugBin.debugTailBinsPreSmooth[static_cast<size_t>(destIndex++)] = this->spectrumPowerSmoothed[static_cast<size_t>(bin)];
-                    }
+                    debugRecord->numTailPreSmooth = DebugFrameRecord::copyTail(debugRecord->tailPreSmooth,
+                                                                               this->spectrumPowerSmoothed.data(),
+                                                                               numBins - 1);
                 }
 
                 // Determine the last usable bin index based on BOTH Nyquist guard and 20 kHz cap
-                const int allowedEnd = SpectrumProcessing::computeAllowedEndBin(this->currentSampleRate, fftSize, this->hiGuardBins);
+                const int allowedEnd = SpectrumProcessing::computeAllowedEndBin(this->currentSampleRate, fftSize, layout->hiGuardBins);
+                auto& powerForAggregation = this->tempPowerForAggregation;
 
                 // Zero out any bins strictly above the allowed end (covers both guarded and >20 kHz regions)
-                SpectrumProcessing::zeroStrictlyAbove(this->spectrumPowerSmoothed, allowedEnd);
-
-                // Frequency-domain smoothing to reduce isolated spikes (esp. near HF)
-                auto& powerForAggregation = this->tempPowerForAggregation;
-                if (static_cast<int>(powerForAggregation.size()) != numBins)
                 {
-                    powerForAggregation.assign(numBins, 0.0f);
+                    TRINITY_TRACE_SCOPE(FreqSmoothing);
+                    SpectrumProcessing::zeroStrictlyAbove(this->spectrumPowerSmoothed, allowedEnd);
+
+                    // Frequency-domain smoothing to reduce isolated spikes (esp. near HF)
+                    SpectrumProcessing::frequencySmoothTriangularIfEnabled(this->spectrumPowerSmoothed,
+                                                                           powerForAggregation,
+                                                                           allowedEnd,
+                                                                           this->freqSmoothEnabled.load());
+                    this->pipelineCapture.capture(PipelineStage::FreqSmoothed, powerForAggregation.data(), numBins);
                 }
-                SpectrumProcessing::frequencySmoothTriangularIfEnabled(this->spectrumPowerSmoothed,
-                                                                       powerForAggregation,
-                                                                       allowedEnd,
-                                                                       this->freqSmoothEnabled.load());
 
                 // Capture tail after freq smoothing (pre-taper)
-                if (this->debugBin.debugCaptureEnabled.load())
+                const int allowedEndBin = jlimit(0, numBins - 1, allowedEnd);
+                if (debugRecord != nullptr)
                 {
-                    const SpinLock::ScopedLockType sl (this->spectrumLock);
-                    const int endBin = jlimit(0, numBins - 1, allowedEnd);
-                    const int startBin = jlimit(0, endBin, endBin - (captureCount - 1));
-                    this->debugBin.debugTailBinsPostSmooth.resize(static_cast<size_t>(endBin - startBin + 1));
-                    int destIndex = 0;
-                    for (int bin = startBin; bin <= endBin; ++bin)
-                    {
-                        this->debugBin.debugTailBinsPostSmooth[static_cast<size_t>(destIndex++)] = powerForAggregation[static_cast<size_t>(bin)];
-                    }
+                    debugRecord->numTailPostSmooth = DebugFrameRecord::copyTail(debugRecord->tailPostSmooth,
+                                                                                powerForAggregation.data(),
+                                                                                allowedEndBin);
                 }
 
                 // Apply gentle cosine taper and zero above allowed end in aggregation buffer
-                SpectrumProcessing::applyCosineTaper(powerForAggregation, allowedEnd, this->taperPercent.load());
-                SpectrumProcessing::zeroStrictlyAbove(powerForAggregation, allowedEnd);
-
-                // Capture tail after taper
-                int allowedEndBin = jlimit(0, numBins - 1, allowedEnd);
-                if (this->debugBin.debugCaptureEnabled.load())
                 {
-                    const SpinLock::ScopedLockType spinLock (this->spectrumLock);
-                    const int endBin = allowedEndBin;
-                    const int startBin = jlimit(0, endBin, endBin - (captureCount - 1));
-                    this->debugBin.debugTailBinsPostTaper.resize (static_cast<size_t>(endBin - startBin + 1));
-                    int destIndex = 0;
-                    for (int bin = startBin; bin <= endBin; ++bin)
-                    {
-                        this->debugBin.debugTailBinsPostTaper[static_cast<size_t>(destIndex++)] = powerForAggregation[static_cast<size_t>(bin)];
-                    }
+                    TRINITY_TRACE_SCOPE(Taper);
+                    SpectrumProcessing::applyCosineTaper(powerForAggregation, allowedEnd, this->taperPercent.load());
+                    SpectrumProcessing::zeroStrictlyAbove(powerForAggregation, allowedEnd);
+                    this->pipelineCapture.capture(PipelineStage::Tapered, powerForAggregation.data(), numBins);
                 }
 
-                // Aggregate linear bins into perceptual log-spaced bands for UI accuracy, esp. low-end
-                if (static_cast<int>(this->bandBinStart.size()) != this->numBands || static_cast<int>(this->bandBinEnd.size()) != this->numBands)
+                // Capture tail after taper
+                if (debugRecord != nullptr)
                 {
-                    this->buildLogBands();
+                    debugRecord->numTailPostTaper = DebugFrameRecord::copyTail(debugRecord->tailPostTaper,
+                                                                               powerForAggregation.data(),
+                                                                               allowedEndBin);
                 }
 
                 auto& bands = this->tempBands;
                 auto& bandsPreSmooth = this->tempBandsPreSmooth;
                 // Hz-per-bin for current FFT configuration
                 const double binHz = this->currentSampleRate / static_cast<double>(fftSize);
-                SpectrumProcessing::aggregateBandsFractional(powerForAggregation,
-                                                             allowedEnd,
-                                                             binHz,
-                                                             this->bandF0Hz,
-                                                             this->bandF1Hz,
-                                                             minDb,
-                                                             maxDb,
-                                                             bands,
-                                                             bandsPreSmooth);
+
+                // Aggregate linear bins into perceptual log-spaced bands for UI accuracy, esp. low-end
+                {
+                    TRINITY_TRACE_SCOPE(Aggregation);
+                    SpectrumProcessing::aggregateBandsFractional(powerForAggregation,
+                                                                 allowedEnd,
+                                                                 binHz,
+                                                                 layout->bandF0Hz,
+                                                                 layout->bandF1Hz,
+                                                                 minDb,
+                                                                 maxDb,
+                                                                 bands,
+                                                                 bandsPreSmooth);
+                    this->pipelineCapture.capture(PipelineStage::Aggregated, bandsPreSmooth.data(), static_cast<int>(bandsPreSmooth.size()));
+                }
 
                 // Light band-domain smoothing to discourage isolated spikes at the top end
-                // Light band-domain smoothing to discourage isolated spikes at the top end
-                if (this->bandSmoothEnabled.load())
                 {
-                    SpectrumProcessing::smoothBandsInPlace(bands, true);
+                    TRINITY_TRACE_SCOPE(BandSmoothing);
+                    if (this->bandSmoothEnabled.load())
+                    {
+                        SpectrumProcessing::smoothBandsInPlace(bands, true);
+                    }
+                    this->pipelineCapture.capture(PipelineStage::BandSmoothed, bands.data(), static_cast<int>(bands.size()));
                 }
 
+                // Publish for the UI: one small copy into the back slot, no lock
                 {
-                    const SpinLock::ScopedLockType sl (this->spectrumLock);
-                    this->spectrum = bands;                 // copy from reusable buffer
-                    if (this->debugBin.debugCaptureEnabled.load())
+                    TRINITY_TRACE_SCOPE(Publish);
+                    if (float* frame = this->spectrumFrames.beginWrite(static_cast<int>(bands.size())))
+                    {
+                        FloatVectorOperations::copy(frame, bands.data(), static_cast<int>(bands.size()));
+                        this->spectrumFrames.publish();
+                    }
+
+                    if (debugRecord != nullptr)
                     {
-                        this->debugBin.debugTailBinsPreSmooth.shrink_to_fit(); // no-op safety; keep struct usage consistent
-                        this->debugBin.debugBandsPreBandSmooth = bandsPreSmooth;
+                        debugRecord->frameIndex = this->analysisFrameIndex;
+                        debugRecord->hiGuardBins = layout->hiGuardBins;
+                        debugRecord->allowedEndBin = allowedEndBin;
+                        debugRecord->allowedEndHz = jmin(20000.0, static_cast<double>(allowedEndBin + 1) * binHz);
+                        debugRecord->sampleRate = this->currentSampleRate;
+                        debugRecord->fftSize = fftSize;
+                        debugRecord->displayMaxHz = layout->displayMaxHz;
+                        debugRecord->numBandsPreSmooth = DebugFrameRecord::copyBands(debugRecord->bandsPreSmooth,
+                                                                                     bandsPreSmooth.data(),
+                                                                                     static_cast<int>(bandsPreSmooth.size()));
+                        debugRecord->numBandsFinal = DebugFrameRecord::copyBands(debugRecord->bandsFinal,
+                                                                                 bands.data(),
+                                                                                 static_cast<int>(bands.size()));
+                        this->debugRecorder.commitRecord();
                     }
                 }
 
@@ -363,38 +552,48 @@ void TrinityAudioProcessor::processBlock(AudioBuffer<float>& buffer,
             }
         }
     }
+    // Done with this block's layout; lets the message thread free retired ones
+    this->layoutReaderSequence.fetch_add(1);
 }
 
 void TrinityAudioProcessor::processBlock(AudioBuffer<double>& buffer,
                                          MidiBuffer& midi)
 {
-    const int numChannels = buffer.getNumChannels();
-    const int numSamples = buffer.getNumSamples();
-    if (this->tempDoubleBuffer.getNumChannels() != numChannels
-        || this->tempDoubleBuffer.getNumSamples() != numSamples)
+    TRINITY_REALTIME_SCOPE;
+    // Convert through the buffer preallocated in prepareToPlay; blocks larger
+    // than announced are processed in chunks instead of resizing it here.
+    const int numChannels = jmin(buffer.getNumChannels(), this->tempDoubleBuffer.getNumChannels());
+    const int chunkCapacity = this->tempDoubleBuffer.getNumSamples();
+    if (numChannels == 0 || chunkCapacity == 0)
     {
-        this->tempDoubleBuffer.setSize(jmax(1, numChannels), jmax(1, numSamples), false, false, true);
+        return;
     }
 
-    for (int channelIndex = 0; channelIndex < numChannels; ++channelIndex)
+    for (int chunkStart = 0; chunkStart < buffer.getNumSamples(); chunkStart += chunkCapacity)
     {
-        const double* src = buffer.getReadPointer(channelIndex);
-        float* dest = this->tempDoubleBuffer.getWritePointer(channelIndex);
-        for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex)
+        const int chunkSamples = jmin(chunkCapacity, buffer.getNumSamples() - chunkStart);
+        for (int channelIndex = 0; channelIndex < numChannels; ++channelIndex)
         {
-            dest[sampleIndex] = static_cast<float>(src[sampleIndex]);
+            const double* src = buffer.getReadPointer(channelIndex, chunkStart);
+            float* dest = this->tempDoubleBuffer.getWritePointer(channelIndex);
+            for (int sampleIndex = 0; sampleIndex < chunkSamples; ++sampleIndex)
+            {
+                dest[sampleIndex] = static_cast<float>(src[sampleIndex]);
+            }
         }
-    }
 
-    this->processBlock(this->tempDoubleBuffer, midi);
+        // Refers to the preallocated channel data; no allocation for up to 32 channels
+        AudioBuffer<float> chunk(this->tempDoubleBuffer.getArrayOfWritePointers(), numChannels, chunkSamples);
+        this->processBlock(chunk, midi);
 
-    for (int channelIndex = 0; channelIndex < numChannels; ++channelIndex)
-    {
-        const float* src = this->tempDoubleBuffer.getReadPointer(channelIndex);
-        double* dest = buffer.getWritePointer(channelIndex);
-        for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex)
+        for (int channelIndex = 0; channelIndex < numChannels; ++channelIndex)
         {
-            dest[sampleIndex] = static_cast<double>(src[sampleIndex]);
+            const float* src = this->tempDoubleBuffer.getReadPointer(channelIndex);
+            double* dest = buffer.getWritePointer(channelIndex, chunkStart);
+            for (int sampleIndex = 0; sampleIndex < chunkSamples; ++sampleIndex)
+            {
+                dest[sampleIndex] = static_cast<double>(src[sampleIndex]);
+            }
         }
     }
 }
@@ -406,12 +605,35 @@ AudioProcessorEditor* TrinityAudioProcessor::createEditor()
 
 void TrinityAudioProcessor::getStateInformation(MemoryBlock& destData)
 {
-    ignoreUnused(destData);
+    // Host-visible parameters only; the analyzer controls are session settings
+    XmlElement state("TrinityState");
+    for (const AudioProcessorParameter* parameter : this->getParameters())
+    {
+        if (const auto* withId = dynamic_cast<const AudioProcessorParameterWithID*>(parameter))
+        {
+            state.setAttribute(withId->getParameterID(), static_cast<double>(withId->getValue()));
+        }
+    }
+    copyXmlToBinary(state, destData);
 }
 
 void TrinityAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
-    ignoreUnused(data, sizeInBytes);
+    const std::unique_ptr<XmlElement> state = getXmlFromBinary(data, sizeInBytes);
+    if (state == nullptr || !state->hasTagName("TrinityState"))
+    {
+        return;
+    }
+    for (AudioProcessorParameter* parameter : this->getParameters())
+    {
+        if (auto* withId = dynamic_cast<AudioProcessorParameterWithID*>(parameter))
+        {
+            if (state->hasAttribute(withId->getParameterID()))
+            {
+                withId->setValueNotifyingHost(static_cast<float>(state->getDoubleAttribute(withId->getParameterID())));
+            }
+        }
+    }
 }
 
 AudioProcessor* JUCE_CALLTYPE createPluginFilter()
@@ -421,142 +643,190 @@ AudioProcessor* JUCE_CALLTYPE createPluginFilter()
 
 void TrinityAudioProcessor::releaseResources()
 {
-    // Release heavy DSP resources
-    this->console->info("Releasing resources...");
+    // Release heavy DSP resources as far as the retention policy allows
+    this->console.info("Releasing resources...");
+    const DeadlineStats deadlineStats = this->deadlineMonitor.getStats();
+    this->console.info("Deadline: {} blocks, {} overruns, worst {:.3f} ms ({:.0f}% of budget), average load {:.1f}%",
+                        deadlineStats.blocks, deadlineStats.overruns, deadlineStats.worstMs,
+                        deadlineStats.worstRatio * 100.0, deadlineStats.averageLoad * 100.0);
+
+    // The audio thread is stopped, so replaced layouts are no longer read
+    this->retiredBandLayouts.clear();
+    this->fifoIndex = 0;
+    if (this->retentionPolicy == MemoryRetentionPolicy::RetainBuffers)
+    {
+        // Everything stays sized for the next prepareToPlay, which clears the state
+        return;
+    }
+
+    this->resourcesAllocated = false;
     this->fft.reset();
     this->window.reset();
 
-    // Clear and shrink major vectors
-    this->fifo.clear(); this->fifo.shrink_to_fit();
-    this->fftTime.clear(); this->fftTime.shrink_to_fit();
-    this->fftData.clear(); this->fftData.shrink_to_fit();
-    this->spectrum.clear(); this->spectrum.shrink_to_fit();
-    this->spectrumPowerSmoothed.clear(); this->spectrumPowerSmoothed.shrink_to_fit();
-    this->bandBinStart.clear(); this->bandBinStart.shrink_to_fit();
-    this->bandBinEnd.clear(); this->bandBinEnd.shrink_to_fit();
-    this->bandF0Hz.clear(); this->bandF0Hz.shrink_to_fit();
-    this->bandF1Hz.clear(); this->bandF1Hz.shrink_to_fit();
-
-    this->tempPowerForAggregation.clear(); this->tempPowerForAggregation.shrink_to_fit();
-    this->tempBands.clear(); this->tempBands.shrink_to_fit();
-    this->tempBandsPreSmooth.clear(); this->tempBandsPreSmooth.shrink_to_fit();
-
-    this->debugBin.debugTailBinsPreSmooth.clear(); this->debugBin.debugTailBinsPreSmooth.shrink_to_fit();
-    this->debugBin.debugTailBinsPostSmooth.clear(); this->debugBin.debugTailBinsPostSmooth.shrink_to_fit();
-    this->debugBin.debugTailBinsPostTaper.clear(); this->debugBin.debugTailBinsPostTaper.shrink_to_fit();
-    this->debugBin.debugBandsPreBandSmooth.clear(); this->debugBin.debugBandsPreBandSmooth.shrink_to_fit();
+    // Free the analysis arena and every view into it
+    this->analysisArena.release();
+    this->fifo = {};
+    this->fftTime = {};
+    this->fftData = {};
+    this->spectrumPowerSmoothed = {};
+    this->tempPowerForAggregation = {};
+    this->tempBands = {};
+    this->tempBandsPreSmooth = {};
+    // Drop the shared layouts; the last instance to let go frees them
+    this->activeBandLayout.store(nullptr, std::memory_order_release);
+    this->bandLayout.reset();
+    this->retiredBandLayouts.shrink_to_fit();
 
     this->tempDoubleBuffer.setSize(0, 0);
-    this->fifoIndex = 0;
+    this->loudnessFrames = {};
 }
 
-void TrinityAudioProcessor::copySpectrum(std::vector<float>& dest) const
+void TrinityAudioProcessor::allocateAnalysisArena()
 {
-    const SpinLock::ScopedLockType spinLock (this->spectrumLock);
-    dest = this->spectrum;
+    // The plan is the same on every prepare, so a retained arena is only zeroed.
+    // The mono FIFO is written on every block; the rest once per FFT frame.
+    const auto frameSize = static_cast<size_t>(fftSize);
+    const size_t numBins = frameSize / 2;
+    const auto numBandValues = static_cast<size_t>(this->numBands);
+    AlignedArena& arena = this->analysisArena;
+    arena.beginPlan();
+    const int fifoRegion = arena.addRegion("fifo", frameSize, AlignedArena::Heat::Hot);
+    const int fftTimeRegion = arena.addRegion("fftTime", frameSize, AlignedArena::Heat::Cold);
+    const int fftDataRegion = arena.addRegion("fftData", 2 * frameSize, AlignedArena::Heat::Cold);
+    const int powerSmoothedRegion = arena.addRegion("spectrumPowerSmoothed", numBins, AlignedArena::Heat::Cold);
+    const int powerAggregationRegion = arena.addRegion("tempPowerForAggregation", numBins, AlignedArena::Heat::Cold);
+    const int bandsRegion = arena.addRegion("tempBands", numBandValues, AlignedArena::Heat::Cold);
+    const int bandsPreSmoothRegion = arena.addRegion("tempBandsPreSmooth", numBandValues, AlignedArena::Heat::Cold);
+    arena.allocate();
+
+    this->fifo = arena.region(fifoRegion);
+    this->fftTime = arena.region(fftTimeRegion);
+    this->fftData = arena.region(fftDataRegion);
+    this->spectrumPowerSmoothed = arena.region(powerSmoothedRegion);
+    this->tempPowerForAggregation = arena.region(powerAggregationRegion);
+    this->tempBands = arena.region(bandsRegion);
+    this->tempBandsPreSmooth = arena.region(bandsPreSmoothRegion);
 }
 
-void TrinityAudioProcessor::addBandFrequencyData(double bandStartHz, double bandEndHz, int bin0, int bin1)
+MemoryFootprint TrinityAudioProcessor::getMemoryFootprint() const
 {
-    this->bandBinStart.push_back(bin0);
-    this->bandBinEnd.push_back(bin1);
-    this->bandF0Hz.push_back(bandStartHz);
-    this->bandF1Hz.push_back(bandEndHz);
+    MemoryFootprint footprint;
+    size_t arenaRegionBytes = 0;
+    for (const AlignedArena::Region& region : this->analysisArena.getRegions())
+    {
+        const size_t bytes = region.numFloats * sizeof(float);
+        arenaRegionBytes += bytes;
+        footprint.entries.push_back({ region.name, bytes, region.heat == AlignedArena::Heat::Hot
+                                                              ? MemoryFootprintKind::ArenaHot
+                                                              : MemoryFootprintKind::ArenaCold });
+    }
+    footprint.entries.push_back({ "arena padding", this->analysisArena.getBytesReserved() - arenaRegionBytes,
+                                  MemoryFootprintKind::ArenaPadding });
+
+    footprint.entries.push_back({ "crossover filters", this->crossover.getStateBytes(), MemoryFootprintKind::Owned });
+    footprint.entries.push_back({ "loudness meters", this->loudness.getStateBytes() + this->loudnessFrames.capacity() * sizeof(float),
+                                  MemoryFootprintKind::Owned });
+    footprint.entries.push_back({ "double conversion buffer",
+                                  static_cast<size_t>(this->tempDoubleBuffer.getNumChannels())
+                                      * static_cast<size_t>(this->tempDoubleBuffer.getNumSamples()) * sizeof(float),
+                                  MemoryFootprintKind::Owned });
+    footprint.entries.push_back({ "spectrum frames", this->spectrumFrames.getStorageBytes(), MemoryFootprintKind::Owned });
+    footprint.entries.push_back({ "pipeline capture", this->pipelineCapture.getStorageBytes(), MemoryFootprintKind::Owned });
+    footprint.entries.push_back({ "debug capture ring", this->debugRecorder.getRingBytes(), MemoryFootprintKind::Owned });
+    footprint.entries.push_back({ "spike catcher ring", this->spikeCatcher.getRingBytes(), MemoryFootprintKind::Owned });
+
+    if (this->window != nullptr)
+    {
+        footprint.entries.push_back({ "window table", static_cast<size_t>(fftSize) * sizeof(float), MemoryFootprintKind::Shared });
+    }
+    if (this->bandLayout != nullptr)
+    {
+        const size_t edges = this->bandLayout->bandF0Hz.capacity() + this->bandLayout->bandF1Hz.capacity();
+        const size_t bins = this->bandLayout->bandBinStart.capacity() + this->bandLayout->bandBinEnd.capacity();
+        footprint.entries.push_back({ "band layout", edges * sizeof(double) + bins * sizeof(int), MemoryFootprintKind::Shared });
+    }
+    return footprint;
 }
 
-void TrinityAudioProcessor::buildLogBands()
+void TrinityAudioProcessor::selectBandLayout(float guardPercentToUse)
 {
+    // Guarded bins near Nyquist based on guardPercent (proportional with minimum)
     const int numBins = fftSize / 2;
-    this->bandBinStart.clear();
-    this->bandBinEnd.clear();
-    this->bandF0Hz.clear();
-    this->bandF1Hz.clear();
-    this->bandBinStart.reserve(static_cast<size_t>(this->numBands));
-    this->bandBinEnd.reserve(static_cast<size_t>(this->numBands));
-    this->bandF0Hz.reserve(static_cast<size_t>(this->numBands));
-    this->bandF1Hz.reserve(static_cast<size_t>(this->numBands));
-
-    const double binHz = this->currentSampleRate / static_cast<double>(fftSize);
-    const double fMin = 20.0; // start around 20 Hz
-    // Map UI bands only up to the last allowed bin considering both guard and a hard 20 kHz cap
-    const int allowedEndByGuard = jlimit(0, numBins - 1, numBins - this->hiGuardBins - 1);
-    const int capBy20k = jlimit(0, numBins - 1, static_cast<int>(std::floor(20000.0 / binHz)) - 1);
-    const int allowedEndBin = jlimit(0, numBins - 1, jmin(allowedEndByGuard, capBy20k));
-    // Use the end of the last allowed bin as the display cap but not above 20 kHz
-    const double allowedEndHz   = jmin(20000.0, static_cast<double>(allowedEndBin + 1) * binHz);
-    this->displayMaxHz = jmax(fMin * 2.0, allowedEndHz);
-    const double fMax = this->displayMaxHz;
-    const double logMin = std::log(fMin);
-    const double logMax = std::log(fMax);
-
-    for (int bandIndex = 0; bandIndex < this->numBands; ++bandIndex)
-    {
-        // t spans [0,1]
-        const double fractionStart = static_cast<double>(bandIndex) / static_cast<double>(this->numBands);
-        const double fractionEnd = static_cast<double>(bandIndex + 1) / static_cast<double>(this->numBands);
-        double bandStartHz = std::exp(logMin + (logMax - logMin) * fractionStart);
-        double bandEndHz = std::exp(logMin + (logMax - logMin) * fractionEnd);
-        // Clamp to [fMin .. allowedEndHz]
-        bandStartHz = jlimit(fMin, allowedEndHz, bandStartHz);
-        bandEndHz   = jlimit(fMin, allowedEndHz, bandEndHz);
-        if (bandEndHz <= bandStartHz) bandEndHz = jmin(allowedEndHz, bandStartHz + binHz);
-
-        int bin0 = static_cast<int>(std::floor(bandStartHz / binHz + 0.5)); // round to nearest bin
-        int bin1 = static_cast<int>(std::floor(bandEndHz / binHz + 0.5));
-
-        bin0 = jlimit(0, numBins - 1, bin0);
-        bin1 = jlimit(0, numBins - 1, bin1);
-        if (bin1 < bin0)
-        {
-            bin1 = bin0;
-        }
+    const float guardPercentClamped = jlimit(0.0f, 0.2f, guardPercentToUse);
+    const int hiGuardBins = jmax(8, static_cast<int>(std::floor(static_cast<double>(numBins) * static_cast<double>(guardPercentClamped))));
 
-        addBandFrequencyData(bandStartHz, bandEndHz, bin0, bin1);
+    std::shared_ptr<const SpectrumBandLayout> layout =
+        SharedSpectrumResources::getBandLayout(this->currentSampleRate, fftSize, hiGuardBins, this->numBands);
+    if (layout == this->bandLayout)
+    {
+        return;
     }
+    std::shared_ptr<const SpectrumBandLayout> replaced = std::exchange(this->bandLayout, std::move(layout));
+    // Sequentially consistent against the reader: either the audio thread's
+    // next load sees the new layout, or this load sees its block in flight
+    this->activeBandLayout.store(this->bandLayout.get());
+    const uint64_t readerSequence = this->layoutReaderSequence.load();
+    const bool blockInFlight = (readerSequence & 1) != 0;
+    // Only the block still in flight can hold a replaced layout, and only one
+    // replaced while it ran; everything else is freed here
+    std::erase_if(this->retiredBandLayouts, [&](const RetiredBandLayout& retired)
+    {
+        return !blockInFlight || retired.readerSequence != readerSequence || retired.layout == replaced;
+    });
+    if (blockInFlight && replaced != nullptr)
+    {
+        this->retiredBandLayouts.push_back({ std::move(replaced), readerSequence });
+    }
+}
 
-    // Resize UI spectrum buffer to match number of bands
-    const SpinLock::ScopedLockType spinLock (this->spectrumLock);
-    this->spectrum.assign(static_cast<size_t>(this->numBands), 0.0f);
+void TrinityAudioProcessor::setGuardPercent(float newGuardPercent)
+{
+    const float clamped = jlimit(0.0f, 0.2f, newGuardPercent);
+    this->guardPercent.store(clamped);
+    // Before prepareToPlay the layout is picked up there
+    if (this->bandLayout != nullptr)
+    {
+        this->selectBandLayout(clamped);
+    }
 }
 
-void TrinityAudioProcessor::copyDebugData(std::vector<float>& tailPreSmooth,
-                                           std::vector<float>& tailPostSmooth,
-                                           std::vector<float>& tailPostTaper,
-                                           std::vector<float>& bandsPreBandSmooth,
-                                           std::vector<float>& bandsFinal,
-                                           int& outHiGuard,
-                                           int& outAllowedEndBin,
-                                           double& outAllowedEndHz,
-                                           double& outSampleRate,
-                                           int& outFftSize,
-                                           double& outDisplayMaxHz) const
+ProcessorParameterSnapshot TrinityAudioProcessor::getParameterSnapshot() const noexcept
 {
-    const SpinLock::ScopedLockType scopedLock (this->spectrumLock);
-    tailPreSmooth = this->debugBin.debugTailBinsPreSmooth;
-    tailPostSmooth = this->debugBin.debugTailBinsPostSmooth;
-    tailPostTaper = this->debugBin.debugTailBinsPostTaper;
-    bandsPreBandSmooth = this->debugBin.debugBandsPreBandSmooth;
-    bandsFinal = this->spectrum;
-    outHiGuard = this->hiGuardBins;
-    const int numBins = fftSize / 2;
-    const double binHz = this->currentSampleRate / static_cast<double>(fftSize);
-    const int allowedEndByGuard = jlimit(0, numBins - 1, numBins - this->hiGuardBins - 1);
-    const int capBy20k = jlimit(0, numBins - 1, (int) std::floor(20000.0 / binHz) - 1);
-    const int allowedEndBin = jlimit(0, numBins - 1, jmin (allowedEndByGuard, capBy20k));
-    outAllowedEndBin = allowedEndBin;
-    outAllowedEndHz = std::min(20000.0, static_cast<double>(allowedEndBin + 1) * binHz);
-    outSampleRate = this->currentSampleRate;
-    outFftSize = fftSize;
-    outDisplayMaxHz = this->displayMaxHz;
+    ProcessorParameterSnapshot parameters;
+    parameters.soloMode = this->soloMode.load();
+    parameters.testEnabled = this->testSignalGenerator.isEnabled();
+    parameters.testType = this->testSignalGenerator.getType();
+    parameters.freqSmoothEnabled = this->freqSmoothEnabled.load();
+    parameters.bandSmoothEnabled = this->bandSmoothEnabled.load();
+    parameters.guardPercent = this->guardPercent.load();
+    parameters.taperPercent = this->taperPercent.load();
+    parameters.specSmoothing = this->specSmoothing;
+    parameters.crossover.numBands = this->bandCount->get();
+    for (size_t cutoff = 0; cutoff < parameters.crossover.cutoffsHz.size(); ++cutoff)
+    {
+        parameters.crossover.cutoffsHz[cutoff] = this->cutoffParameters[cutoff]->get();
+    }
+    return parameters;
 }
 
-void TrinityAudioProcessor::setGuardPercent(float newGuardPercent) noexcept
+void TrinityAudioProcessor::applyParameterSnapshot(const ProcessorParameterSnapshot& parameters)
 {
-    const float clamped = jlimit(0.0f, 0.2f, newGuardPercent);
-    this->guardPercent.store(clamped);
-    const int numBins = fftSize / 2;
-    this->hiGuardBins = jmax(8, static_cast<int>(std::floor(static_cast<double>(numBins) * static_cast<double>(clamped))));
-    this->buildLogBands();
+    this->setSoloMode(parameters.soloMode);
+    this->setTestType(parameters.testType);
+    this->setTestEnabled(parameters.testEnabled);
+    this->setFreqSmoothingEnabled(parameters.freqSmoothEnabled);
+    this->setBandSmoothingEnabled(parameters.bandSmoothEnabled);
+    // Changing the guard switches the band layout, so only do it when needed
+    if (parameters.guardPercent != this->guardPercent.load())
+    {
+        this->setGuardPercent(parameters.guardPercent);
+    }
+    this->setTaperPercent(parameters.taperPercent);
+    this->setSpecSmoothing(parameters.specSmoothing);
+    if (parameters.crossover != this->getParameterSnapshot().crossover)
+    {
+        this->setCrossoverFrequencies(parameters.crossover);
+    }
 }
 
 void TrinityAudioProcessor::generateTestSignal(AudioBuffer<float>& buffer)
@@ -1,16 +1,31 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include <array>
 #include <atomic>
 #include <vector>
 #include <memory>
-#include <spdlog/logger.h>
-#include <spdlog/sinks/stdout_color_sinks-inl.h>
+#include <span>
 
 #include "models/BandFrequencies.h"
+#include "models/LevelReading.h"
+#include "models/LoudnessReading.h"
+#include "models/MemoryFootprint.h"
+#include "models/MemoryRetentionPolicy.h"
+#include "models/ProcessorParameterSnapshot.h"
 #include "models/SoloMode.h"
+#include "models/SpectrumBandLayout.h"
+#include "services/AlignedArena.h"
 #include "services/AudioProcessorTest.h"
-#include "models/SignalDebugBin.h"
+#include "services/CrossoverTree.h"
+#include "services/DeadlineMonitor.h"
+#include "services/DebugCaptureRecorder.h"
+#include "services/InstanceLog.h"
+#include "services/LevelAccumulator.h"
+#include "services/LoudnessMeter.h"
+#include "services/PipelineCapture.h"
+#include "services/SpectrumFrameExchange.h"
+#include "services/SpikeCatcher.h"
 
 class TrinityAudioProcessor : public AudioProcessor
 {
@@ -19,10 +34,6 @@ public:
     // Expose SoloMode as a nested type for call sites that expect
     // TrinityAudioProcessor::SoloMode::X while keeping the enum defined
     // in models/SoloMode.h as the single source of truth.
-    static void initDspProcessSpec(double sampleRate, int samplesPerBlock,
-                                      dsp::ProcessSpec& spec);
-    void initCrossoverFilters(dsp::ProcessSpec spec);
-    static void initCrossoverFilter(dsp::ProcessSpec spec, auto& crossover, BandFrequencies bandCutoff);
     ~TrinityAudioProcessor() override = default;
 
     const String getName() const override
@@ -80,32 +91,59 @@ public:
     void getStateInformation(MemoryBlock& destData) override;
     void setStateInformation(const void* data, int sizeInBytes) override;
 
-    float getRMSLevel() const noexcept
+    // Meter readings: peak and mean square of everything processed since the
+    // previous take, which resets them. One reader (the editor); bands above
+    // the count read empty.
+    LevelReading takeTotalLevel() noexcept
+    {
+        return this->totalMeter.take();
+    }
+    LevelReading takeBandLevel(int band) noexcept
     {
-        return rmsLevel.load();
+        return isPositiveAndBelow(band, CrossoverFrequencies::maxBands) ? this->bandMeters[static_cast<size_t>(band)].take()
+                                                                         : LevelReading {};
     }
 
-    float getTotalLevel() const noexcept
+    // BS.1770 loudness, meter 0 the input and 1 + band each crossover band,
+    // updated every 100 ms. Safe from any thread.
+    LoudnessReading getLoudness(int meter) const noexcept
+    {
+        return this->loudness.getReading(meter);
+    }
+    // Restarts integrated loudness and loudness range on the next block
+    void resetLoudness() noexcept
+    {
+        this->loudnessResetRequested.store(true);
+    }
+
+    // The same levels without resetting them, from any thread
+    float getRMSLevel() const noexcept
     {
-        return totalLevel.load();
+        return this->totalMeter.peek().getRms();
     }
-    float getLowLevel() const noexcept
+    float getTotalLevel() const noexcept
     {
-        return lowLevel.load();
+        return this->totalMeter.peek().peak;
     }
-    float getMidLevel() const noexcept
+    // Peak of a crossover band (0 = lowest)
+    float getBandLevel(int band) const noexcept
     {
-        return midLevel.load();
+        return isPositiveAndBelow(band, CrossoverFrequencies::maxBands) ? this->bandMeters[static_cast<size_t>(band)].peek().peak
+                                                                         : 0.0f;
     }
-    float getHighLevel() const noexcept
+    // Bands the crossover is splitting into right now
+    int getNumBands() const noexcept
     {
-        return highLevel.load();
+        return liveNumBands.load();
     }
 
-    // Copy latest spectrum magnitudes [0..1] into dest (thread-safe).
-    void copySpectrum (std::vector<float>& dest) const;
-    void addBandFrequencyData(double bandStartHz, double bandEndHz, int bin0,
-                              int bin1);
+    // View of the latest published spectrum frame, magnitudes [0..1], read in
+    // place without copying. Single consumer (the editor's UI thread); the view
+    // stays valid until the next call.
+    SpectrumFrameView acquireSpectrumFrame() noexcept
+    {
+        return this->spectrumFrames.acquireLatest();
+    }
 
     void setSoloMode (SoloMode mode) noexcept
     {
@@ -116,15 +154,21 @@ public:
         return soloMode.load();
     }
 
+    // Band count and crossover cutoffs, also exposed as host-automatable
+    // parameters. Cutoff changes glide there over crossoverGlideSeconds; a
+    // band count change restarts the crossover. The getter returns what the
+    // audio thread is using right now (mid-glide included) and is safe from
+    // any thread; the setter notifies the host, message thread only.
+    CrossoverFrequencies getCrossoverFrequencies() const noexcept;
+    void setCrossoverFrequencies(CrossoverFrequencies frequencies);
+
     // Display range helper for the editor (upper frequency bound after guards)
     double getDisplayMaxHz() const noexcept
     {
-        return displayMaxHz;
+        const SpectrumBandLayout* layout = this->activeBandLayout.load(std::memory_order_acquire);
+        return layout != nullptr ? layout->displayMaxHz : 20000.0;
     }
 
-    // Debug export is provided by the extended version below.
-
-
     void setTestEnabled (bool enabled) noexcept
     {
         testSignalGenerator.setEnabled(enabled);
@@ -133,43 +177,167 @@ public:
     {
         testSignalGenerator.setType(type);
     }
+    // Seed for the noise test signals, applied by the next prepareToPlay;
+    // equal seeds make runs bit-reproducible.
+    void setTestSignalSeed (uint32 seed) noexcept
+    {
+        testSignalGenerator.setSeed(seed);
+    }
+
+    // Debug capture: every analysis frame is recorded (tail bins, pre-smooth and
+    // final bands) without locking the audio thread and streamed to a binary
+    // capture file; convert it with DebugCaptureFile::convertToCsv or the
+    // trinity_capture_to_csv tool.
+    bool startDebugCapture(const File& file)
+    {
+        return this->debugRecorder.start(file);
+    }
+    void stopDebugCapture()
+    {
+        this->debugRecorder.stop();
+    }
+    bool isDebugCaptureRunning() const noexcept
+    {
+        return this->debugRecorder.isRecording();
+    }
+    const DebugCaptureRecorder& getDebugRecorder() const noexcept
+    {
+        return this->debugRecorder;
+    }
+
+    // Full-width per-stage capture of the spectrum pipeline. mask is a combination
+    // of pipelineStageBit() values; storage is preallocated in prepareToPlay.
+    void setPipelineCaptureStages(uint32_t mask) noexcept
+    {
+        this->pipelineCapture.setStageMask(mask);
+    }
+    uint32_t getPipelineCaptureStages() const noexcept
+    {
+        return this->pipelineCapture.getStageMask();
+    }
+    // Newest captured frame of a stage (one reader per stage), read in place.
+    SpectrumFrameView acquirePipelineStage(PipelineStage stage) noexcept
+    {
+        return this->pipelineCapture.acquire(stage);
+    }
+
+    // Timing of every processBlock against its real-time budget. Safe from any
+    // thread; the reset takes effect before the next audio callback.
+    DeadlineStats getDeadlineStats() const noexcept
+    {
+        return this->deadlineMonitor.getStats();
+    }
+    void resetDeadlineStats() noexcept
+    {
+        this->deadlineMonitor.requestReset();
+    }
+
+    // Spike catcher: while running, any processBlock slower than thresholdMs
+    // saves the preceding input blocks and control values as a replay bundle
+    // in directory (replay with trinity_render --replay).
+    bool startSpikeCatcher(const File& directory, double thresholdMs)
+    {
+        return this->spikeCatcher.arm(directory, thresholdMs);
+    }
+    void stopSpikeCatcher()
+    {
+        this->spikeCatcher.disarm();
+    }
+    const SpikeCatcher& getSpikeCatcher() const noexcept
+    {
+        return this->spikeCatcher;
+    }
 
-    // Enable/disable debug capture of tail bins and pre-smooth bands to avoid
-    // allocations in the audio thread when not needed (prevents crackles).
-    void setDebugCaptureEnabled (bool enabled) noexcept
+    // What releaseResources frees. Message thread, outside prepare/release.
+    void setMemoryRetentionPolicy(MemoryRetentionPolicy policy) noexcept
     {
-        debugBin.debugCaptureEnabled.store(enabled);
+        this->retentionPolicy = policy;
     }
+    MemoryRetentionPolicy getMemoryRetentionPolicy() const noexcept
+    {
+        return this->retentionPolicy;
+    }
+    // Heap memory held by this instance, itemised. Message thread.
+    MemoryFootprint getMemoryFootprint() const;
+
+    // Current values of all user controls; safe from any thread.
+    ProcessorParameterSnapshot getParameterSnapshot() const noexcept;
+    void applyParameterSnapshot(const ProcessorParameterSnapshot& parameters);
 
 private:
-    std::shared_ptr<spdlog::logger> console { spdlog::stdout_color_mt("Trinity") };
-    std::atomic<float> rmsLevel { 0.0f };
+    // Tagged handle on the shared process-wide logger
+    InstanceLog console;
 
-    std::atomic<float> totalLevel { 0.0f };
-    std::atomic<float> lowLevel { 0.0f };
-    std::atomic<float> midLevel { 0.0f };
-    std::atomic<float> highLevel { 0.0f };
+    // Input and per-band levels, accumulated until the editor takes them
+    LevelAccumulator totalMeter;
+    std::array<LevelAccumulator, CrossoverFrequencies::maxBands> bandMeters;
 
-    std::atomic<SoloMode> soloMode { SoloMode::None };
+    // K-weighted loudness of the input and every band, fed with frames the
+    // crossover writes per sub-block; sized in prepareToPlay
+    LoudnessMeter loudness;
+    std::vector<float> loudnessFrames;
+    int loudnessFrameStride { 0 };
+    std::atomic<bool> loudnessResetRequested { false };
 
-    dsp::LinkwitzRileyFilter<float> lowMidCrossover[2];
-    dsp::LinkwitzRileyFilter<float> midHighCrossover[2];
+    std::atomic<SoloMode> soloMode { SoloMode::None };
 
-    dsp::ProcessSpec processSpec {};
+    // Band split with allpass compensation; state sized in prepareToPlay
+    CrossoverTree crossover;
+
+    // Crossover parameters, owned by the AudioProcessor base
+    AudioParameterInt* bandCount { nullptr };
+    std::array<AudioParameterFloat*, CrossoverFrequencies::maxCutoffs> cutoffParameters {};
+    // Cutoffs glide in equal ratios, one step per crossoverSubBlock samples.
+    // The tree is retuned (one tan per cutoff) only on sub-blocks where the
+    // cutoffs moved; the TPT structure of the filters keeps the glide free
+    // of zipper noise.
+    static constexpr int crossoverSubBlock = 32;
+    static constexpr double crossoverGlideSeconds = 0.05;
+    std::array<SmoothedValue<float, ValueSmoothingTypes::Multiplicative>, CrossoverFrequencies::maxCutoffs> cutoffGlides;
+    CrossoverFrequencies glidingCutoffs;  // audio thread: what the tree is tuned to
+    std::atomic<int> liveNumBands { CrossoverFrequencies {}.numBands };
+    std::array<std::atomic<float>, CrossoverFrequencies::maxCutoffs> liveCutoffsHz {};
+
+    // Parameter values made valid at sampleRate
+    CrossoverFrequencies getCrossoverTargets(double sampleRate) const noexcept;
+    // Moves the tree and the glides straight to cutoffs
+    void snapCrossover(const CrossoverFrequencies& cutoffs) noexcept;
+    bool isCrossoverGliding() const noexcept;
+    void publishLiveCrossover() noexcept;
+
+    // Configuration the buffers were last built for; prepareToPlay compares
+    // against it to rebuild only what changed
+    MemoryRetentionPolicy retentionPolicy { MemoryRetentionPolicy::RetainBuffers };
+    bool resourcesAllocated { false };  // cleared by a full release
+    int preparedChannels { 0 };
+    size_t loggedFootprintBytes { 0 };  // last footprint logged; only changes are logged
+
+    DeadlineMonitor deadlineMonitor;
+    double preparedSampleRate { 0.0 };  // rate of the previous prepareToPlay, for change events
+    int preparedBlockSize { 0 };
+    int lastBlockChannels { 0 };        // audio thread: channel count of the previous block
+    int largestBlockSeen { 0 };         // audio thread: blocks above this are reported once
+    SpikeCatcher spikeCatcher;
 
     // ===== Realtime FFT for spectrum =====
     static constexpr int fftOrder = 11;              // 2^11 = 2048 for better low-end resolution
     static constexpr int fftSize  = 1 << fftOrder;   // 2048 samples
 
-    std::vector<float> fifo;        // incoming mono samples
+    // Analysis buffers are views into one aligned arena, laid out in prepareToPlay
+    AlignedArena analysisArena;
+    void allocateAnalysisArena();
+
+    std::span<float> fifo;          // incoming mono samples
     int fifoIndex { 0 };
-    std::vector<float> fftTime;     // windowed time-domain buffer (size fftSize)
-    std::vector<float> fftData;     // interleaved real/imag for JUCE FFT (size 2*fftSize)
-    std::vector<float> spectrum;    // magnitudes [0..1], log-averaged bands for UI
-    std::vector<float> spectrumPowerSmoothed; // smoothed linear power per FFT bin (size fftSize/2)
+    std::span<float> fftTime;       // windowed time-domain buffer (size fftSize)
+    std::span<float> fftData;       // interleaved real/imag for JUCE FFT (size 2*fftSize)
+    SpectrumFrameExchange spectrumFrames; // lock-free hand-off of band frames to the UI
+    std::span<float> spectrumPowerSmoothed; // smoothed linear power per FFT bin (size fftSize/2)
 
+    // The plan is per instance; the window is shared with every other
+    // instance at the same settings (SharedSpectrumResources)
     std::unique_ptr<dsp::FFT> fft;
-    std::unique_ptr<dsp::WindowingFunction<float>> window;
+    std::shared_ptr<const dsp::WindowingFunction<float>> window;
     float specSmoothing { 0.2f };  // simple one-pole smoothing in processor
 
     // Amplitude calibration
@@ -184,17 +352,22 @@ private:
     // Log-frequency band aggregation for UI (improves perceived low-end accuracy)
     int numBands { 96 };
     double currentSampleRate { 44100.0 };
-    std::vector<int> bandBinStart; // per band [inclusive] (legacy/diagnostic)
-    std::vector<int> bandBinEnd;   // per band [inclusive] (legacy/diagnostic)
-    // Fractional band edges in Hz for accurate aggregation (precomputed)
-    std::vector<double> bandF0Hz;  // per band start frequency (Hz)
-    std::vector<double> bandF1Hz;  // per band end frequency (Hz)
-
-    void buildLogBands();
+    // Band edges, guard and display range; shared and immutable. The message
+    // thread owns the references, the audio thread reads activeBandLayout.
+    // A layout replaced by setGuardPercent while a block is in flight stays
+    // alive until the next swap after that block, so the audio thread never
+    // holds the last reference. layoutReaderSequence is odd while it may.
+    struct RetiredBandLayout
+    {
+        std::shared_ptr<const SpectrumBandLayout> layout;
+        uint64_t readerSequence { 0 };
+    };
+    std::shared_ptr<const SpectrumBandLayout> bandLayout;
+    std::vector<RetiredBandLayout> retiredBandLayouts;
+    std::atomic<const SpectrumBandLayout*> activeBandLayout { nullptr };
+    std::atomic<uint64_t> layoutReaderSequence { 0 };
 
-    // ===== Edge-handling / display helpers =====
-    int hiGuardBins { 0 };                 // number of highest bins to ignore
-    double displayMaxHz { 20000.0 };       // upper frequency actually displayed (post-guard)
+    void selectBandLayout(float guardPercentToUse);
 
     // Edge/smoothing controls (debug/Standalone only)
     std::atomic<bool> freqSmoothEnabled { true };   // enable frequency-domain smoothing across bins
@@ -212,7 +385,7 @@ public:
     {
         this->bandSmoothEnabled.store(newBandSmoothingEnabled);
     }
-    void setGuardPercent(float newGuardPercent) noexcept;
+    void setGuardPercent(float newGuardPercent);
 
     void setTaperPercent(float newTaperPercent) noexcept
     {
@@ -228,33 +401,18 @@ public:
     void generateTestSignal(AudioBuffer<float>& buffer);
 
     // ===== Debug capture =====
-    mutable SpinLock spectrumLock;  // protect spectrum access
-    // Bundle all debug-related buffers/flags into a single struct
-    SignalDebugBin debugBin;
+    DebugCaptureRecorder debugRecorder;
+    PipelineCapture pipelineCapture;
+    uint64 analysisFrameIndex { 0 };   // counts FFT frames, stamped on debug records
 
-    // ===== Temporary buffers to avoid allocations in the audio thread =====
-    std::vector<float> tempPowerForAggregation;   // size numBins
-    std::vector<float> tempBands;                 // size numBands
-    std::vector<float> tempBandsPreSmooth;        // size numBands
-    std::vector<float> tempBandsSmooth;           // size numBands (for smoothing output)
-    AudioBuffer<float> tempDoubleBuffer;    // reused in processBlock(double)
+    // ===== Temporary buffers to avoid allocations in the audio thread (arena views) =====
+    std::span<float> tempPowerForAggregation;     // size numBins
+    std::span<float> tempBands;                   // size numBands
+    std::span<float> tempBandsPreSmooth;          // size numBands
+    AudioBuffer<float> tempDoubleBuffer;    // reused in processBlock(double), sized in prepareToPlay
 
     AudioTestProcessor testSignalGenerator;
-public:
-    // Extended debug export
-    void copyDebugData(std::vector<float>& tailPreSmooth,
-                        std::vector<float>& tailPostSmooth,
-                        std::vector<float>& tailPostTaper,
-                        std::vector<float>& bandsPreBandSmooth,
-                        std::vector<float>& bandsFinal,
-                        int& outHiGuard,
-                        int& outAllowedEndBin,
-                        double& outAllowedEndHz,
-                        double& outSampleRate,
-                        int& outFftSize,
-                        double& outDisplayMaxHz) const;
 
-private:
     // Small helpers to reduce repetition and improve clarity
     static float mixDownToMonoSample(const AudioBuffer<float>& buffer, int sampleIndex) noexcept
     {
@@ -26,8 +26,16 @@ void AudioMeter::paint(Graphics& graphics)
     const float currentLevel = jlimit(0.0f, 1.0f, this->levelPtr ? *this->levelPtr : 0.0f);
     const float levelNormalised = computeLevelNormalized(currentLevel, this->minDb, this->maxDb);
     drawFilledBar(graphics, innerRect, levelNormalised, cornerRadius, style);
+    if (this->rmsPtr != nullptr)
+    {
+        drawRmsMarker(graphics, innerRect, computeLevelNormalized(jlimit(0.0f, 1.0f, *this->rmsPtr), this->minDb, this->maxDb));
+    }
+    if (this->loudnessPtr != nullptr)
+    {
+        drawLoudness(graphics, innerRect, *this->loudnessPtr, this->minDb, this->maxDb);
+    }
     drawPeakHoldMarker(graphics, innerRect, this->peakHoldLevel);
-    drawClipLed(graphics, columnBounds, this->clipHoldFrames > 0, style.ledSize);
+    drawClipLed(graphics, columnBounds, this->clipHoldRemainingMs > 0.0f, style.ledSize);
     if (this->showTicks)
     {
         drawDbTicksAndLabels(graphics, componentArea, innerRect,
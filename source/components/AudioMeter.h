@@ -3,6 +3,8 @@
 #include <JuceHeader.h>
 #include "../models/MeterVisualStyle.h"
 #include "../models/MeterDbScaleSpec.h"
+#include "../models/LoudnessReading.h"
+#include "../services/UiBallistics.h"
 class AudioMeter : public Component
 {
 public:
@@ -14,6 +16,19 @@ public:
         this->levelPtr = ptr;
     }
 
+    // Optional RMS level, drawn as a marker over the peak bar
+    void setRmsPointer (float* ptr)
+    {
+        this->rmsPtr = ptr;
+    }
+
+    // Optional loudness: momentary as a marker on the dB scale (LUFS read as
+    // dBFS), and momentary, short-term, integrated and range as text
+    void setLoudnessPointer (const LoudnessReading* ptr)
+    {
+        this->loudnessPtr = ptr;
+    }
+
     void setLabel (const String& text)
     {
         this->label = text;
@@ -40,30 +55,53 @@ public:
         this->repaint();
     }
 
-    // Advance one UI frame: update peak-hold / clip LED from current level.
-    void advanceFrame()
+    // Advance one UI frame of elapsedMs: update peak-hold / clip LED from current level.
+    // Only repaints when something visible changed; returns whether it did.
+    bool advanceFrame(float elapsedMs)
     {
         const float currentLevel = jlimit (0.0f, 1.0f, this->levelPtr ? *this->levelPtr : 0.0f);
         const float db = Decibels::gainToDecibels(currentLevel, this->minDb);
         float norm = jmap(db, this->minDb, this->maxDb, 0.0f, 1.0f);
         norm = jlimit(0.0f, 1.0f, norm);
 
-        this->peakHoldLevel *= this->peakHoldDecay;
-        if (norm > this->peakHoldLevel)
-        {
-            this->peakHoldLevel = norm;
-        }
+        const float previousPeakHoldLevel = this->peakHoldLevel;
+        const bool wasClipOn = this->clipHoldRemainingMs > 0.0f;
+
+        const float peakDecay = UiBallistics::decayForElapsed(this->peakHoldReleaseMs, elapsedMs);
+        this->peakHoldLevel = UiBallistics::peakHold(this->peakHoldLevel, norm, peakDecay);
 
         if (db >= this->maxDb - 0.1f)
         {
-            this->clipHoldFrames = this->clipHoldDurationFrames;
+            this->clipHoldRemainingMs = this->clipHoldMs;
         }
-        else if (this->clipHoldFrames > 0)
+        else
         {
-            --this->clipHoldFrames;
+            this->clipHoldRemainingMs = UiBallistics::advanceHold(this->clipHoldRemainingMs, elapsedMs);
         }
 
-        this->repaint();
+        const float rmsNorm = this->rmsPtr ? computeLevelNormalized(jlimit(0.0f, 1.0f, *this->rmsPtr), this->minDb, this->maxDb) : 0.0f;
+
+        // Loudness text shows tenths; redraw when any of them changes
+        const LoudnessReading loudness = this->loudnessPtr ? *this->loudnessPtr : LoudnessReading {};
+        const bool loudnessChanged = this->loudnessPtr != nullptr
+                                  && (!sameTenths(loudness.momentaryLufs, this->lastShownLoudness.momentaryLufs)
+                                      || !sameTenths(loudness.shortTermLufs, this->lastShownLoudness.shortTermLufs)
+                                      || !sameTenths(loudness.integratedLufs, this->lastShownLoudness.integratedLufs)
+                                      || !sameTenths(loudness.loudnessRangeLu, this->lastShownLoudness.loudnessRangeLu));
+
+        const bool changed = std::abs(norm - this->lastShownLevel) > visibleChangeThreshold
+                          || std::abs(rmsNorm - this->lastShownRms) > visibleChangeThreshold
+                          || loudnessChanged
+                          || std::abs(this->peakHoldLevel - previousPeakHoldLevel) > visibleChangeThreshold
+                          || wasClipOn != (this->clipHoldRemainingMs > 0.0f);
+        if (changed)
+        {
+            this->lastShownLevel = norm;
+            this->lastShownRms = rmsNorm;
+            this->lastShownLoudness = loudness;
+            this->repaint();
+        }
+        return changed;
     }
 
     void paint (Graphics& graphics) override;
@@ -157,6 +195,69 @@ private:
         graphics.drawLine(markerLeft, markerY, markerRight, markerY, 2.0f);
     }
 
+    static void drawRmsMarker(Graphics& graphics,
+                              const Rectangle<float>& innerRect,
+                              float rmsNormalised)
+    {
+        if (rmsNormalised <= 0.0f)
+        {
+            return;
+        }
+        const float markerY = innerRect.getBottom() - rmsNormalised * innerRect.getHeight();
+        graphics.setColour(Colours::white.withAlpha(0.6f));
+        graphics.drawLine(innerRect.getX() + 4.0f, markerY, innerRect.getRight() - 4.0f, markerY, 1.5f);
+    }
+
+    static bool sameTenths(float a, float b) noexcept
+    {
+        if (!std::isfinite(a) || !std::isfinite(b))
+        {
+            return std::isfinite(a) == std::isfinite(b);
+        }
+        return std::round(a * 10.0f) == std::round(b * 10.0f);
+    }
+
+    // One decimal, or "--" before there is anything to show
+    static String formatLoudness(float value)
+    {
+        return std::isfinite(value) ? String(value, 1) : String("--");
+    }
+
+    static void drawLoudness(Graphics& graphics,
+                             const Rectangle<float>& innerRect,
+                             const LoudnessReading& loudness,
+                             float minDb,
+                             float maxDb)
+    {
+        if (std::isfinite(loudness.momentaryLufs))
+        {
+            const float momentaryNorm = jlimit(0.0f, 1.0f, jmap(loudness.momentaryLufs, minDb, maxDb, 0.0f, 1.0f));
+            const float markerY = innerRect.getBottom() - momentaryNorm * innerRect.getHeight();
+            graphics.setColour(Colours::cyan.withAlpha(0.7f));
+            graphics.drawLine(innerRect.getX() + 4.0f, markerY, innerRect.getRight() - 4.0f, markerY, 1.5f);
+        }
+
+        // Readout along the bottom of the column when it has room
+        const float lineHeight = 13.0f;
+        if (innerRect.getHeight() < lineHeight * 8.0f || innerRect.getWidth() < 40.0f)
+        {
+            return;
+        }
+        const String lines[] = { "M " + formatLoudness(loudness.momentaryLufs),
+                                 "S " + formatLoudness(loudness.shortTermLufs),
+                                 "I " + formatLoudness(loudness.integratedLufs),
+                                 "LRA " + formatLoudness(loudness.loudnessRangeLu) };
+        graphics.setColour(Colours::white.withAlpha(0.75f));
+        graphics.setFont(11.0f);
+        float lineTop = innerRect.getBottom() - lineHeight * 4.0f - 2.0f;
+        for (const String& line : lines)
+        {
+            graphics.drawFittedText(line, Rectangle<float>(innerRect.getX() + 3.0f, lineTop, innerRect.getWidth() - 6.0f, lineHeight).toNearestInt(),
+                                    Justification::centredLeft, 1);
+            lineTop += lineHeight;
+        }
+    }
+
     static void drawClipLed(Graphics& graphics,
                             const Rectangle<float>& columnBounds,
                             bool clipOn,
@@ -231,15 +332,21 @@ private:
     }
 
     float* levelPtr { nullptr };
+    float* rmsPtr { nullptr };
+    const LoudnessReading* loudnessPtr { nullptr };
     String label { "" };
 
     // Visual/state
     float peakHoldLevel { 0.0f };
-    int clipHoldFrames { 0 };
+    float clipHoldRemainingMs { 0.0f };
+    float lastShownLevel { -1.0f };
+    float lastShownRms { -1.0f };
+    LoudnessReading lastShownLoudness;
+    static constexpr float visibleChangeThreshold = 1.0e-4f;
 
     // Tuning
-    float peakHoldDecay { 0.96f };            // per-frame
-    int   clipHoldDurationFrames { 18 };      // ~0.6s @ 30 fps
+    float peakHoldReleaseMs { 820.0f };       // time constant of peak-hold decay
+    float clipHoldMs { 600.0f };              // clip LED hold time
     float minDb { -120.0f };
     float maxDb { 0.0f };
     bool  showTicks { true };
@@ -6,7 +6,7 @@ AudioSpectrumMeters::AudioSpectrumMeters()
 {
     for (auto& meter : this->meters)
     {
-        this->addAndMakeVisible(meter);
+        this->addChildComponent(meter);
     }
 }
 
@@ -27,22 +27,27 @@ void AudioSpectrumMeters::initTickDisplays()
     }
 }
 
-void AudioSpectrumMeters::setMeters(const std::array<MeterInfo, 4>& meterInfos)
+void AudioSpectrumMeters::setMeters(std::span<const MeterInfo> meterInfos)
 {
-    // Connect external level pointers and labels
-    for (int meterIndex = 0; meterIndex < 4; ++meterIndex)
+    // Connect external level pointers and labels; unused meters hide
+    this->numMeters = jmin(static_cast<int>(meterInfos.size()), maxMeters);
+    for (int meterIndex = 0; meterIndex < maxMeters; ++meterIndex)
     {
         size_t meter_index = static_cast<size_t>(meterIndex);
-        this->meters[meter_index].setLevelPointer(meterInfos[meterIndex].levelPtr);
-        this->meters[meter_index].setLabel(meterInfos[meterIndex].label != nullptr
-                                                   ? String(meterInfos[meterIndex].label)
+        const bool isShown = meterIndex < this->numMeters;
+        this->meters[meter_index].setLevelPointer(isShown ? meterInfos[meter_index].levelPtr : nullptr);
+        this->meters[meter_index].setRmsPointer(isShown ? meterInfos[meter_index].rmsPtr : nullptr);
+        this->meters[meter_index].setLoudnessPointer(isShown ? meterInfos[meter_index].loudnessPtr : nullptr);
+        this->meters[meter_index].setLabel(isShown && meterInfos[meter_index].label != nullptr
+                                                   ? String(meterInfos[meter_index].label)
                                                    : String());
+        this->meters[meter_index].setVisible(isShown);
     }
     // Configure dB range and tick visibility
     this->initDbRanges();
     this->initTickDisplays();
     this->meters[0].setLeftGutterWidth(this->metrics.leftGutterWidth);
-    for (int meterIndex = 1; meterIndex < 4; ++meterIndex)
+    for (int meterIndex = 1; meterIndex < maxMeters; ++meterIndex)
     {
         size_t meter_index = static_cast<size_t>(meterIndex);
         this->meters[meter_index].setLeftGutterWidth(0.0f);
@@ -52,12 +57,22 @@ void AudioSpectrumMeters::setMeters(const std::array<MeterInfo, 4>& meterInfos)
     this->repaint();
 }
 
-void AudioSpectrumMeters::advanceFrame()
+void AudioSpectrumMeters::setLabel(int meterIndex, const String& text)
 {
-    for (auto& meter : this->meters)
+    if (isPositiveAndBelow(meterIndex, static_cast<int>(this->meters.size())))
+    {
+        this->meters[static_cast<size_t>(meterIndex)].setLabel(text);
+    }
+}
+
+bool AudioSpectrumMeters::advanceFrame(float elapsedMs)
+{
+    bool anyChanged = false;
+    for (int meterIndex = 0; meterIndex < this->numMeters; ++meterIndex)
     {
-        meter.advanceFrame();
+        anyChanged = this->meters[static_cast<size_t>(meterIndex)].advanceFrame(elapsedMs) || anyChanged;
     }
+    return anyChanged;
 }
 
 void AudioSpectrumMeters::resized()
@@ -72,20 +87,30 @@ void AudioSpectrumMeters::paint(Graphics&)
 
 int AudioSpectrumMeters::computeTotalGroupWidth() const noexcept
 {
-    return this->metrics.computeTotalGroupWidth();
+    return this->metrics.computeTotalGroupWidth(this->numMeters);
 }
 
 void AudioSpectrumMeters::layoutMetersWithin(Rectangle<int> bounds)
 {
-    const int meterColumnWidth = this->metrics.meterColumnWidth();
+    if (this->numMeters <= 0)
+    {
+        return;
+    }
     const int firstMeterGutter = this->metrics.firstMeterGutter();
     const int gapBetweenMeters = this->metrics.gapBetweenMeters();
-
-    const int totalGroupWidth = this->computeTotalGroupWidth();
+    int meterColumnWidth = this->metrics.meterColumnWidth();
+    int totalGroupWidth = this->computeTotalGroupWidth();
+    if (totalGroupWidth > bounds.getWidth())
+    {
+        // With many bands the columns share out the available width
+        const int spareWidth = bounds.getWidth() - firstMeterGutter - gapBetweenMeters * (this->numMeters - 1);
+        meterColumnWidth = jmax(24, spareWidth / this->numMeters);
+        totalGroupWidth = firstMeterGutter + meterColumnWidth * this->numMeters + gapBetweenMeters * (this->numMeters - 1);
+    }
     int xPosition = bounds.getX() + (bounds.getWidth() - totalGroupWidth) / 2;
     const int meterHeight = bounds.getHeight();
 
-    for (int i = 0; i < meters.size(); ++i)
+    for (int i = 0; i < this->numMeters; ++i)
     {
         int initialGutter = i == 0 ? firstMeterGutter : 0;
         this->meters[i].setBounds(xPosition, bounds.getY(), meterColumnWidth + initialGutter, meterHeight);
@@ -2,12 +2,15 @@
 
 #include <JuceHeader.h>
 #include <array>
+#include <span>
 #include "AudioMeter.h"
+#include "../models/BandFrequencies.h"
 #include "../models/MeterInfo.h"
 #include "../models/MeterLayoutMetrics.h"
 
-// Container for four AudioMeter components, laid out side-by-side and centred.
-// The first meter shows dB ticks/labels in a left gutter so the group looks polished.
+// Container for the total meter and one per crossover band, laid out
+// side-by-side and centred; columns narrow when they do not fit. The first
+// meter shows dB ticks/labels in a left gutter so the group looks polished.
 class AudioSpectrumMeters : public Component
 {
 public:
@@ -16,16 +19,23 @@ public:
     void initTickDisplays();
     ~AudioSpectrumMeters() override = default;
 
-    void setMeters(const std::array<MeterInfo, 4>& infos);
+    static constexpr int maxMeters = 1 + CrossoverFrequencies::maxBands;
 
-    void advanceFrame();
+    // Shows one meter per info (up to maxMeters), left to right; the rest hide
+    void setMeters(std::span<const MeterInfo> infos);
+    // Replaces one meter's label (0 = total, then the bands from the lowest)
+    void setLabel(int meterIndex, const String& text);
+
+    // Advance all meters by elapsedMs; returns true when any changed visibly.
+    bool advanceFrame(float elapsedMs);
 
     void resized() override;
 
     void paint(Graphics& graphics) override;
 
 private:
-    std::array<AudioMeter, 4> meters;
+    std::array<AudioMeter, maxMeters> meters;
+    int numMeters { 0 };  // shown, from the left
 
     MeterLayoutMetrics metrics; // groups widths/gaps and total width helpers
 
@@ -0,0 +1,125 @@
+#include "DeadlinePanel.h"
+
+using namespace juce;
+
+DeadlinePanel::DeadlinePanel()
+{
+    this->addAndMakeVisible(this->btnReset);
+    this->btnReset.onClick = [this]
+    {
+        if (this->onReset)
+        {
+            this->onReset();
+        }
+        // Show the cleared state straight away
+        this->msSinceRefresh = refreshIntervalMs;
+    };
+}
+
+void DeadlinePanel::setStatsSource(std::function<DeadlineStats()> source)
+{
+    this->statsSource = std::move(source);
+    this->msSinceRefresh = refreshIntervalMs;
+}
+
+bool DeadlinePanel::advanceFrame(float elapsedMs)
+{
+    this->msSinceRefresh += elapsedMs;
+    if (this->msSinceRefresh < refreshIntervalMs || !this->statsSource)
+    {
+        return false;
+    }
+    this->msSinceRefresh = 0.0f;
+
+    const DeadlineStats latest = this->statsSource();
+    const bool changed = latest.blocks != this->stats.blocks
+                      || latest.smoothedLoad != this->stats.smoothedLoad;
+    this->stats = latest;
+    if (changed)
+    {
+        this->repaint();
+    }
+    return changed;
+}
+
+void DeadlinePanel::resized()
+{
+    const int pad = 6;
+    auto bounds = this->getLocalBounds().reduced(pad);
+    auto buttonColumn = bounds.removeFromRight(64);
+    this->btnReset.setBounds(buttonColumn.withSizeKeepingCentre(60, jmin(24, buttonColumn.getHeight())));
+    bounds.removeFromRight(pad);
+    this->textArea = bounds.removeFromLeft(bounds.getWidth() / 2);
+    bounds.removeFromLeft(pad);
+    this->histogramArea = bounds;
+}
+
+void DeadlinePanel::paint(Graphics& graphics)
+{
+    graphics.fillAll(Colour(0xff151515));
+    graphics.setColour(Colours::darkgrey);
+    graphics.drawRect(this->getLocalBounds(), 1);
+
+    const double overrunPercent = this->stats.blocks > 0
+        ? 100.0 * static_cast<double>(this->stats.overruns) / static_cast<double>(this->stats.blocks)
+        : 0.0;
+    constexpr int overrunLine = 1;
+    const StringArray lines {
+        "DSP load " + String(this->stats.smoothedLoad * 100.0, 1) + "%  (avg "
+            + String(this->stats.averageLoad * 100.0, 1) + "%)",
+        "Blocks " + String(static_cast<int64>(this->stats.blocks)) + "  overruns "
+            + String(static_cast<int64>(this->stats.overruns)) + " (" + String(overrunPercent, 3) + "%)",
+        "Worst " + String(this->stats.worstMs, 3) + " ms = " + String(this->stats.worstRatio * 100.0, 0)
+            + "% of " + String(this->stats.worstBlockSize) + "-sample budget",
+        "p50 " + String(this->stats.percentileRatio(0.5) * 100.0, 1) + "%  p99 "
+            + String(this->stats.percentileRatio(0.99) * 100.0, 1) + "%  p99.9 "
+            + String(this->stats.percentileRatio(0.999) * 100.0, 1) + "%"
+    };
+
+    graphics.setFont(Font(FontOptions(12.0f)));
+    const int lineHeight = jmax(1, this->textArea.getHeight() / lines.size());
+    auto lineArea = this->textArea;
+    for (int lineIndex = 0; lineIndex < lines.size(); ++lineIndex)
+    {
+        const bool highlight = lineIndex == overrunLine && this->stats.overruns > 0;
+        graphics.setColour(highlight ? Colours::orangered : Colours::lightgrey);
+        graphics.drawText(lines[lineIndex], lineArea.removeFromTop(lineHeight), Justification::centredLeft, true);
+    }
+
+    this->paintHistogram(graphics, this->histogramArea.toFloat());
+}
+
+void DeadlinePanel::paintHistogram(Graphics& graphics, Rectangle<float> area) const
+{
+    if (area.isEmpty())
+    {
+        return;
+    }
+    uint32_t largest = 0;
+    for (uint32_t count : this->stats.histogram)
+    {
+        largest = jmax(largest, count);
+    }
+
+    // Log count scale so single overruns stay visible next to millions of blocks
+    const float logLargest = std::log1p(static_cast<float>(largest));
+    const float barWidth = area.getWidth() / static_cast<float>(DeadlineStats::numBuckets);
+    for (int bucket = 0; bucket < DeadlineStats::numBuckets; ++bucket)
+    {
+        const uint32_t count = this->stats.histogram[static_cast<size_t>(bucket)];
+        if (count == 0 || logLargest <= 0.0f)
+        {
+            continue;
+        }
+        const float height = area.getHeight() * std::log1p(static_cast<float>(count)) / logLargest;
+        const bool isOverrun = bucket >= DeadlineStats::firstOverrunBucket();
+        graphics.setColour(isOverrun ? Colours::red : Colours::seagreen);
+        graphics.fillRect(area.getX() + barWidth * static_cast<float>(bucket), area.getBottom() - height,
+                          jmax(1.0f, barWidth - 1.0f), height);
+    }
+
+    // Budget line between the last in-time bucket and the first overrun bucket
+    const float budgetX = area.getX() + barWidth * static_cast<float>(DeadlineStats::firstOverrunBucket());
+    graphics.setColour(Colours::white.withAlpha(0.6f));
+    graphics.drawVerticalLine(roundToInt(budgetX), area.getY(), area.getBottom());
+}
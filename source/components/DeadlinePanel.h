@@ -0,0 +1,42 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <functional>
+#include "../models/DeadlineStats.h"
+
+// Diagnostics strip for the processor's callback deadline statistics: load,
+// overrun count and worst case as text, and the load-ratio histogram as bars
+// with the overrun buckets in red. Pulls a snapshot a few times per second
+// rather than every frame.
+class DeadlinePanel : public Component
+{
+public:
+    DeadlinePanel();
+    ~DeadlinePanel() override = default;
+
+    void setStatsSource(std::function<DeadlineStats()> source);
+
+    // Advance by elapsedMs; refreshes from the source when due and returns
+    // true when the panel repainted.
+    bool advanceFrame(float elapsedMs);
+
+    // Called by the Reset button.
+    std::function<void()> onReset;
+
+    void paint(Graphics& graphics) override;
+    void resized() override;
+
+private:
+    static constexpr float refreshIntervalMs = 250.0f;
+
+    void paintHistogram(Graphics& graphics, Rectangle<float> area) const;
+
+    std::function<DeadlineStats()> statsSource;
+    DeadlineStats stats;
+    float msSinceRefresh { refreshIntervalMs };
+    TextButton btnReset { "Reset" };
+    Rectangle<int> textArea;
+    Rectangle<int> histogramArea;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DeadlinePanel)
+};
@@ -6,27 +6,57 @@
 
 void GraphicalSpectrumAnalyzer::setFrequencyRange(float minHz, float maxHz)
 {
+    const FrequencyRange previousRange = this->frequencyRange;
     this->frequencyRange.set(minHz, maxHz);
-    this->repaint();
+    // Called every frame by the editor; avoid queuing repaints when nothing moved
+    if (previousRange.minHz != this->frequencyRange.minHz || previousRange.maxHz != this->frequencyRange.maxHz)
+    {
+        this->repaint();
+    }
 }
 
-void GraphicalSpectrumAnalyzer::setMagnitudes(const float* values, int numValues)
+void GraphicalSpectrumAnalyzer::setCrossoverFrequencies(CrossoverFrequencies frequencies)
 {
-    if (values == nullptr || numValues <= 0)
+    // Also called every frame; only a moved cutoff repaints
+    if (frequencies != this->crossoverFrequencies)
     {
-        return;
+        this->crossoverFrequencies = frequencies;
+        this->repaint();
     }
-
-    this->magnitudes.assign(values, values + numValues);
-    this->applySmoothingAndPeaks();
-    this->repaint();
 }
 
-void GraphicalSpectrumAnalyzer::setMagnitudes(const std::vector<float>& values)
+void GraphicalSpectrumAnalyzer::setFrame(const SpectrumFrameView& frame, float elapsedMs)
 {
-    this->magnitudes = values;
-    this->applySmoothingAndPeaks();
-    this->repaint();
+    if (frame.isEmpty())
+    {
+        return;
+    }
+
+    const bool isNewFrame = frame.sequence != this->currentFrame.sequence;
+    if (isNewFrame)
+    {
+        this->missedFrames += frame.framesMissedSince(this->currentFrame.sequence);
+    }
+    this->currentFrame = frame;
+
+    // A repeated frame with settled ballistics needs no work at all
+    if (!isNewFrame && !this->isAnimating())
+    {
+        return;
+    }
+
+    // Delegate to service for consistency and reuse.
+    this->lastUpdateChange = UiMagnitudeProcessor::process(frame.values,
+                                                           static_cast<size_t>(frame.numValues),
+                                                           this->smoothed,
+                                                           this->peaks,
+                                                           this->ballisticsScratch,
+                                                           this->uiSettings,
+                                                           elapsedMs);
+    if (this->isAnimating())
+    {
+        this->repaint();
+    }
 }
 
 void GraphicalSpectrumAnalyzer::paint(Graphics& graphics)
@@ -44,7 +74,7 @@ void GraphicalSpectrumAnalyzer::paint(Graphics& graphics)
     // Subtle band backgrounds for Low / Mid / High ranges within the plot area
     this->drawBandBackgrounds(graphics, plotBounds);
 
-    if (this->magnitudes.empty())
+    if (this->smoothed.empty())
     {
         return;
     }
@@ -222,16 +252,6 @@ void GraphicalSpectrumAnalyzer::resized()
     // Nothing to lay out internally for now.
 }
 
-void GraphicalSpectrumAnalyzer::applySmoothingAndPeaks()
-{
-    if (this->magnitudes.empty())
-    {
-        return;
-    }
-    // Delegate to service for consistency and reuse.
-    UiMagnitudeProcessor::process(this->magnitudes, this->smoothed, this->peaks, this->uiSettings);
-}
-
 // ===================== Extracted helpers (implementations) =====================
 
 void GraphicalSpectrumAnalyzer::drawBandBackgrounds(Graphics& graphics, Rectangle<float> bounds) const
@@ -242,27 +262,21 @@ void GraphicalSpectrumAnalyzer::drawBandBackgrounds(Graphics& graphics, Rectangl
     const float minFrequencyHz = std::max(1.0f, this->frequencyRange.clampedMin());
     const float maxFrequencyHz = std::max(minFrequencyHz * 1.01f, this->frequencyRange.clampedMax());
 
-    const float xMin = this->mapSegmentedFrequencyToX(minFrequencyHz, plot.leftX, plot.rightX);
-    const float lowBandEndHz = static_cast<float>(BandFrequencies::LowBandEndHz);
-    const float midBandEndHz = static_cast<float>(BandFrequencies::MidBandEndHz);
-    const float xLow = this->mapSegmentedFrequencyToX(std::min(lowBandEndHz, maxFrequencyHz), plot.leftX, plot.rightX);
-    const float xMid = this->mapSegmentedFrequencyToX(std::min(midBandEndHz, maxFrequencyHz), plot.leftX, plot.rightX);
-    const float xMax = this->mapSegmentedFrequencyToX(maxFrequencyHz, plot.leftX, plot.rightX);
-
+    // One tint per crossover band, each from its lower cutoff to the next
     BandTints tints;
-    graphics.setColour(tints.low);
-    graphics.fillRect(Rectangle(std::min (xMin, xLow), plot.topY, std::abs (xLow - xMin), plot.height));
-
-    if (xMid > xLow)
-    {
-        graphics.setColour(tints.mid);
-        graphics.fillRect(Rectangle(xLow, plot.topY, xMid - xLow, plot.height));
-    }
-
-    if (xMax > xMid)
+    const int numBands = this->crossoverFrequencies.numBands;
+    float bandStartX = this->mapSegmentedFrequencyToX(minFrequencyHz, plot.leftX, plot.rightX);
+    for (int band = 0; band < numBands; ++band)
     {
-        graphics.setColour(tints.high);
-        graphics.fillRect(Rectangle(xMid, plot.topY, xMax - xMid, plot.height));
+        const float bandEndHz = band < numBands - 1 ? this->crossoverFrequencies.cutoffsHz[static_cast<size_t>(band)] : maxFrequencyHz;
+        const float bandEndX = this->mapSegmentedFrequencyToX(std::clamp(bandEndHz, minFrequencyHz, maxFrequencyHz),
+                                                              plot.leftX, plot.rightX);
+        if (bandEndX > bandStartX)
+        {
+            graphics.setColour(tints.forBand(band, numBands));
+            graphics.fillRect(Rectangle(bandStartX, plot.topY, bandEndX - bandStartX, plot.height));
+            bandStartX = bandEndX;
+        }
     }
 }
 
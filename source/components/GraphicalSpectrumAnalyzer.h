@@ -4,10 +4,12 @@
 #include <vector>
 #include <cmath>
 #include <algorithm>
+#include "../models/BandFrequencies.h"
 #include "../models/FrequencyRange.h"
 #include "../models/UiDynamicsSettings.h"
 #include "../models/SpectrumAnalyzerStyle.h"
 #include "../models/SegmentedFrequencyLayout.h"
+#include "../models/SpectrumFrameView.h"
 
 class GraphicalSpectrumAnalyzer : public Component
 {
@@ -40,31 +42,53 @@ public:
     // Set the display frequency range used for drawing tick marks
     void setFrequencyRange(float minHz, float maxHz);
 
-    /** Provide a new block of magnitudes to display.
-        Values should be normalised 0.0f .. 1.0f (0 = silence, 1 = full scale).
-        You can call this from your editor's timerCallback.
+    // Crossover cutoffs that split the band background tints
+    void setCrossoverFrequencies(CrossoverFrequencies frequencies);
+
+    /** Point the analyzer at the latest published frame (normalised 0..1).
+        The frame is read in place, so it must stay valid until the next call.
+        Repeated frames (same sequence) are not re-ingested; ballistics still
+        advance by elapsedMs until the display settles.
     */
-    void setMagnitudes(const float* values, int numValues);
+    void setFrame(const SpectrumFrameView& frame, float elapsedMs);
+
+    // Analysis frames published by the processor that never reached the display.
+    uint64_t getMissedFrameCount() const noexcept
+    {
+        return this->missedFrames;
+    }
 
-    void setMagnitudes(const std::vector<float>& values);
+    // True while smoothing or peak-hold is still moving on screen.
+    bool isAnimating() const noexcept
+    {
+        return this->lastUpdateChange > settledThreshold;
+    }
 
     void paint(Graphics& graphics) override;
 
     void resized() override;
 
 private:
-    // incoming magnitudes [0..1]
-    std::vector<float> magnitudes;
+    // latest frame from the processor, magnitudes [0..1]
+    SpectrumFrameView currentFrame {};
+    uint64_t missedFrames { 0 };
     // smoothed magnitudes for stable display
     std::vector<float> smoothed;
     // peak-hold values per bin
     std::vector<float> peaks;
+    // working memory for the ballistics kernels
+    std::vector<float> ballisticsScratch;
 
     // Style and dynamics consolidated
     UiDynamicsSettings uiSettings {};
 
+    // Largest smoothed/peak change applied by the last update
+    float lastUpdateChange { 0.0f };
+    static constexpr float settledThreshold = 1.0e-4f;
+
     // Frequency range for labels/ticks
     FrequencyRange frequencyRange {};
+    CrossoverFrequencies crossoverFrequencies {};
 
     // Extracted styles/config
     VisualTuning visualTuning {};
@@ -76,8 +100,6 @@ private:
     AnalyzerBackgroundStyle backgroundStyle {};
     SpectrumFillGradientStyle fillStyle {};
 
-    void applySmoothingAndPeaks();
-
     // Helpers (extracted for readability)
     // Map frequency to x (log scale within current display range)
     float mapLogFrequencyToX(float hz, float xLeft, float xRight) const noexcept;
@@ -0,0 +1,119 @@
+#include "SpectrogramView.h"
+
+SpectrogramView::SpectrogramView()
+{
+    this->setOpaque(true);
+}
+
+void SpectrogramView::setHistoryLength(int numColumns)
+{
+    this->historyColumns = jmax(1, numColumns);
+    this->allocate(this->historyColumns, this->numBands);
+    this->repaint();
+}
+
+void SpectrogramView::allocate(int numColumns, int bandCount)
+{
+    this->numBands = bandCount;
+    this->writeColumnIndex = 0;
+    this->identicalColumnRun = 0;
+    this->history.assign(static_cast<size_t>(numColumns) * static_cast<size_t>(jmax(0, bandCount)), 0.0f);
+    this->lastColumnIndices.assign(static_cast<size_t>(jmax(0, bandCount)), 0);
+    if (bandCount > 0)
+    {
+        this->image = Image(Image::ARGB, numColumns, bandCount, false);
+        this->image.clear(this->image.getBounds(), Colours::black);
+    }
+    else
+    {
+        this->image = Image();
+    }
+}
+
+bool SpectrogramView::setFrame(const SpectrumFrameView& frame)
+{
+    if (frame.isEmpty() || frame.sequence == this->lastSequence)
+    {
+        return false;
+    }
+    const uint64_t missedFrames = frame.framesMissedSince(this->lastSequence);
+    this->lastSequence = frame.sequence;
+
+    if (frame.numValues != this->numBands)
+    {
+        this->allocate(this->historyColumns, frame.numValues);
+    }
+
+    // Frames published while the UI ran slower than the analysis each keep
+    // their column; their values are gone, so they repeat the newest frame.
+    // More than a full history only needs one pass over the image.
+    const auto numColumns = static_cast<int>(jmin(missedFrames + 1, static_cast<uint64_t>(this->historyColumns)));
+    for (int column = 0; column < numColumns; ++column)
+    {
+        this->writeColumn(frame.values);
+    }
+    this->columnsWritten += missedFrames + 1;
+    // Once every visible column is identical, scrolling no longer changes the picture
+    if (this->identicalColumnRun >= this->historyColumns)
+    {
+        return false;
+    }
+    this->repaint();
+    return true;
+}
+
+void SpectrogramView::writeColumn(const float* values)
+{
+    const int column = this->writeColumnIndex;
+    float* ringFrame = this->history.data() + static_cast<size_t>(column) * static_cast<size_t>(this->numBands);
+    FloatVectorOperations::copy(ringFrame, values, this->numBands);
+
+    bool columnUnchanged = true;
+    {
+        Image::BitmapData bitmap(this->image, column, 0, 1, this->numBands, Image::BitmapData::writeOnly);
+        for (int band = 0; band < this->numBands; ++band)
+        {
+            const auto lutIndex = static_cast<uint8>(SpectrogramColourMap::indexFor(ringFrame[band]));
+            columnUnchanged = columnUnchanged && lutIndex == this->lastColumnIndices[static_cast<size_t>(band)];
+            this->lastColumnIndices[static_cast<size_t>(band)] = lutIndex;
+            // Row 0 is the top of the image: highest band
+            const int row = this->numBands - 1 - band;
+            *reinterpret_cast<PixelARGB*>(bitmap.getPixelPointer(0, row)) = this->lut[lutIndex];
+        }
+    }
+
+    this->identicalColumnRun = columnUnchanged ? this->identicalColumnRun + 1 : 0;
+    this->writeColumnIndex = (column + 1) % this->historyColumns;
+}
+
+void SpectrogramView::paint(Graphics& graphics)
+{
+    const auto bounds = this->getLocalBounds();
+    graphics.setGradientFill(this->backgroundStyle.buildBackgroundGradient(bounds.toFloat()));
+    graphics.fillAll();
+    if (!this->image.isValid())
+    {
+        return;
+    }
+
+    const Rectangle<int> plot = bounds.reduced(static_cast<int>(this->vignetteStyle.sideVignetteWidth), 0);
+    const int columns = this->historyColumns;
+    const int oldestColumn = this->writeColumnIndex;
+    const int olderSpan = columns - oldestColumn; // columns [oldest .. end) come first
+    const int splitX = plot.getX() + (plot.getWidth() * olderSpan) / columns;
+
+    // Two blits with a moving offset; the image itself is never redrawn
+    graphics.setImageResamplingQuality(Graphics::lowResamplingQuality);
+    graphics.drawImage(this->image,
+                       plot.getX(), plot.getY(), splitX - plot.getX(), plot.getHeight(),
+                       oldestColumn, 0, olderSpan, this->numBands);
+    if (oldestColumn > 0)
+    {
+        graphics.drawImage(this->image,
+                           splitX, plot.getY(), plot.getRight() - splitX, plot.getHeight(),
+                           0, 0, oldestColumn, this->numBands);
+    }
+
+    graphics.setColour(Colours::black.withAlpha(this->vignetteStyle.sideBarsAlpha));
+    graphics.drawRect(plot, 1);
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+#include "../models/SpectrumFrameView.h"
+#include "../models/SpectrumAnalyzerStyle.h"
+#include "../services/SpectrogramColourMap.h"
+
+// Scrolling time-frequency history (waterfall) of the processor's band frames.
+// Keeps a fixed-capacity ring of frames and an image with one column per ring
+// slot. Each new analysis frame writes exactly one image column through the
+// colour LUT; scrolling only moves the blit offset, so old columns are never
+// redrawn. Newest frame is on the right, highest band at the top. Frames the
+// UI skipped (sequence gaps) still get their columns, filled with the newest
+// values, so the time axis stays one column per analysis frame at any UI rate.
+class SpectrogramView : public Component
+{
+public:
+    SpectrogramView();
+    ~SpectrogramView() override = default;
+
+    // Number of frames kept (image width). Clears the history.
+    void setHistoryLength(int numColumns);
+
+    // Ingest the latest published frame; repeated sequences are ignored.
+    // Returns true when the visible picture changed.
+    bool setFrame(const SpectrumFrameView& frame);
+
+    // Analysis frames shown since construction, one column each
+    uint64_t getColumnsWritten() const noexcept
+    {
+        return this->columnsWritten;
+    }
+
+    void paint(Graphics& graphics) override;
+
+private:
+    void allocate(int numColumns, int numBands);
+    void writeColumn(const float* values);
+
+    // Ring of band frames: history[column * numBands + band]
+    std::vector<float> history;
+    int historyColumns { 512 };
+    int numBands { 0 };
+    int writeColumnIndex { 0 };    // next column to write; also the oldest column
+    int identicalColumnRun { 0 };  // consecutive columns equal to their predecessor
+    uint64_t lastSequence { 0 };
+    uint64_t columnsWritten { 0 };
+
+    Image image;
+    std::vector<uint8> lastColumnIndices;
+    SpectrogramColourMap::Lut lut { SpectrogramColourMap::build() };
+
+    AnalyzerBackgroundStyle backgroundStyle {};
+    VignetteStyle vignetteStyle {};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrogramView)
+};
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Result of analysing a contiguous run of frames (one chunk of a file).
+struct BandAnalysisChunk
+{
+    int64_t firstFrame { 0 };
+    int numFrames { 0 };
+    int numMeters { 4 };             // total, then one per crossover band
+    std::vector<float> bands;        // numFrames x numBands, final band values [0..1]
+    std::vector<float> meterPeaks;   // numFrames x numMeters, linear sample peaks
+    std::vector<double> binPowerSum; // per FFT bin, summed tapered linear power (for LTAS)
+};
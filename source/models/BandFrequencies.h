@@ -1,7 +1,85 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <initializer_list>
+#include <string>
+
+// Default crossover cutoffs
 enum class BandFrequencies : int
 {
     LowBandEndHz = 250,
     MidBandEndHz = 2000
 };
+
+// Crossover band count and cutoffs in Hz, as set by the crossover parameters.
+// Only the first numBands - 1 cutoffs are in use.
+struct CrossoverFrequencies
+{
+    static constexpr int minBands = 2;
+    static constexpr int maxBands = 8;
+    static constexpr int maxCutoffs = maxBands - 1;
+    static constexpr float minHz = 20.0f;
+    static constexpr float maxHz = 20000.0f;
+    static constexpr float minRatio = 1.5f;         // each cutoff stays at least this far above the previous one
+    static constexpr float maxNyquistShare = 0.9f;  // and the top one below this share of Nyquist
+    // Parameter defaults: the classic three-band split, then room for more bands
+    static constexpr std::array<float, maxCutoffs> defaultCutoffsHz {
+        static_cast<float>(BandFrequencies::LowBandEndHz), static_cast<float>(BandFrequencies::MidBandEndHz),
+        3000.0f, 4500.0f, 7000.0f, 10500.0f, 16000.0f
+    };
+
+    int numBands { 3 };
+    std::array<float, maxCutoffs> cutoffsHz { defaultCutoffsHz };
+
+    // cutoffs.size() + 1 bands; the remaining cutoffs keep their defaults.
+    static CrossoverFrequencies withCutoffs(std::initializer_list<float> cutoffs) noexcept
+    {
+        CrossoverFrequencies result;
+        result.numBands = std::clamp(static_cast<int>(cutoffs.size()) + 1, minBands, maxBands);
+        std::copy_n(cutoffs.begin(), result.getNumCutoffs(), result.cutoffsHz.begin());
+        return result;
+    }
+
+    int getNumCutoffs() const noexcept
+    {
+        return this->numBands - 1;
+    }
+
+    // Band count clamped, cutoffs in range, ascending and below Nyquist at
+    // sampleRate. Colliding cutoffs are pushed up; near the top they are
+    // pushed down so the ones above still fit.
+    CrossoverFrequencies constrainedTo(double sampleRate) const noexcept
+    {
+        CrossoverFrequencies result = *this;
+        result.numBands = std::clamp(this->numBands, minBands, maxBands);
+        const int numCutoffs = result.getNumCutoffs();
+        const float topHz = std::min(maxHz, static_cast<float>(sampleRate * 0.5) * maxNyquistShare);
+        float lowestHz = minHz;
+        for (int cutoff = 0; cutoff < numCutoffs; ++cutoff)
+        {
+            const float highestHz = topHz / std::pow(minRatio, static_cast<float>(numCutoffs - 1 - cutoff));
+            float& valueHz = result.cutoffsHz[static_cast<size_t>(cutoff)];
+            valueHz = std::clamp(valueHz, std::min(lowestHz, highestHz), highestHz);
+            lowestHz = valueHz * minRatio;
+        }
+        return result;
+    }
+
+    // "Low", "Mid" (or "Mid 1", "Mid 2", ...) and "High", counted from the bottom.
+    static std::string bandName(int band, int numBands)
+    {
+        if (band <= 0)
+        {
+            return "Low";
+        }
+        if (band >= numBands - 1)
+        {
+            return "High";
+        }
+        return numBands == 3 ? "Mid" : "Mid " + std::to_string(band);
+    }
+
+    bool operator==(const CrossoverFrequencies&) const = default;
+};
@@ -6,5 +6,20 @@ struct BandTints
 {
     Colour low { Colour::fromRGBA(0, 120, 255, 18) };  // soft blue, ~7%
     Colour mid { Colour::fromRGBA(255, 255, 255, 12) }; // light neutral, ~5%
+    Colour midAlternate { Colour::fromRGBA(255, 255, 255, 6) }; // every other mid band, ~2%
     Colour high { Colour::fromRGBA(180, 80, 255, 18) };  // soft violet, ~7%
+
+    // Lowest band blue, highest violet, the ones between alternate neutrals
+    Colour forBand(int band, int numBands) const noexcept
+    {
+        if (band <= 0)
+        {
+            return this->low;
+        }
+        if (band >= numBands - 1)
+        {
+            return this->high;
+        }
+        return band % 2 == 1 ? this->mid : this->midAlternate;
+    }
 };
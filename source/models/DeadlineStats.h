@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+// Snapshot of processBlock timing against the real-time budget
+// (numSamples / sampleRate). Load ratios are duration / budget, so 1.0 means
+// the callback used its whole budget and anything above is a deadline overrun.
+struct DeadlineStats
+{
+    // Log2 histogram of the load ratio, two buckets per octave. Each bucket
+    // includes its upper edge, so a ratio of exactly 1 is counted below the
+    // first overrun bucket, as it is by isOverrun. Bucket 0 also holds
+    // everything below minRatio, the last bucket everything above.
+    static constexpr int numBuckets = 32;
+    static constexpr int bucketsPerOctave = 2;
+    static constexpr int lowestOctave = -10;  // minRatio = 2^-10, about 0.1% of the budget
+
+    uint64_t blocks { 0 };
+    uint64_t overruns { 0 };        // blocks with ratio > 1
+    double worstRatio { 0.0 };
+    double worstMs { 0.0 };
+    int worstBlockSize { 0 };
+    double averageLoad { 0.0 };     // total callback time / total audio time
+    double smoothedLoad { 0.0 };    // AudioProcessLoadMeasurer's running estimate
+    double sampleRate { 0.0 };
+    std::array<uint32_t, numBuckets> histogram {};
+
+    // The one overrun test, shared by the counter and the histogram
+    static bool isOverrun(double ratio) noexcept
+    {
+        return ratio > 1.0;
+    }
+
+    static int bucketForRatio(double ratio) noexcept
+    {
+        if (!(ratio > 0.0))
+        {
+            return 0;
+        }
+        const double position = std::ceil((std::log2(ratio) - static_cast<double>(lowestOctave)) * bucketsPerOctave) - 1.0;
+        if (position < 0.0)
+        {
+            return 0;
+        }
+        return position >= static_cast<double>(numBuckets - 1) ? numBuckets - 1 : static_cast<int>(position);
+    }
+
+    // Lower edge of a bucket as a load ratio.
+    static double bucketLowerRatio(int bucket) noexcept
+    {
+        return std::exp2(static_cast<double>(lowestOctave) + static_cast<double>(bucket) / bucketsPerOctave);
+    }
+
+    static double bucketUpperRatio(int bucket) noexcept
+    {
+        return bucketLowerRatio(bucket + 1);
+    }
+
+    // First bucket above the full budget (ratio 1): every ratio in it and the
+    // buckets after it is an overrun.
+    static int firstOverrunBucket() noexcept
+    {
+        return -lowestOctave * bucketsPerOctave;
+    }
+
+    // Upper edge of the bucket holding the given quantile (0..1); an upper
+    // bound on the true percentile, accurate to half an octave.
+    double percentileRatio(double quantile) const noexcept
+    {
+        uint64_t total = 0;
+        for (uint32_t count : this->histogram)
+        {
+            total += count;
+        }
+        if (total == 0)
+        {
+            return 0.0;
+        }
+        const double target = quantile * static_cast<double>(total);
+        uint64_t cumulative = 0;
+        for (int bucket = 0; bucket < numBuckets; ++bucket)
+        {
+            cumulative += this->histogram[static_cast<size_t>(bucket)];
+            if (static_cast<double>(cumulative) >= target)
+            {
+                return bucketUpperRatio(bucket);
+            }
+        }
+        return bucketUpperRatio(numBuckets - 1);
+    }
+};
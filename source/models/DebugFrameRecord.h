@@ -0,0 +1,53 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+// Fixed-layout debug record for one analysis frame. Filled in place on the
+// audio thread inside DebugCaptureRecorder's ring, so it must stay trivially
+// copyable and allocation-free.
+struct DebugFrameRecord
+{
+    static constexpr int maxTailBins = 64;
+    static constexpr int maxBands = 128;
+
+    uint64_t frameIndex { 0 };      // processor analysis frame counter
+    int32_t hiGuardBins { 0 };
+    int32_t allowedEndBin { 0 };
+    double allowedEndHz { 0.0 };
+    double sampleRate { 0.0 };
+    int32_t fftSize { 0 };
+    double displayMaxHz { 0.0 };
+
+    int32_t numTailPreSmooth { 0 };
+    int32_t numTailPostSmooth { 0 };
+    int32_t numTailPostTaper { 0 };
+    int32_t numBandsPreSmooth { 0 };
+    int32_t numBandsFinal { 0 };
+
+    float tailPreSmooth[maxTailBins] {};
+    float tailPostSmooth[maxTailBins] {};
+    float tailPostTaper[maxTailBins] {};
+    float bandsPreSmooth[maxBands] {};
+    float bandsFinal[maxBands] {};
+
+    // Copy up to maxTailBins bins ending at endBin (inclusive); returns the count.
+    static int32_t copyTail(float* dest, const float* source, int endBin) noexcept
+    {
+        if (endBin < 0)
+        {
+            return 0;
+        }
+        const int startBin = std::max(0, endBin - (maxTailBins - 1));
+        std::copy(source + startBin, source + endBin + 1, dest);
+        return static_cast<int32_t>(endBin - startBin + 1);
+    }
+
+    // Copy up to maxBands values; returns the count.
+    static int32_t copyBands(float* dest, const float* source, int count) noexcept
+    {
+        const int clamped = std::clamp(count, 0, maxBands);
+        std::copy(source, source + clamped, dest);
+        return static_cast<int32_t>(clamped);
+    }
+};
@@ -0,0 +1,12 @@
+#pragma once
+
+struct FramePacingSettings
+{
+    double idleRateHz { 10.0 };            // refresh rate while nothing on screen changes
+    double frameBudgetFraction { 0.5 };    // paint may use this share of the frame interval
+    double headroomFraction { 0.2 };       // step up only below this share of the faster interval
+    int framesBeforeIdle { 30 };           // consecutive static frames before idling
+    int framesBeforeRateChange { 8 };      // hysteresis when stepping the rate ladder
+    double maxElapsedSeconds { 0.25 };     // clamp for ballistics after stalls
+    double paintCostSmoothing { 0.2 };     // one-pole smoothing of measured paint cost
+};
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+// Meter levels gathered by the audio thread since the previous reading
+struct LevelReading
+{
+    float peak { 0.0f };        // largest absolute sample, linear
+    float meanSquare { 0.0f };  // mean of the squared samples, all channels
+    uint32_t numSamples { 0 };  // samples behind meanSquare; 0 = no audio since the last reading
+
+    float getRms() const noexcept
+    {
+        return std::sqrt(this->meanSquare);
+    }
+};
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <limits>
+
+// ITU-R BS.1770 loudness of one signal. Levels are LUFS; -infinity means
+// nothing measurable yet (silence, or the integrated gate found no block).
+struct LoudnessReading
+{
+    static constexpr float unmeasured = -std::numeric_limits<float>::infinity();
+
+    float momentaryLufs { unmeasured };   // last 400 ms
+    float shortTermLufs { unmeasured };   // last 3 s
+    float integratedLufs { unmeasured };  // gated, since the last reset
+    float loudnessRangeLu { 0.0f };       // EBU Tech 3342 LRA of the short-term values
+
+    bool hasIntegrated() const noexcept
+    {
+        return this->integratedLufs > unmeasured;
+    }
+};
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <vector>
+
+// Result of one measurement: the impulse response (where the method yields
+// one) and the transfer function on the multitone frequency grid.
+struct MeasuredResponse
+{
+    double sampleRate { 0.0 };
+    double audioSeconds { 0.0 };           // excitation played, including pre-roll
+    std::vector<float> impulseResponse;    // empty for multitone
+    int timeZeroIndex { 0 };               // leading samples before time zero (sweep pre-ringing)
+    int latencySamples { -1 };             // onset after time zero: first sample within -20 dB of the peak; -1 if not measured
+    int peakIndex { -1 };                  // relative to time zero
+    std::vector<double> frequencyHz;
+    std::vector<double> magnitudeDb;
+    std::vector<double> phaseDegrees;      // with latencySamples of pure delay removed
+};
@@ -0,0 +1,15 @@
+#pragma once
+
+// Excitation and analysis settings for the measurement signals. The defaults
+// keep every measurement below half a second of audio at 48 kHz.
+struct MeasurementSettings
+{
+    float amplitude { 0.25f };
+    double startHz { 20.0 };
+    double endHz { 20000.0 };       // clamped to 0.45 * sample rate
+    double sweepSeconds { 0.25 };   // rounded to the nearest synchronized length
+    int mlsOrder { 13 };            // period 2^order - 1 samples
+    int multitoneOrder { 13 };      // period 2^order samples
+    int tonesPerOctave { 3 };       // also the frequency grid of every analysis
+    int responseLength { 4096 };    // impulse response samples kept; sweep tail and impulse period
+};
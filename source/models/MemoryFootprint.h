@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+enum class MemoryFootprintKind
+{
+    ArenaHot,      // aligned arena, state touched every block
+    ArenaCold,     // aligned arena, per-frame scratch
+    ArenaPadding,  // cache-line alignment inside the arena
+    Owned,         // other per-instance allocations
+    Shared         // shared with other instances (SharedSpectrumResources)
+};
+
+// Heap memory held by one processor instance, itemised.
+struct MemoryFootprint
+{
+    struct Entry
+    {
+        const char* name { nullptr };  // static text
+        size_t bytes { 0 };
+        MemoryFootprintKind kind { MemoryFootprintKind::Owned };
+    };
+
+    std::vector<Entry> entries;
+
+    // Everything this instance keeps alive on its own; shared entries excluded.
+    size_t getInstanceBytes() const noexcept
+    {
+        size_t total = 0;
+        for (const Entry& entry : this->entries)
+        {
+            total += entry.kind == MemoryFootprintKind::Shared ? 0 : entry.bytes;
+        }
+        return total;
+    }
+};
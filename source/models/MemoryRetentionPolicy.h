@@ -0,0 +1,16 @@
+#pragma once
+
+// What releaseResources gives back to the system. Hosts suspend and resume
+// plugins on every transport stop, offline bounce or device change, so by
+// default buffers survive release and the next prepareToPlay only rebuilds
+// what the new configuration invalidates.
+enum class MemoryRetentionPolicy
+{
+    RetainBuffers = 0,  // keep buffers, filters and shared resources; release only clears state
+    // Free the analysis arena, FFT plan, conversion and loudness frame buffers
+    // and drop the shared window and band layouts; the next prepare rebuilds
+    // them. The spectrum and pipeline frame exchanges stay allocated because
+    // the editor may read them while the processor is released, and capture
+    // rings belong to their capture sessions.
+    ReleaseAll
+};
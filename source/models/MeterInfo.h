@@ -1,7 +1,11 @@
 #pragma once
 
+struct LoudnessReading;
+
 struct MeterInfo
 {
-    float* levelPtr { nullptr };   // Pointer to value owned by the editor (displayTotal/Low/Mid/High)
+    float* levelPtr { nullptr };   // Pointer to value owned by the editor (total, then one per band)
     const char* label { nullptr }; // Static label text
+    float* rmsPtr { nullptr };     // Integrated RMS of the same signal, also editor-owned; optional
+    const LoudnessReading* loudnessPtr { nullptr }; // BS.1770 loudness of the same signal; optional
 };
\ No newline at end of file
@@ -19,8 +19,8 @@ struct MeterLayoutMetrics
         return static_cast<int>(this->meterGap);
     }
 
-    int computeTotalGroupWidth() const noexcept
+    int computeTotalGroupWidth(int numMeters) const noexcept
     {
-        return this->firstMeterGutter() + this->meterColumnWidth() * 4 + this->gapBetweenMeters() * 3;
+        return this->firstMeterGutter() + this->meterColumnWidth() * numMeters + this->gapBetweenMeters() * (numMeters - 1);
     }
 };
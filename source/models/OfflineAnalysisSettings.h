@@ -0,0 +1,21 @@
+#pragma once
+
+#include "BandFrequencies.h"
+
+// Settings for offline spectrum/band analysis; defaults match the processor.
+struct OfflineAnalysisSettings
+{
+    int fftOrder { 11 };            // analysis frame (and hop) = 2^fftOrder samples
+    int numBands { 96 };
+    float specSmoothing { 0.2f };   // per-bin one-pole power smoothing
+    float guardPercent { 0.06f };   // share of the half spectrum guarded below Nyquist
+    float taperPercent { 0.02f };   // share of the half spectrum for the cosine taper
+    bool freqSmoothEnabled { true };
+    bool bandSmoothEnabled { true };
+    CrossoverFrequencies crossover;  // metering crossovers, constrained to the file's rate
+
+    // Chunking for parallel runs. Each chunk first analyses overlapFrames of
+    // warm-up (discarded) so filter and smoothing state has settled at its start.
+    int chunkFrames { 1024 };       // ~44 s at 48 kHz with 2048-sample frames
+    int overlapFrames { 64 };       // smoothing residue 0.8^64 ~ 6e-7
+};
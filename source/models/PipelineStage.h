@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+
+// Stages of the spectrum pipeline in processing order. Each stage maps to one
+// bit of a capture mask (see PipelineCapture).
+enum class PipelineStage : int
+{
+    RawPower = 0,    // per-bin linear power of the current FFT frame
+    PerBinSmoothed,  // after per-bin one-pole power smoothing (before guard zeroing)
+    FreqSmoothed,    // after triangular frequency-domain smoothing
+    Tapered,         // after the cosine taper and zeroing above the allowed end
+    Aggregated,      // log-spaced bands [0..1] before band smoothing
+    BandSmoothed     // final bands as published to the UI
+};
+
+constexpr int numPipelineStages = 6;
+
+constexpr uint32_t pipelineStageBit(PipelineStage stage) noexcept
+{
+    return 1u << static_cast<int>(stage);
+}
+
+constexpr uint32_t allPipelineStages = (1u << numPipelineStages) - 1u;
+
+constexpr bool isPerBinStage(PipelineStage stage) noexcept
+{
+    return stage < PipelineStage::Aggregated;
+}
+
+constexpr const char* pipelineStageName(PipelineStage stage) noexcept
+{
+    switch (stage)
+    {
+        case PipelineStage::RawPower:       return "rawPower";
+        case PipelineStage::PerBinSmoothed: return "perBinSmoothed";
+        case PipelineStage::FreqSmoothed:   return "freqSmoothed";
+        case PipelineStage::Tapered:        return "tapered";
+        case PipelineStage::Aggregated:     return "aggregated";
+        case PipelineStage::BandSmoothed:   return "bandSmoothed";
+    }
+    return "unknown";
+}
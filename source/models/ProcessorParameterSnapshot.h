@@ -0,0 +1,19 @@
+#pragma once
+
+#include "BandFrequencies.h"
+#include "SoloMode.h"
+
+// Every user-settable processor control at one point in time. Taken on the
+// audio thread for spike bundles and re-applied before each replayed block.
+struct ProcessorParameterSnapshot
+{
+    SoloMode soloMode { SoloMode::None };
+    bool testEnabled { false };
+    int testType { 0 };
+    bool freqSmoothEnabled { true };
+    bool bandSmoothEnabled { true };
+    float guardPercent { 0.06f };
+    float taperPercent { 0.02f };
+    float specSmoothing { 0.2f };
+    CrossoverFrequencies crossover;   // parameter values, before any glide
+};
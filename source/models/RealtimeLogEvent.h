@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+
+enum class RealtimeLogEventType
+{
+    Xrun,                 // valueA = callback ms, valueB = budget ms, count = numSamples
+    SampleRateChange,     // valueA = old rate, valueB = new rate
+    ChannelLayoutChange,  // valueA = old channel count, count = new channel count
+    OversizedBlock        // valueA = prepared block size, count = numSamples
+};
+
+// Fixed-format event posted from the audio thread; trivially copyable so it
+// can be queued without allocation and formatted later on the log thread.
+struct RealtimeLogEvent
+{
+    RealtimeLogEventType type { RealtimeLogEventType::Xrun };
+    int64_t ticks { 0 };    // Time::getHighResolutionTicks() when posted
+    double valueA { 0.0 };
+    double valueB { 0.0 };
+    int32_t count { 0 };
+
+    static RealtimeLogEvent xrun(double callbackMs, double budgetMs, int numSamples) noexcept
+    {
+        return { RealtimeLogEventType::Xrun, 0, callbackMs, budgetMs, numSamples };
+    }
+
+    static RealtimeLogEvent sampleRateChange(double oldRate, double newRate) noexcept
+    {
+        return { RealtimeLogEventType::SampleRateChange, 0, oldRate, newRate, 0 };
+    }
+
+    static RealtimeLogEvent channelLayoutChange(int oldChannels, int newChannels) noexcept
+    {
+        return { RealtimeLogEventType::ChannelLayoutChange, 0, static_cast<double>(oldChannels), 0.0, newChannels };
+    }
+
+    static RealtimeLogEvent oversizedBlock(int numSamples, int preparedBlockSize) noexcept
+    {
+        return { RealtimeLogEventType::OversizedBlock, 0, static_cast<double>(preparedBlockSize), 0.0, numSamples };
+    }
+};
@@ -1,10 +1,30 @@
 #ifndef TRINITY_SOLOMODE_H
 #define TRINITY_SOLOMODE_H
+// Crossover band played alone, counted from the lowest; None plays the band
+// sum. Bands above the active band count also play the sum.
 enum class SoloMode
 {
     None = 0,
-    Low,
-    Mid,
-    High
+    Band1,
+    Band2,
+    Band3,
+    Band4,
+    Band5,
+    Band6,
+    Band7,
+    Band8
 };
-#endif //TRINITY_SOLOMODE_H
\ No newline at end of file
+
+constexpr int maxSoloBands = static_cast<int>(SoloMode::Band8);
+
+// Zero-based band index to solo mode and back (-1 for None)
+constexpr SoloMode soloModeForBand(int band) noexcept
+{
+    return band >= 0 && band < maxSoloBands ? static_cast<SoloMode>(band + 1) : SoloMode::None;
+}
+
+constexpr int getSoloBand(SoloMode mode) noexcept
+{
+    return static_cast<int>(mode) - 1;
+}
+#endif //TRINITY_SOLOMODE_H
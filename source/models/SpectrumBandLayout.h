@@ -0,0 +1,19 @@
+#pragma once
+
+#include <vector>
+
+// Log-spaced band layout for one analysis configuration. Built once by
+// SharedSpectrumResources and never modified afterwards, so any number of
+// processors (and their audio threads) may read the same instance.
+struct SpectrumBandLayout
+{
+    double sampleRate { 0.0 };
+    int fftSize { 0 };
+    int hiGuardBins { 0 };                 // highest bins ignored near Nyquist
+    int numBands { 0 };
+    double displayMaxHz { 20000.0 };       // upper frequency actually displayed (post-guard)
+    std::vector<double> bandF0Hz;          // per band start frequency (Hz)
+    std::vector<double> bandF1Hz;          // per band end frequency (Hz)
+    std::vector<int> bandBinStart;         // per band [inclusive] (legacy/diagnostic)
+    std::vector<int> bandBinEnd;           // per band [inclusive] (legacy/diagnostic)
+};
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+
+// Read-only view of one published analysis frame (normalised band magnitudes).
+// Owned by SpectrumFrameExchange; valid until the consumer's next acquire.
+struct SpectrumFrameView
+{
+    const float* values { nullptr };
+    int numValues { 0 };
+    uint64_t sequence { 0 }; // 1 for the first published frame, 0 when nothing was published yet
+
+    bool isEmpty() const noexcept
+    {
+        return this->values == nullptr || this->numValues <= 0 || this->sequence == 0;
+    }
+
+    // Analysis frames published after previousSequence that this view skipped over.
+    uint64_t framesMissedSince(uint64_t previousSequence) const noexcept
+    {
+        if (previousSequence == 0 || this->sequence <= previousSequence + 1)
+        {
+            return 0;
+        }
+        return this->sequence - previousSequence - 1;
+    }
+};
@@ -12,7 +12,12 @@ enum TestSignalType
     kSine19k = 2,
     kWhiteNoise = 3,
     kPinkNoise = 4,
-    kLogSweep = 5
+    kLogSweep = 5,
+    // Measurement signals, each with an analysis in MeasurementAnalysis
+    kMultitone = 6,
+    kImpulse = 7,
+    kMls = 8,
+    kSyncSweep = 9
 };
 
 #endif //TRINITY_TESTSIGNALTYPE_H
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+
+// Traced sections of the audio callback, in processing order. ProcessBlock
+// spans the whole callback; the others nest inside it (see TraceRecorder).
+enum class TraceStage : int
+{
+    ProcessBlock = 0,
+    TestSignal,      // built-in test signal generation
+    PeakScan,        // total peak over all channels
+    Crossover,       // LR crossover, band peaks and solo mix
+    MonoAccumulate,  // mono mixdown, DC removal and FIFO fill
+    WindowFft,       // windowing and forward FFT of one frame
+    PowerSmoothing,  // per-bin power and one-pole smoothing
+    FreqSmoothing,   // guard zeroing and triangular frequency smoothing
+    Taper,           // cosine taper and zeroing above the allowed end
+    Aggregation,     // fractional log-band aggregation
+    BandSmoothing,   // band-domain smoothing
+    Publish          // UI hand-off and debug record
+};
+
+constexpr int numTraceStages = 12;
+
+constexpr const char* traceStageName(TraceStage stage) noexcept
+{
+    switch (stage)
+    {
+        case TraceStage::ProcessBlock:   return "processBlock";
+        case TraceStage::TestSignal:     return "testSignal";
+        case TraceStage::PeakScan:       return "peakScan";
+        case TraceStage::Crossover:      return "crossover";
+        case TraceStage::MonoAccumulate: return "monoAccumulate";
+        case TraceStage::WindowFft:      return "windowFft";
+        case TraceStage::PowerSmoothing: return "powerSmoothing";
+        case TraceStage::FreqSmoothing:  return "freqSmoothing";
+        case TraceStage::Taper:          return "taper";
+        case TraceStage::Aggregation:    return "aggregation";
+        case TraceStage::BandSmoothing:  return "bandSmoothing";
+        case TraceStage::Publish:        return "publish";
+    }
+    return "unknown";
+}
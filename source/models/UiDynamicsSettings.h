@@ -2,12 +2,12 @@
 
 struct UiDynamicsSettings
 {
-    // Magnitude smoothing
-    float attackCoeff { 0.35f };  // faster rise
-    float releaseCoeff { 0.08f }; // slower fall
+    // Magnitude smoothing time constants (ms), independent of frame rate
+    float attackMs { 77.0f };   // faster rise
+    float releaseMs { 400.0f }; // slower fall
 
-    // Peak-hold behaviour
-    float peakHoldDecay { 0.97f }; // per update decay
+    // Peak-hold behaviour: time constant of the multiplicative peak decay (ms)
+    float peakHoldReleaseMs { 1100.0f };
 
     // Feature toggles
     bool smoothingEnabled { true };
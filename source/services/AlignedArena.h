@@ -0,0 +1,124 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <span>
+#include <vector>
+
+// Service: one cache-line aligned allocation carved into named float regions.
+// Regions are planned with addRegion() and laid out by allocate(): hot
+// regions first, then cold ones, each starting on its own 64-byte line so
+// state touched every block never shares a line with per-frame scratch.
+// The block is only reallocated when a plan outgrows it, so preparing again
+// with the same sizes reuses the memory. Not thread-safe; plan and allocate
+// while the audio thread is stopped.
+class AlignedArena
+{
+public:
+    static constexpr size_t alignment = 64;
+
+    enum class Heat
+    {
+        Hot,   // touched on every block
+        Cold   // touched once per analysis frame or less
+    };
+
+    struct Region
+    {
+        const char* name { nullptr };
+        size_t numFloats { 0 };
+        Heat heat { Heat::Cold };
+        size_t offsetBytes { 0 };
+    };
+
+    // Starts a new plan; regions handed out before stay valid until allocate().
+    void beginPlan()
+    {
+        this->regions.clear();
+    }
+
+    // Index for region(); stable for the same sequence of calls.
+    int addRegion(const char* name, size_t numFloats, Heat heat)
+    {
+        this->regions.push_back({ name, numFloats, heat, 0 });
+        return static_cast<int>(this->regions.size()) - 1;
+    }
+
+    // Lays out the plan and zeroes every region.
+    void allocate()
+    {
+        size_t offset = 0;
+        for (const Heat heat : { Heat::Hot, Heat::Cold })
+        {
+            for (Region& region : this->regions)
+            {
+                if (region.heat == heat)
+                {
+                    region.offsetBytes = offset;
+                    offset += roundUpToLine(region.numFloats * sizeof(float));
+                }
+            }
+        }
+        this->bytesUsed = offset;
+        if (this->bytesUsed > this->bytesReserved)
+        {
+            this->block.reset(static_cast<std::byte*>(::operator new(this->bytesUsed, std::align_val_t(alignment))));
+            this->bytesReserved = this->bytesUsed;
+        }
+        if (this->bytesUsed > 0)
+        {
+            std::memset(this->block.get(), 0, this->bytesUsed);
+        }
+    }
+
+    // Frees the block; regions must not be used until the next allocate().
+    void release()
+    {
+        this->block.reset();
+        this->bytesReserved = 0;
+        this->bytesUsed = 0;
+    }
+
+    std::span<float> region(int index) noexcept
+    {
+        const Region& region = this->regions[static_cast<size_t>(index)];
+        return { reinterpret_cast<float*>(this->block.get() + region.offsetBytes), region.numFloats };
+    }
+
+    const std::vector<Region>& getRegions() const noexcept
+    {
+        return this->regions;
+    }
+
+    // Bytes covered by the current plan, including alignment padding.
+    size_t getBytesUsed() const noexcept
+    {
+        return this->bytesUsed;
+    }
+
+    size_t getBytesReserved() const noexcept
+    {
+        return this->bytesReserved;
+    }
+
+    static constexpr size_t roundUpToLine(size_t bytes) noexcept
+    {
+        return (bytes + alignment - 1) / alignment * alignment;
+    }
+
+private:
+    struct AlignedDelete
+    {
+        void operator()(std::byte* pointer) const noexcept
+        {
+            ::operator delete(pointer, std::align_val_t(alignment));
+        }
+    };
+
+    std::vector<Region> regions;
+    std::unique_ptr<std::byte, AlignedDelete> block;
+    size_t bytesUsed { 0 };
+    size_t bytesReserved { 0 };
+};
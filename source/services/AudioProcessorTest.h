@@ -2,8 +2,19 @@
 
 #include <JuceHeader.h>
 #include <atomic>
+#include <cmath>
+#include "models/MeasurementSettings.h"
 #include "models/TestSignalType.h"
-
+#include "MeasurementSignals.h"
+#include "XorshiftNoise.h"
+
+// Built-in test signals. Each block is rendered once into channel 0 and
+// copied to the other channels. Tones rotate a phasor, both sweeps use
+// ExponentialChirp, and noise comes from XorshiftNoise, so no signal calls
+// sin, pow or a shared Random per sample. With the same seed and sample rate
+// the output is bit-identical across runs.
+// The measurement signals loop the exact periods MeasurementAnalysis expects
+// for default MeasurementSettings up to displayMaxHz.
 class AudioTestProcessor
 {
 public:
@@ -12,11 +23,20 @@ public:
     {
         this->sampleRateHz = sampleRate > 0.0 ? sampleRate : 44100.0;
         this->displayMaxHz = displayMaxHz;
-        this->testPhase = 0.0f;
-        this->sweepPhase = 0.0f;
-        this->sweepSampleCount = 0;
+        this->tonePhasorRe = 1.0;
+        this->tonePhasorIm = 0.0;
+        this->toneSamplesSinceNormalise = 0;
         this->sweepTotalSamples = static_cast<long long>(this->sampleRateHz * 10.0); // 10-second sweep
-        this->pinkZ1 = 0.0f;
+        this->restartSweep();
+        this->noise.reseed(this->seed.load());
+        this->pinkFilter.reset();
+
+        MeasurementSettings measurement;
+        measurement.endHz = this->displayMaxHz > measurement.startHz ? this->displayMaxHz : measurement.endHz;
+        this->syncSweep.prepare(this->sampleRateHz, measurement);
+        this->sequence.prepare(measurement.mlsOrder);
+        this->multitone.prepare(this->sampleRateHz, measurement);
+        this->impulses.prepare(measurement.responseLength);
     }
 
     void setEnabled(bool enabled) noexcept
@@ -37,110 +57,154 @@ public:
         return this->type.load();
     }
 
+    // Noise seed, applied by the next prepare().
+    void setSeed(uint32 newSeed) noexcept
+    {
+        this->seed.store(newSeed);
+    }
+    uint32 getSeed() const noexcept
+    {
+        return this->seed.load();
+    }
+
     void generate(AudioBuffer<float>& buffer)
     {
         const int numSamples = buffer.getNumSamples();
+        const int numChannels = buffer.getNumChannels();
+        if (numSamples <= 0 || numChannels <= 0)
+        {
+            return;
+        }
         const float amplitude = 0.25f;
         const int selectedType = this->type.load();
+        float* firstChannel = buffer.getWritePointer(0);
 
         switch (selectedType)
         {
             case kSine17k:
             case kSine19k:
-                handleSine(buffer, numSamples, amplitude, selectedType);
+                renderSine(firstChannel, numSamples, amplitude, selectedType);
                 break;
             case kWhiteNoise:
-                handleWhiteNoise(buffer, numSamples, amplitude);
+                this->noise.fill(firstChannel, numSamples, amplitude);
                 break;
             case kPinkNoise:
-                handlePinkNoise(buffer, numSamples, amplitude);
+                this->noise.fill(firstChannel, numSamples, amplitude);
+                this->pinkFilter.process(firstChannel, numSamples);
                 break;
             case kLogSweep:
-                handleSweep(buffer, numSamples, amplitude);
+                renderSweep(firstChannel, numSamples, amplitude);
+                break;
+            case kMultitone:
+                this->multitone.render(firstChannel, numSamples, amplitude);
+                break;
+            case kImpulse:
+                this->impulses.render(firstChannel, numSamples, amplitude);
+                break;
+            case kMls:
+                this->sequence.render(firstChannel, numSamples, amplitude);
+                break;
+            case kSyncSweep:
+                this->syncSweep.render(firstChannel, numSamples, amplitude);
                 break;
             default:
-                break; // kOff or unknown: keep incoming audio
+                return; // kOff or unknown: keep incoming audio
         }
-    }
 
-private:
-    static void writeSampleToAllChannels(AudioBuffer<float>& buffer, int sampleIndex, float value) noexcept
-    {
-        const int channels = buffer.getNumChannels();
-        for (int channel = 0; channel < channels; ++channel) {
-            buffer.getWritePointer(channel)[sampleIndex] = value;
+        for (int channel = 1; channel < numChannels; ++channel)
+        {
+            FloatVectorOperations::copy(buffer.getWritePointer(channel), firstChannel, numSamples);
         }
     }
 
-    void handleSine(AudioBuffer<float>& buffer, int numSamples, float amplitude, int selectedType)
+private:
+    // Rotates a unit phasor by a fixed angle per sample; the sine is its
+    // imaginary part. Renormalised on a fixed sample count (not per block,
+    // which would make the output depend on block sizes) so rounding cannot drift.
+    void renderSine(float* destination, int numSamples, float amplitude, int selectedType) noexcept
     {
+        constexpr int samplesPerNormalise = 1024;
         const double frequencyHz = selectedType == kSine17k ? 17000.0 : 19000.0;
-        const float phaseIncrement = MathConstants<float>::twoPi * static_cast<float>(frequencyHz / this->sampleRateHz);
+        const double phaseIncrement = MathConstants<double>::twoPi * frequencyHz / this->sampleRateHz;
+        const double rotationRe = std::cos(phaseIncrement);
+        const double rotationIm = std::sin(phaseIncrement);
+        double re = this->tonePhasorRe;
+        double im = this->tonePhasorIm;
         for (int i = 0; i < numSamples; ++i)
         {
-            const float sample = std::sin(this->testPhase) * amplitude;
-            this->testPhase += phaseIncrement;
-            if (this->testPhase > MathConstants<float>::twoPi)
-                this->testPhase -= MathConstants<float>::twoPi;
-            writeSampleToAllChannels(buffer, i, sample);
+            destination[i] = static_cast<float>(im) * amplitude;
+            const double nextRe = re * rotationRe - im * rotationIm;
+            im = re * rotationIm + im * rotationRe;
+            re = nextRe;
+            if (++this->toneSamplesSinceNormalise == samplesPerNormalise)
+            {
+                const double correction = 1.5 - 0.5 * (re * re + im * im);
+                re *= correction;
+                im *= correction;
+                this->toneSamplesSinceNormalise = 0;
+            }
         }
+        this->tonePhasorRe = re;
+        this->tonePhasorIm = im;
     }
 
-    void handleWhiteNoise(AudioBuffer<float>& buffer, int numSamples, float amplitude)
+    // Exponential sweep: the per-sample phase increment grows by a constant
+    // ratio g = (end / start)^(1 / length), rendered by ExponentialChirp.
+    // Sample n of a sweep has phase origin + startIncrement (g^(n + 1) - 1) / (g - 1).
+    void renderSweep(float* destination, int numSamples, float amplitude) noexcept
     {
         for (int i = 0; i < numSamples; ++i)
         {
-            const float sample = (this->rng.nextFloat() * 2.0f - 1.0f) * amplitude;
-            writeSampleToAllChannels(buffer, i, sample);
+            destination[i] = static_cast<float>(this->sweepChirp.next()) * amplitude;
+            if (this->sweepChirp.getPosition() >= this->sweepTotalSamples)
+            {
+                // The next sweep starts low again, continuing the phase
+                this->startSweepFrom(std::fmod(this->sweepChirp.phaseAt(this->sweepChirp.getPosition() - 1),
+                                               MathConstants<double>::twoPi));
+            }
         }
     }
 
-    void handlePinkNoise(AudioBuffer<float>& buffer, int numSamples, float amplitude)
+    void restartSweep() noexcept
     {
-        for (int i = 0; i < numSamples; ++i)
-        {
-            const float white = (this->rng.nextFloat() * 2.0f - 1.0f) * amplitude;
-            // crude pink-ish: low-pass the white slightly
-            this->pinkZ1 = this->pinkZ1 + this->pinkCoeff * (white - this->pinkZ1);
-            writeSampleToAllChannels(buffer, i, this->pinkZ1);
-        }
+        const double sweepStartHz = 20.0;
+        const double sweepEndHz = this->displayMaxHz > sweepStartHz ? this->displayMaxHz : this->sampleRateHz * 0.5 * 0.97;
+        this->sweepStartIncrement = MathConstants<double>::twoPi * sweepStartHz / this->sampleRateHz;
+        this->sweepLogGrowth = this->sweepTotalSamples > 0
+                                 ? std::log(sweepEndHz / sweepStartHz) / static_cast<double>(this->sweepTotalSamples)
+                                 : 0.0;
+        this->startSweepFrom(0.0);
     }
 
-    void handleSweep(AudioBuffer<float>& buffer, int numSamples, float amplitude)
+    void startSweepFrom(double phaseOrigin) noexcept
     {
-        const double sweepStartHz = 20.0;
-        const double sweepEndHz = this->displayMaxHz > sweepStartHz ? this->displayMaxHz : this->sampleRateHz * 0.5 * 0.97;
-        const double sweepDurationSeconds = this->sweepTotalSamples > 0 ? static_cast<double>(this->sweepTotalSamples) / this->sampleRateHz : 10.0;
-        for (int i = 0; i < numSamples; ++i)
-        {
-            const double timeSeconds = static_cast<double>(this->sweepSampleCount) / this->sampleRateHz;
-            const double sweepRatio = std::pow(sweepEndHz / sweepStartHz, 1.0 / sweepDurationSeconds);
-            const double instantFreqHz = sweepStartHz * std::pow(sweepRatio, timeSeconds);
-            const float phaseIncrement = MathConstants<float>::twoPi * static_cast<float>(instantFreqHz / this->sampleRateHz);
-            this->sweepPhase += phaseIncrement;
-            if (this->sweepPhase > MathConstants<float>::twoPi) {
-                this->sweepPhase -= MathConstants<float>::twoPi;
-            }
-            const float sample = std::sin(this->sweepPhase) * amplitude;
-            writeSampleToAllChannels(buffer, i, sample);
-            ++this->sweepSampleCount;
-            if (this->sweepSampleCount >= this->sweepTotalSamples)
-                this->sweepSampleCount = 0;
-        }
+        const double phaseScale = this->sweepLogGrowth > 0.0
+                                    ? this->sweepStartIncrement * std::exp(this->sweepLogGrowth) / std::expm1(this->sweepLogGrowth)
+                                    : 0.0;
+        this->sweepChirp.start(phaseOrigin + this->sweepStartIncrement, phaseScale, this->sweepLogGrowth);
     }
 
 private:
     std::atomic<bool> enabled { false };
     std::atomic<int> type { kOff };
+    std::atomic<uint32> seed { XorshiftNoise::defaultSeed };
 
-    float testPhase { 0.0f };
-    float sweepPhase { 0.0f };
-    long long sweepSampleCount { 0 };
+    double tonePhasorRe { 1.0 };
+    double tonePhasorIm { 0.0 };
+    int toneSamplesSinceNormalise { 0 };
+
+    double sweepStartIncrement { 0.0 };  // radians per sample at the start
+    double sweepLogGrowth { 0.0 };       // log of the per-sample increment ratio
     long long sweepTotalSamples { 0 };
+    ExponentialChirp sweepChirp;
+
+    XorshiftNoise noise;
+    KelletPinkFilter pinkFilter;
 
-    Random rng;
-    float pinkZ1 { 0.0f };
-    float pinkCoeff { 0.02f };
+    SyncSweep syncSweep;
+    MaximumLengthSequence sequence;
+    Multitone multitone;
+    ImpulseTrain impulses;
 
     double sampleRateHz { 44100.0 };
     double displayMaxHz { 20000.0 };
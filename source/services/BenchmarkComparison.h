@@ -0,0 +1,153 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <vector>
+
+// Outcome of comparing one benchmark between a baseline and a current run.
+struct BenchmarkVerdict
+{
+    String name;
+    double baselineMedianNs { 0.0 };
+    double currentMedianNs { 0.0 };
+    double ratio { 1.0 };        // current / baseline median
+    double pSlower { 1.0 };      // one-sided Mann-Whitney p that current is slower
+    double pFaster { 1.0 };      // one-sided Mann-Whitney p that current is faster
+    bool regressed { false };
+    bool improved { false };
+};
+
+// Service: statistics behind the performance regression gate.
+// Reads Google Benchmark JSON (per-repetition entries) and decides per
+// benchmark whether the current run is slower than the baseline. A benchmark
+// regresses only when the slowdown is both significant (Mann-Whitney U,
+// one-sided, normal approximation with tie correction) and larger than the
+// relative threshold, so noise on a busy machine does not fail the gate.
+struct BenchmarkComparison
+{
+    using RunTimes = std::map<String, std::vector<double>>;
+
+    // Per-repetition CPU times in nanoseconds keyed by run name. Aggregate
+    // rows (mean, median, stddev) are skipped; a run without repetitions
+    // contributes a single sample.
+    static RunTimes loadRunTimes(const var& json)
+    {
+        RunTimes times;
+        const var benchmarks = json["benchmarks"];
+        if (!benchmarks.isArray())
+        {
+            return times;
+        }
+        for (const var& entry : *benchmarks.getArray())
+        {
+            if (entry.getProperty("run_type", "iteration").toString() != "iteration")
+            {
+                continue;
+            }
+            if (entry.hasProperty("error_occurred") && static_cast<bool>(entry["error_occurred"]))
+            {
+                continue;
+            }
+            const String name = entry.getProperty("run_name", entry["name"]).toString();
+            const double cpuTime = static_cast<double>(entry["cpu_time"]);
+            times[name].push_back(cpuTime * nanosecondsPer(entry.getProperty("time_unit", "ns").toString()));
+        }
+        return times;
+    }
+
+    static double nanosecondsPer(const String& timeUnit) noexcept
+    {
+        if (timeUnit == "us") return 1.0e3;
+        if (timeUnit == "ms") return 1.0e6;
+        if (timeUnit == "s")  return 1.0e9;
+        return 1.0;
+    }
+
+    static double median(std::vector<double> values)
+    {
+        if (values.empty())
+        {
+            return 0.0;
+        }
+        std::sort(values.begin(), values.end());
+        const size_t middle = values.size() / 2;
+        return (values.size() % 2 == 1) ? values[middle] : 0.5 * (values[middle - 1] + values[middle]);
+    }
+
+    // One-sided Mann-Whitney U: p-value for "current tends to be larger than
+    // baseline". Swap the arguments for the opposite direction.
+    static double mannWhitneyGreater(const std::vector<double>& baseline,
+                                     const std::vector<double>& current)
+    {
+        const size_t baselineCount = baseline.size();
+        const size_t currentCount = current.size();
+        if (baselineCount == 0 || currentCount == 0)
+        {
+            return 1.0;
+        }
+
+        // Pool and rank, averaging ranks over ties
+        std::vector<std::pair<double, bool>> pooled;  // value, fromCurrent
+        pooled.reserve(baselineCount + currentCount);
+        for (double value : baseline) pooled.emplace_back(value, false);
+        for (double value : current)  pooled.emplace_back(value, true);
+        std::sort(pooled.begin(), pooled.end(),
+                  [] (const auto& a, const auto& b) { return a.first < b.first; });
+
+        const double total = static_cast<double>(pooled.size());
+        double currentRankSum = 0.0;
+        double tieTerm = 0.0;
+        for (size_t first = 0; first < pooled.size();)
+        {
+            size_t last = first + 1;
+            while (last < pooled.size() && pooled[last].first == pooled[first].first)
+            {
+                ++last;
+            }
+            const double tiedCount = static_cast<double>(last - first);
+            const double averageRank = 0.5 * static_cast<double>(first + 1 + last);
+            for (size_t index = first; index < last; ++index)
+            {
+                if (pooled[index].second)
+                {
+                    currentRankSum += averageRank;
+                }
+            }
+            tieTerm += tiedCount * tiedCount * tiedCount - tiedCount;
+            first = last;
+        }
+
+        const double n1 = static_cast<double>(baselineCount);
+        const double n2 = static_cast<double>(currentCount);
+        const double uCurrent = currentRankSum - n2 * (n2 + 1.0) * 0.5;
+        const double meanU = n1 * n2 * 0.5;
+        const double varianceU = n1 * n2 / 12.0 * ((total + 1.0) - tieTerm / (total * (total - 1.0)));
+        if (varianceU <= 0.0)
+        {
+            return 1.0;  // every sample identical
+        }
+        // Continuity correction towards the mean
+        const double z = (uCurrent - meanU - 0.5) / std::sqrt(varianceU);
+        return 0.5 * std::erfc(z / std::sqrt(2.0));
+    }
+
+    static BenchmarkVerdict compare(const String& name,
+                                    const std::vector<double>& baseline,
+                                    const std::vector<double>& current,
+                                    double threshold,
+                                    double alpha)
+    {
+        BenchmarkVerdict verdict;
+        verdict.name = name;
+        verdict.baselineMedianNs = median(baseline);
+        verdict.currentMedianNs = median(current);
+        verdict.ratio = verdict.baselineMedianNs > 0.0 ? verdict.currentMedianNs / verdict.baselineMedianNs : 1.0;
+        verdict.pSlower = mannWhitneyGreater(baseline, current);
+        verdict.pFaster = mannWhitneyGreater(current, baseline);
+        verdict.regressed = verdict.pSlower < alpha && verdict.ratio > 1.0 + threshold;
+        verdict.improved = verdict.pFaster < alpha && verdict.ratio < 1.0 / (1.0 + threshold);
+        return verdict;
+    }
+};
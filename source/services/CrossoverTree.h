@@ -0,0 +1,242 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+#include "../models/BandFrequencies.h"
+
+// Service: N-band Linkwitz-Riley (LR4) crossover, 2 to 8 bands.
+//
+// The input is split at the lowest cutoff, the upper part again at the next
+// one, and so on. An LR4 low/high pair sums to the second-order allpass at its
+// cutoff, so every band split off below a cutoff also runs through that
+// allpass: all bands then share the same phase and the band sum is the
+// product of the allpasses, flat in magnitude.
+//
+// Filters are the TPT state-variable sections of dsp::LinkwitzRileyFilter. The
+// state of all stages, bands and channels lives in one contiguous block, and
+// each step runs the same coefficients over consecutive lanes (band-major,
+// then channel), so a stage's allpasses vectorise across bands and channels
+// together. prepare() allocates for maxBands; nothing else does.
+class CrossoverTree
+{
+public:
+    static constexpr int minBands = CrossoverFrequencies::minBands;
+    static constexpr int maxBands = CrossoverFrequencies::maxBands;
+
+    // What process() reports per band besides the output; null members are
+    // skipped. Band values are indexed from the lowest band.
+    struct BandTaps
+    {
+        float* peaks { nullptr };          // raised to each band's largest absolute sample
+        float* sumsOfSquares { nullptr };  // gains each band's squared samples, all channels
+        float* frames { nullptr };         // per sample: every band's value per channel, band-major
+        int frameStride { 0 };             // floats from one sample's frame to the next
+    };
+
+    void prepare(double sampleRate, int numChannels)
+    {
+        this->sampleRateHz = sampleRate > 0.0 ? sampleRate : 44100.0;
+        this->channels = jmax(1, numChannels);
+        const auto laneCount = static_cast<size_t>(maxBands * this->channels);
+        // Splits: four states per channel per stage. Allpasses: stage s
+        // compensates the s bands below it, two states per lane.
+        this->allpassStateStart = static_cast<size_t>(4 * (maxBands - 1) * this->channels);
+        const auto allpassStates = static_cast<size_t>((maxBands - 1) * (maxBands - 2) * this->channels);
+        this->state.assign(this->allpassStateStart + allpassStates, 0.0f);
+        this->lanes.assign(laneCount, 0.0f);
+        this->setCutoffs(CrossoverFrequencies {}.constrainedTo(this->sampleRateHz));
+    }
+
+    // Retunes every active stage (one tan each); state is kept, so cutoffs
+    // can glide. Switching the band count restarts the tree from silence.
+    void setCutoffs(const CrossoverFrequencies& frequencies) noexcept
+    {
+        const int newNumBands = jlimit(minBands, maxBands, frequencies.numBands);
+        if (newNumBands != this->numBands)
+        {
+            this->numBands = newNumBands;
+            this->reset();
+        }
+        for (int stage = 0; stage < this->numBands - 1; ++stage)
+        {
+            const double cutoffHz = jlimit(1.0, this->sampleRateHz * 0.49,
+                                           static_cast<double>(frequencies.cutoffsHz[static_cast<size_t>(stage)]));
+            const auto g = static_cast<float>(std::tan(MathConstants<double>::pi * cutoffHz / this->sampleRateHz));
+            Coefficients& coefficients = this->stages[static_cast<size_t>(stage)];
+            coefficients.g = g;
+            coefficients.damping = root2 + g;
+            coefficients.h = 1.0f / (1.0f + root2 * g + g * g);
+        }
+    }
+
+    void reset() noexcept
+    {
+        std::fill(this->state.begin(), this->state.end(), 0.0f);
+    }
+
+    int getNumBands() const noexcept
+    {
+        return this->numBands;
+    }
+
+    int getNumChannels() const noexcept
+    {
+        return this->channels;
+    }
+
+    size_t getStateBytes() const noexcept
+    {
+        return (this->state.capacity() + this->lanes.capacity()) * sizeof(float);
+    }
+
+    // Splits samples [startSample, startSample + numSamples) of numChannels
+    // channels (at most the prepared count; missing ones count as silence).
+    // output, when not null (it may alias input), receives soloBand or, for
+    // -1 or a band above the count, the band sum. Frames written to
+    // taps.frames hold getNumBands() x getNumChannels() values, the first
+    // one for startSample.
+    void process(const float* const* input, float* const* output, int numChannels, int startSample, int numSamples,
+                 int soloBand, const BandTaps& taps) noexcept
+    {
+        const int usedChannels = jmin(numChannels, this->channels);
+        const int channelStride = this->channels;
+        const int numStages = this->numBands - 1;
+        const bool playBand = isPositiveAndBelow(soloBand, this->numBands);
+        float* laneData = this->lanes.data();
+        if (usedChannels <= 0)
+        {
+            return;  // not prepared
+        }
+
+        for (int sampleIndex = startSample; sampleIndex < startSample + numSamples; ++sampleIndex)
+        {
+            // The residual above the previous cutoff sits in the lanes of the
+            // next band, so each split works in place
+            for (int channel = 0; channel < channelStride; ++channel)
+            {
+                laneData[channel] = channel < usedChannels ? input[channel][sampleIndex] : 0.0f;
+            }
+            float* allpassState = this->state.data() + this->allpassStateStart;
+            for (int stage = 0; stage < numStages; ++stage)
+            {
+                const Coefficients& coefficients = this->stages[static_cast<size_t>(stage)];
+                const int compensatedLanes = stage * channelStride;
+                applyAllpass(coefficients, laneData, allpassState, allpassState + compensatedLanes, compensatedLanes);
+                allpassState += 2 * compensatedLanes;
+
+                float* splitState = this->state.data() + static_cast<size_t>(4 * stage * channelStride);
+                split(coefficients, laneData + compensatedLanes, laneData + compensatedLanes + channelStride,
+                      splitState, channelStride);
+            }
+
+            if (taps.frames != nullptr)
+            {
+                std::copy(laneData, laneData + this->numBands * channelStride,
+                          taps.frames + static_cast<ptrdiff_t>(sampleIndex - startSample) * taps.frameStride);
+            }
+            for (int band = 0; band < this->numBands; ++band)
+            {
+                const float* bandLanes = laneData + band * channelStride;
+                float peak = 0.0f;
+                float squares = 0.0f;
+                for (int channel = 0; channel < usedChannels; ++channel)
+                {
+                    peak = jmax(peak, std::abs(bandLanes[channel]));
+                    squares += bandLanes[channel] * bandLanes[channel];
+                }
+                if (taps.peaks != nullptr)
+                {
+                    taps.peaks[band] = jmax(taps.peaks[band], peak);
+                }
+                if (taps.sumsOfSquares != nullptr)
+                {
+                    taps.sumsOfSquares[band] += squares;
+                }
+            }
+            if (output == nullptr)
+            {
+                continue;
+            }
+            for (int channel = 0; channel < usedChannels; ++channel)
+            {
+                float outSample = 0.0f;
+                if (playBand)
+                {
+                    outSample = laneData[soloBand * channelStride + channel];
+                }
+                else
+                {
+                    for (int band = 0; band < this->numBands; ++band)
+                    {
+                        outSample += laneData[band * channelStride + channel];
+                    }
+                }
+                output[channel][sampleIndex] = outSample;
+            }
+        }
+    }
+
+private:
+    static constexpr float root2 = 1.41421356237f;
+
+    struct Coefficients
+    {
+        float g { 0.0f };        // tan(pi fc / fs)
+        float damping { 0.0f };  // root2 + g
+        float h { 1.0f };        // 1 / (1 + root2 g + g^2)
+    };
+
+    // Second-order allpass at the stage cutoff on numLanes lanes in place
+    static void applyAllpass(const Coefficients& coefficients, float* values, float* s1, float* s2, int numLanes) noexcept
+    {
+        const float g = coefficients.g;
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            const float yH = (values[lane] - coefficients.damping * s1[lane] - s2[lane]) * coefficients.h;
+            const float yB = g * yH + s1[lane];
+            s1[lane] = g * yH + yB;
+            const float yL = g * yB + s2[lane];
+            s2[lane] = g * yB + yL;
+            values[lane] = yL - root2 * yB + yH;
+        }
+    }
+
+    // LR4 split as in dsp::LinkwitzRileyFilter: low stays in values, high
+    // goes to highs. state holds s1..s4, numLanes each.
+    static void split(const Coefficients& coefficients, float* values, float* highs, float* state, int numLanes) noexcept
+    {
+        const float g = coefficients.g;
+        float* s1 = state;
+        float* s2 = state + numLanes;
+        float* s3 = state + 2 * numLanes;
+        float* s4 = state + 3 * numLanes;
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            const float yH = (values[lane] - coefficients.damping * s1[lane] - s2[lane]) * coefficients.h;
+            const float yB = g * yH + s1[lane];
+            s1[lane] = g * yH + yB;
+            const float yL = g * yB + s2[lane];
+            s2[lane] = g * yB + yL;
+
+            const float yH2 = (yL - coefficients.damping * s3[lane] - s4[lane]) * coefficients.h;
+            const float yB2 = g * yH2 + s3[lane];
+            s3[lane] = g * yH2 + yB2;
+            const float yL2 = g * yB2 + s4[lane];
+            s4[lane] = g * yB2 + yL2;
+
+            values[lane] = yL2;
+            highs[lane] = yL - root2 * yB + yH - yL2;
+        }
+    }
+
+    double sampleRateHz { 44100.0 };
+    int channels { 0 };
+    int numBands { 0 };
+    std::array<Coefficients, maxBands - 1> stages {};
+    std::vector<float> state;      // split states, then allpass states
+    size_t allpassStateStart { 0 };
+    std::vector<float> lanes;      // one frame: maxBands x channels
+};
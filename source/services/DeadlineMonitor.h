@@ -0,0 +1,164 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include "../models/DeadlineStats.h"
+#include "InstanceLog.h"
+
+// Service: per-callback deadline accounting for processBlock.
+// Each block's duration is compared with its budget, numSamples / sampleRate,
+// and counted into a log2 histogram of the load ratio together with the worst
+// case and the number of overruns. The audio thread is the only writer (plain
+// relaxed loads and stores, no read-modify-write); any thread may take a
+// snapshot. AudioProcessLoadMeasurer supplies the smoothed load figure.
+class DeadlineMonitor
+{
+public:
+    // Call from prepareToPlay, never concurrently with registerBlock.
+    void prepare(double newSampleRate, int maximumBlockSize)
+    {
+        this->sampleRate.store(newSampleRate > 0.0 ? newSampleRate : 0.0, std::memory_order_relaxed);
+        this->loadMeasurer.reset(newSampleRate, jmax(1, maximumBlockSize));
+        this->resetRequested.store(false, std::memory_order_relaxed);
+        this->clearCounters();
+    }
+
+    // Overruns are posted to this log as xrun events (wait-free); may be null.
+    void setOverrunLog(InstanceLog* log) noexcept
+    {
+        this->overrunLog = log;
+    }
+
+    // Audio thread: account one callback that took elapsedSeconds.
+    void registerBlock(double elapsedSeconds, int numSamples) noexcept
+    {
+        const double rate = this->sampleRate.load(std::memory_order_relaxed);
+        if (numSamples <= 0 || rate <= 0.0)
+        {
+            return;
+        }
+        if (this->resetRequested.exchange(false, std::memory_order_acquire))
+        {
+            this->clearCounters();
+        }
+
+        const double budgetSeconds = static_cast<double>(numSamples) / rate;
+        const double ratio = elapsedSeconds / budgetSeconds;
+
+        std::atomic<uint32_t>& bucket = this->histogram[static_cast<size_t>(DeadlineStats::bucketForRatio(ratio))];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        increment(this->blocks);
+        if (DeadlineStats::isOverrun(ratio))
+        {
+            increment(this->overruns);
+            if (this->overrunLog != nullptr)
+            {
+                this->overrunLog->post(RealtimeLogEvent::xrun(elapsedSeconds * 1000.0, budgetSeconds * 1000.0, numSamples));
+            }
+        }
+        if (ratio > this->worstRatio.load(std::memory_order_relaxed))
+        {
+            this->worstRatio.store(ratio, std::memory_order_relaxed);
+            this->worstSeconds.store(elapsedSeconds, std::memory_order_relaxed);
+            this->worstBlockSize.store(numSamples, std::memory_order_relaxed);
+        }
+        this->busySeconds.store(this->busySeconds.load(std::memory_order_relaxed) + elapsedSeconds,
+                                std::memory_order_relaxed);
+        this->audioSeconds.store(this->audioSeconds.load(std::memory_order_relaxed) + budgetSeconds,
+                                 std::memory_order_relaxed);
+
+        this->loadMeasurer.registerRenderTime(elapsedSeconds * 1000.0, numSamples);
+    }
+
+    // Any thread. Fields are read one by one, so a snapshot taken while the
+    // audio thread writes may mix adjacent blocks; fine for diagnostics.
+    DeadlineStats getStats() const noexcept
+    {
+        DeadlineStats stats;
+        stats.sampleRate = this->sampleRate.load(std::memory_order_relaxed);
+        if (this->resetRequested.load(std::memory_order_acquire))
+        {
+            return stats;
+        }
+        stats.blocks = this->blocks.load(std::memory_order_relaxed);
+        stats.overruns = this->overruns.load(std::memory_order_relaxed);
+        stats.worstRatio = this->worstRatio.load(std::memory_order_relaxed);
+        stats.worstMs = this->worstSeconds.load(std::memory_order_relaxed) * 1000.0;
+        stats.worstBlockSize = this->worstBlockSize.load(std::memory_order_relaxed);
+        const double audio = this->audioSeconds.load(std::memory_order_relaxed);
+        stats.averageLoad = audio > 0.0 ? this->busySeconds.load(std::memory_order_relaxed) / audio : 0.0;
+        stats.smoothedLoad = this->loadMeasurer.getLoadAsProportion();
+        for (int bucket = 0; bucket < DeadlineStats::numBuckets; ++bucket)
+        {
+            stats.histogram[static_cast<size_t>(bucket)] = this->histogram[static_cast<size_t>(bucket)].load(std::memory_order_relaxed);
+        }
+        return stats;
+    }
+
+    // Any thread. The audio thread clears the counters before its next block,
+    // so it stays the only writer; snapshots read as empty until then.
+    void requestReset() noexcept
+    {
+        this->resetRequested.store(true, std::memory_order_release);
+    }
+
+    // Times the enclosing scope as one callback of numSamples.
+    class ScopedMeasurement
+    {
+    public:
+        ScopedMeasurement(DeadlineMonitor& monitorToUse, int numSamplesInBlock) noexcept
+            : monitor(monitorToUse),
+              numSamples(numSamplesInBlock),
+              startTicks(Time::getHighResolutionTicks())
+        {
+        }
+
+        ~ScopedMeasurement()
+        {
+            const int64 elapsedTicks = Time::getHighResolutionTicks() - this->startTicks;
+            this->monitor.registerBlock(Time::highResolutionTicksToSeconds(elapsedTicks), this->numSamples);
+        }
+
+    private:
+        DeadlineMonitor& monitor;
+        int numSamples;
+        int64 startTicks;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedMeasurement)
+    };
+
+private:
+    static void increment(std::atomic<uint64_t>& counter) noexcept
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    void clearCounters() noexcept
+    {
+        for (std::atomic<uint32_t>& bucket : this->histogram)
+        {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        this->blocks.store(0, std::memory_order_relaxed);
+        this->overruns.store(0, std::memory_order_relaxed);
+        this->worstRatio.store(0.0, std::memory_order_relaxed);
+        this->worstSeconds.store(0.0, std::memory_order_relaxed);
+        this->worstBlockSize.store(0, std::memory_order_relaxed);
+        this->busySeconds.store(0.0, std::memory_order_relaxed);
+        this->audioSeconds.store(0.0, std::memory_order_relaxed);
+    }
+
+    std::atomic<double> sampleRate { 0.0 };
+    std::atomic<bool> resetRequested { false };
+    std::array<std::atomic<uint32_t>, DeadlineStats::numBuckets> histogram {};
+    std::atomic<uint64_t> blocks { 0 };
+    std::atomic<uint64_t> overruns { 0 };
+    std::atomic<double> worstRatio { 0.0 };
+    std::atomic<double> worstSeconds { 0.0 };
+    std::atomic<int> worstBlockSize { 0 };
+    std::atomic<double> busySeconds { 0.0 };
+    std::atomic<double> audioSeconds { 0.0 };
+    AudioProcessLoadMeasurer loadMeasurer;
+    InstanceLog* overrunLog { nullptr };
+};
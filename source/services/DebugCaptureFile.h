@@ -0,0 +1,197 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "../models/DebugFrameRecord.h"
+
+// Binary debug capture format and its offline CSV conversion.
+//
+// File layout (little-endian):
+//   header: "TRDC" magic, uint32 version, int32 maxTailBins, int32 maxBands
+//   record: int64 frameIndex, int32 hiGuardBins, int32 allowedEndBin,
+//           double allowedEndHz, double sampleRate, int32 fftSize,
+//           double displayMaxHz, then five arrays (tail pre-smooth,
+//           tail post-smooth, tail post-taper, bands pre-smooth, bands final),
+//           each as int32 count followed by count float32 values.
+// Only used values are written, so records stay compact.
+struct DebugCaptureFile
+{
+    static constexpr uint32 formatVersion = 1;
+    static constexpr const char* fileExtension = ".trcap";
+    static constexpr int64 fixedRecordBytes = 8 + 4 + 4 + 8 + 8 + 4 + 8;
+
+    static void writeHeader(OutputStream& stream)
+    {
+        stream.write("TRDC", 4);
+        stream.writeInt(static_cast<int>(formatVersion));
+        stream.writeInt(DebugFrameRecord::maxTailBins);
+        stream.writeInt(DebugFrameRecord::maxBands);
+    }
+
+    // Returns the file's format version, or 0 when the header is not valid.
+    static uint32 readHeader(InputStream& stream)
+    {
+        char magic[4] {};
+        if (stream.read(magic, 4) != 4 || std::memcmp(magic, "TRDC", 4) != 0)
+        {
+            return 0;
+        }
+        const auto version = static_cast<uint32>(stream.readInt());
+        const int maxTailBins = stream.readInt();
+        const int maxBands = stream.readInt();
+        if (version == 0 || version > formatVersion
+            || maxTailBins > DebugFrameRecord::maxTailBins || maxBands > DebugFrameRecord::maxBands)
+        {
+            return 0;
+        }
+        return version;
+    }
+
+    static void writeRecord(OutputStream& stream, const DebugFrameRecord& record)
+    {
+        stream.writeInt64(static_cast<int64>(record.frameIndex));
+        stream.writeInt(record.hiGuardBins);
+        stream.writeInt(record.allowedEndBin);
+        stream.writeDouble(record.allowedEndHz);
+        stream.writeDouble(record.sampleRate);
+        stream.writeInt(record.fftSize);
+        stream.writeDouble(record.displayMaxHz);
+        writeArray(stream, record.tailPreSmooth, record.numTailPreSmooth);
+        writeArray(stream, record.tailPostSmooth, record.numTailPostSmooth);
+        writeArray(stream, record.tailPostTaper, record.numTailPostTaper);
+        writeArray(stream, record.bandsPreSmooth, record.numBandsPreSmooth);
+        writeArray(stream, record.bandsFinal, record.numBandsFinal);
+    }
+
+    // Returns false at end of stream or on a malformed record.
+    static bool readRecord(InputStream& stream, DebugFrameRecord& record)
+    {
+        if (stream.getNumBytesRemaining() < fixedRecordBytes)
+        {
+            return false;
+        }
+        record.frameIndex = static_cast<uint64_t>(stream.readInt64());
+        record.hiGuardBins = stream.readInt();
+        record.allowedEndBin = stream.readInt();
+        record.allowedEndHz = stream.readDouble();
+        record.sampleRate = stream.readDouble();
+        record.fftSize = stream.readInt();
+        record.displayMaxHz = stream.readDouble();
+        return readArray(stream, record.tailPreSmooth, DebugFrameRecord::maxTailBins, record.numTailPreSmooth)
+            && readArray(stream, record.tailPostSmooth, DebugFrameRecord::maxTailBins, record.numTailPostSmooth)
+            && readArray(stream, record.tailPostTaper, DebugFrameRecord::maxTailBins, record.numTailPostTaper)
+            && readArray(stream, record.bandsPreSmooth, DebugFrameRecord::maxBands, record.numBandsPreSmooth)
+            && readArray(stream, record.bandsFinal, DebugFrameRecord::maxBands, record.numBandsFinal);
+    }
+
+    // ===== csvVersion=2 export (same columns as the former in-editor Debug CSV) =====
+
+    static String csvHeader(const DebugFrameRecord& record)
+    {
+        String header = "csvVersion=2\n";
+        header += "frame,hiGuard,allowedEndBin,allowedEndHz,sampleRate,fftSize,displayMaxHz";
+        appendColumnNames(header, "preSmoothTail", record.numTailPreSmooth);
+        appendColumnNames(header, "postSmoothTail", record.numTailPostSmooth);
+        appendColumnNames(header, "postTaperTail", record.numTailPostTaper);
+        appendColumnNames(header, "bandPre", record.numBandsPreSmooth);
+        appendColumnNames(header, "bandFinal", record.numBandsFinal);
+        header += "\n";
+        return header;
+    }
+
+    static String csvLine(const DebugFrameRecord& record)
+    {
+        String line;
+        line << static_cast<int64>(record.frameIndex) << "," << record.hiGuardBins << ","
+             << record.allowedEndBin << "," << record.allowedEndHz << "," << record.sampleRate << ","
+             << record.fftSize << "," << record.displayMaxHz;
+        appendValues(line, record.tailPreSmooth, record.numTailPreSmooth);
+        appendValues(line, record.tailPostSmooth, record.numTailPostSmooth);
+        appendValues(line, record.tailPostTaper, record.numTailPostTaper);
+        appendValues(line, record.bandsPreSmooth, record.numBandsPreSmooth);
+        appendValues(line, record.bandsFinal, record.numBandsFinal);
+        line << "\n";
+        return line;
+    }
+
+    // Convert a binary capture to csvVersion=2 CSV. Returns an empty string on
+    // success, otherwise a description of the problem.
+    static String convertToCsv(const File& captureFile, const File& csvFile)
+    {
+        FileInputStream input(captureFile);
+        if (!input.openedOk())
+        {
+            return "Cannot open " + captureFile.getFullPathName();
+        }
+        if (readHeader(input) == 0)
+        {
+            return "Not a Trinity debug capture: " + captureFile.getFullPathName();
+        }
+
+        csvFile.deleteFile();
+        FileOutputStream output(csvFile);
+        if (!output.openedOk())
+        {
+            return "Cannot write " + csvFile.getFullPathName();
+        }
+
+        DebugFrameRecord record;
+        bool headerWritten = false;
+        while (readRecord(input, record))
+        {
+            if (!headerWritten)
+            {
+                output.writeString(csvHeader(record));
+                headerWritten = true;
+            }
+            output.writeString(csvLine(record));
+        }
+        output.flush();
+        return {};
+    }
+
+private:
+    static void writeArray(OutputStream& stream, const float* values, int32_t count)
+    {
+        stream.writeInt(count);
+        for (int index = 0; index < count; ++index)
+        {
+            stream.writeFloat(values[index]);
+        }
+    }
+
+    static bool readArray(InputStream& stream, float* values, int capacity, int32_t& count)
+    {
+        if (stream.getNumBytesRemaining() < 4)
+        {
+            count = 0;
+            return false;
+        }
+        count = stream.readInt();
+        if (count < 0 || count > capacity || stream.getNumBytesRemaining() < 4 * static_cast<int64>(count))
+        {
+            count = 0;
+            return false;
+        }
+        for (int index = 0; index < count; ++index)
+        {
+            values[index] = stream.readFloat();
+        }
+        return true;
+    }
+
+    static void appendColumnNames(String& header, const char* prefix, int32_t count)
+    {
+        for (int index = 0; index < count; ++index)
+        {
+            header += "," + String(prefix) + String(index);
+        }
+    }
+
+    static void appendValues(String& line, const float* values, int32_t count)
+    {
+        for (int index = 0; index < count; ++index)
+        {
+            line << "," << values[index];
+        }
+    }
+};
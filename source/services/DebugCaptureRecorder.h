@@ -0,0 +1,179 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "../models/DebugFrameRecord.h"
+#include "DebugCaptureFile.h"
+
+// Service: lock-free debug recorder.
+// The audio thread fills DebugFrameRecords in place inside a
+// single-producer/single-consumer ring (AbstractFifo), allocated by the first
+// start() so that instances which never capture hold no ring; a background thread
+// drains the ring and streams the records to a binary capture file (see
+// DebugCaptureFile). The producer never locks, allocates or blocks: when the
+// writer falls behind, records are dropped and counted instead.
+class DebugCaptureRecorder : private Thread
+{
+public:
+    static constexpr int defaultCapacity = 512; // ~5 s of analysis frames at 96 kHz
+
+    explicit DebugCaptureRecorder(int capacityRecords = defaultCapacity)
+        : Thread("Trinity debug capture"),
+          fifo(jmax(2, capacityRecords))
+    {
+    }
+
+    ~DebugCaptureRecorder() override
+    {
+        this->stop();
+    }
+
+    // Message thread. Opens (truncates) the file, writes the header and starts the writer.
+    bool start(const File& file)
+    {
+        this->stop();
+
+        file.deleteFile();
+        auto stream = std::make_unique<FileOutputStream>(file);
+        if (!stream->openedOk())
+        {
+            return false;
+        }
+        DebugCaptureFile::writeHeader(*stream);
+        this->output = std::move(stream);
+        this->outputFile = file;
+        // Kept once allocated: a record begun before the last stop() may
+        // still be filled in by the audio thread
+        if (this->ring.empty())
+        {
+            this->ring.resize(static_cast<size_t>(this->fifo.getTotalSize()));
+        }
+
+        // The writer is stopped, so this thread is the sole consumer here:
+        // discard anything committed after the previous session was drained.
+        this->fifo.finishedRead(this->fifo.getNumReady());
+        this->droppedRecords.store(0);
+        this->writtenRecords.store(0);
+
+        this->startThread();
+        this->recording.store(true);
+        return true;
+    }
+
+    // Message thread. Stops accepting records, writes what is left and closes the file.
+    void stop()
+    {
+        if (!this->recording.exchange(false) && this->output == nullptr)
+        {
+            return;
+        }
+        this->signalThreadShouldExit();
+        this->notify();
+        this->stopThread(2000);
+        this->drain();
+        if (this->output != nullptr)
+        {
+            this->output->flush();
+        }
+        this->output.reset();
+    }
+
+    bool isRecording() const noexcept
+    {
+        return this->recording.load(std::memory_order_relaxed);
+    }
+
+    const File& getOutputFile() const noexcept
+    {
+        return this->outputFile;
+    }
+
+    // Heap bytes held by the record ring (none until the first capture).
+    size_t getRingBytes() const noexcept
+    {
+        return this->ring.capacity() * sizeof(DebugFrameRecord);
+    }
+
+    uint64 getDroppedCount() const noexcept
+    {
+        return this->droppedRecords.load(std::memory_order_relaxed);
+    }
+
+    uint64 getWrittenCount() const noexcept
+    {
+        return this->writtenRecords.load(std::memory_order_relaxed);
+    }
+
+    // ===== Producer side (audio thread) =====
+
+    // Slot to fill in place, or nullptr when not recording or the ring is full.
+    // Every non-null result must be followed by commitRecord().
+    DebugFrameRecord* beginRecord() noexcept
+    {
+        if (!this->isRecording())
+        {
+            return nullptr;
+        }
+        int start1 = 0, size1 = 0, start2 = 0, size2 = 0;
+        this->fifo.prepareToWrite(1, start1, size1, start2, size2);
+        if (size1 == 0)
+        {
+            this->droppedRecords.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        return &this->ring[static_cast<size_t>(start1)];
+    }
+
+    void commitRecord() noexcept
+    {
+        this->fifo.finishedWrite(1);
+    }
+
+private:
+    void run() override
+    {
+        while (!this->threadShouldExit())
+        {
+            this->wait(20);
+            this->drain();
+        }
+    }
+
+    // Consumer: the writer thread, or the message thread once the writer has stopped.
+    void drain()
+    {
+        if (this->output == nullptr)
+        {
+            return;
+        }
+        const int ready = this->fifo.getNumReady();
+        if (ready <= 0)
+        {
+            return;
+        }
+        int start1 = 0, size1 = 0, start2 = 0, size2 = 0;
+        this->fifo.prepareToRead(ready, start1, size1, start2, size2);
+        for (int index = 0; index < size1; ++index)
+        {
+            DebugCaptureFile::writeRecord(*this->output, this->ring[static_cast<size_t>(start1 + index)]);
+        }
+        for (int index = 0; index < size2; ++index)
+        {
+            DebugCaptureFile::writeRecord(*this->output, this->ring[static_cast<size_t>(start2 + index)]);
+        }
+        this->fifo.finishedRead(size1 + size2);
+        this->writtenRecords.fetch_add(static_cast<uint64>(size1 + size2), std::memory_order_relaxed);
+    }
+
+    std::vector<DebugFrameRecord> ring;
+    AbstractFifo fifo;
+    std::unique_ptr<FileOutputStream> output;
+    File outputFile;
+    std::atomic<bool> recording { false };
+    std::atomic<uint64> droppedRecords { 0 };
+    std::atomic<uint64> writtenRecords { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DebugCaptureRecorder)
+};
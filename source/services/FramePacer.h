@@ -0,0 +1,148 @@
+#pragma once
+
+#include <array>
+#include <algorithm>
+#include "../models/FramePacingSettings.h"
+
+// Service: decides when the editor should render a frame.
+// Picks a refresh rate from a fixed ladder, stepping down while paint cost
+// exceeds the frame budget and back up when there is headroom. Drops to a low
+// idle rate once the spectrum and meters stop changing. Time-based so that
+// UI ballistics can be advanced by the real elapsed time at any rate.
+class FramePacer
+{
+public:
+    static constexpr std::array<double, 5> rateLadderHz { 120.0, 60.0, 30.0, 20.0, 15.0 };
+
+    void reset(double nowSeconds) noexcept
+    {
+        this->lastFrameSeconds = nowSeconds;
+        this->averagePaintSeconds = 0.0;
+        this->overBudgetFrames = 0;
+        this->underBudgetFrames = 0;
+        this->staticFrames = 0;
+        this->idle = false;
+        this->ladderIndex = std::max(this->minLadderIndex, defaultLadderIndex);
+    }
+
+    // Cap the ladder, e.g. to 60 Hz when driven by a message-thread timer.
+    void setMaxRateHz(double maxRateHz) noexcept
+    {
+        this->minLadderIndex = static_cast<int>(rateLadderHz.size()) - 1;
+        for (int index = 0; index < static_cast<int>(rateLadderHz.size()); ++index)
+        {
+            if (rateLadderHz[static_cast<size_t>(index)] <= maxRateHz)
+            {
+                this->minLadderIndex = index;
+                break;
+            }
+        }
+        this->ladderIndex = std::max(this->ladderIndex, this->minLadderIndex);
+    }
+
+    bool isFrameDue(double nowSeconds) const noexcept
+    {
+        // Small slack so a vblank arriving a touch early still counts.
+        const double interval = 1.0 / this->getTargetRateHz();
+        return nowSeconds - this->lastFrameSeconds >= interval * 0.9;
+    }
+
+    // Marks a frame as started and returns the elapsed time since the previous
+    // one, clamped so a stall does not make ballistics jump.
+    double beginFrame(double nowSeconds) noexcept
+    {
+        const double elapsed = nowSeconds - this->lastFrameSeconds;
+        this->lastFrameSeconds = nowSeconds;
+        return std::clamp(elapsed, 0.0, this->settings.maxElapsedSeconds);
+    }
+
+    // Report whether anything visible changed during the last frame.
+    void reportActivity(bool hadActivity) noexcept
+    {
+        if (hadActivity)
+        {
+            this->staticFrames = 0;
+            this->idle = false;
+            return;
+        }
+        if (++this->staticFrames >= this->settings.framesBeforeIdle)
+        {
+            this->idle = true;
+        }
+    }
+
+    // Report the measured cost of the last paint pass and adapt the ladder.
+    void reportPaintCost(double paintSeconds) noexcept
+    {
+        const double smoothing = this->settings.paintCostSmoothing;
+        this->averagePaintSeconds += smoothing * (paintSeconds - this->averagePaintSeconds);
+        if (this->idle)
+        {
+            return;
+        }
+
+        const double currentRate = rateLadderHz[static_cast<size_t>(this->ladderIndex)];
+        const double budgetSeconds = this->settings.frameBudgetFraction / currentRate;
+        if (this->averagePaintSeconds > budgetSeconds)
+        {
+            this->underBudgetFrames = 0;
+            if (++this->overBudgetFrames >= this->settings.framesBeforeRateChange
+                && this->ladderIndex < static_cast<int>(rateLadderHz.size()) - 1)
+            {
+                ++this->ladderIndex;
+                this->overBudgetFrames = 0;
+            }
+            return;
+        }
+
+        this->overBudgetFrames = 0;
+        if (this->ladderIndex <= this->minLadderIndex)
+        {
+            return;
+        }
+        const double fasterRate = rateLadderHz[static_cast<size_t>(this->ladderIndex - 1)];
+        const double headroomSeconds = this->settings.headroomFraction / fasterRate;
+        if (this->averagePaintSeconds < headroomSeconds)
+        {
+            if (++this->underBudgetFrames >= this->settings.framesBeforeRateChange)
+            {
+                --this->ladderIndex;
+                this->underBudgetFrames = 0;
+            }
+        }
+        else
+        {
+            this->underBudgetFrames = 0;
+        }
+    }
+
+    double getTargetRateHz() const noexcept
+    {
+        return this->idle ? this->settings.idleRateHz
+                          : rateLadderHz[static_cast<size_t>(this->ladderIndex)];
+    }
+
+    bool isIdle() const noexcept
+    {
+        return this->idle;
+    }
+
+    double getAveragePaintSeconds() const noexcept
+    {
+        return this->averagePaintSeconds;
+    }
+
+    FramePacingSettings settings {};
+
+private:
+    static constexpr int defaultLadderIndex = 1; // 60 Hz
+
+    double lastFrameSeconds { 0.0 };
+    double averagePaintSeconds { 0.0 };
+    int ladderIndex { defaultLadderIndex };
+    int minLadderIndex { 0 };
+    int overBudgetFrames { 0 };
+    int underBudgetFrames { 0 };
+    int staticFrames { 0 };
+    bool idle { false };
+};
@@ -0,0 +1,261 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <spdlog/async.h>
+#include <spdlog/sinks/stdout_color_sinks.h>
+#include <spdlog/spdlog.h>
+#include "../models/RealtimeLogEvent.h"
+
+class RealtimeLogDispatcher;
+
+// Service: process-wide logging.
+// All processors share one asynchronous spdlog logger named "Trinity" (an
+// existing logger of that name, e.g. a null sink in the benchmarks, is used
+// instead), so any number of instances can live in one process. Each
+// instance logs through an InstanceLog that tags its lines with "#<n>".
+//
+// Message-thread calls format and enqueue on spdlog's async queue. The audio
+// thread uses post(): a fixed-format RealtimeLogEvent goes into the handle's
+// preallocated single-producer ring (wait-free, no allocation) and the shared
+// dispatcher thread formats and writes it. A full ring drops and counts.
+class InstanceLog
+{
+public:
+    static constexpr int eventCapacity = 256;
+
+    InstanceLog();
+    ~InstanceLog();
+
+    const String& getTag() const noexcept
+    {
+        return this->tag;
+    }
+
+    template <typename... Args>
+    void debug(spdlog::format_string_t<Args...> format, Args&&... args)
+    {
+        this->write(spdlog::level::debug, spdlog::fmt_lib::format(format, std::forward<Args>(args)...));
+    }
+
+    template <typename... Args>
+    void info(spdlog::format_string_t<Args...> format, Args&&... args)
+    {
+        this->write(spdlog::level::info, spdlog::fmt_lib::format(format, std::forward<Args>(args)...));
+    }
+
+    template <typename... Args>
+    void warn(spdlog::format_string_t<Args...> format, Args&&... args)
+    {
+        this->write(spdlog::level::warn, spdlog::fmt_lib::format(format, std::forward<Args>(args)...));
+    }
+
+    // Audio thread (one producer per handle). Returns false when the ring is full.
+    bool post(RealtimeLogEvent event) noexcept
+    {
+        int start1 = 0, size1 = 0, start2 = 0, size2 = 0;
+        this->fifo.prepareToWrite(1, start1, size1, start2, size2);
+        if (size1 == 0)
+        {
+            this->droppedEvents.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        event.ticks = Time::getHighResolutionTicks();
+        this->events[static_cast<size_t>(start1)] = event;
+        this->fifo.finishedWrite(1);
+        return true;
+    }
+
+    uint64 getDroppedEvents() const noexcept
+    {
+        return this->droppedEvents.load(std::memory_order_relaxed);
+    }
+
+    uint64 getWrittenEvents() const noexcept
+    {
+        return this->writtenEvents.load(std::memory_order_relaxed);
+    }
+
+    // Writes queued audio-thread events now instead of on the next dispatcher pass.
+    void flush();
+
+    static String formatEvent(const RealtimeLogEvent& event)
+    {
+        switch (event.type)
+        {
+            case RealtimeLogEventType::Xrun:
+                return "xrun: " + String(event.count) + "-sample block took " + String(event.valueA, 3)
+                     + " ms of " + String(event.valueB, 3) + " ms budget";
+            case RealtimeLogEventType::SampleRateChange:
+                return "sample rate " + String(event.valueA, 0) + " Hz -> " + String(event.valueB, 0) + " Hz";
+            case RealtimeLogEventType::ChannelLayoutChange:
+                return "channel layout " + String(roundToInt(event.valueA)) + " -> " + String(event.count) + " channels";
+            case RealtimeLogEventType::OversizedBlock:
+                return "block of " + String(event.count) + " samples exceeds prepared size "
+                     + String(roundToInt(event.valueA));
+        }
+        return "unknown event";
+    }
+
+    // The shared logger, created on first use.
+    static std::shared_ptr<spdlog::logger> getSharedLogger()
+    {
+        static std::mutex loggerMutex;
+        const std::lock_guard<std::mutex> lock(loggerMutex);
+        if (auto existing = spdlog::get(loggerName))
+        {
+            return existing;
+        }
+        // Own queue and worker, independent of spdlog's global thread pool;
+        // async loggers only keep a weak reference, so it lives here.
+        static std::shared_ptr<spdlog::details::thread_pool> pool =
+            std::make_shared<spdlog::details::thread_pool>(8192, 1);
+        auto logger = std::make_shared<spdlog::async_logger>(loggerName,
+                                                             std::make_shared<spdlog::sinks::stdout_color_sink_mt>(),
+                                                             pool,
+                                                             spdlog::async_overflow_policy::overrun_oldest);
+        logger->set_level(spdlog::level::debug);
+        spdlog::register_logger(logger);
+        return logger;
+    }
+
+private:
+    friend class RealtimeLogDispatcher;
+    static constexpr const char* loggerName = "Trinity";
+
+    void write(spdlog::level::level_enum level, const std::string& message)
+    {
+        this->logger->log(level, "[{}] {}", this->tag.toStdString(), message);
+    }
+
+    // Consumer side; callers hold the dispatcher lock so there is one reader.
+    void drainEvents()
+    {
+        const int ready = this->fifo.getNumReady();
+        if (ready <= 0)
+        {
+            return;
+        }
+        int start1 = 0, size1 = 0, start2 = 0, size2 = 0;
+        this->fifo.prepareToRead(ready, start1, size1, start2, size2);
+        for (int index = 0; index < size1; ++index)
+        {
+            this->writeEvent(this->events[static_cast<size_t>(start1 + index)]);
+        }
+        for (int index = 0; index < size2; ++index)
+        {
+            this->writeEvent(this->events[static_cast<size_t>(start2 + index)]);
+        }
+        this->fifo.finishedRead(size1 + size2);
+        this->writtenEvents.fetch_add(static_cast<uint64>(size1 + size2), std::memory_order_relaxed);
+    }
+
+    void writeEvent(const RealtimeLogEvent& event)
+    {
+        const auto level = event.type == RealtimeLogEventType::Xrun ? spdlog::level::warn : spdlog::level::info;
+        const double ageMs = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - event.ticks) * 1000.0;
+        this->write(level, (formatEvent(event) + " (" + String(ageMs, 1) + " ms ago)").toStdString());
+    }
+
+    inline static std::atomic<int> nextInstance { 1 };
+
+    String tag;
+    std::shared_ptr<spdlog::logger> logger;
+    std::shared_ptr<RealtimeLogDispatcher> dispatcher;
+    std::vector<RealtimeLogEvent> events;
+    AbstractFifo fifo { eventCapacity };
+    std::atomic<uint64> droppedEvents { 0 };
+    std::atomic<uint64> writtenEvents { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(InstanceLog)
+};
+
+// One background thread per process that drains every InstanceLog's event
+// ring. Shared by the handles and stopped when the last one goes away.
+class RealtimeLogDispatcher : private Thread
+{
+public:
+    RealtimeLogDispatcher()
+        : Thread("Trinity log")
+    {
+        this->startThread();
+    }
+
+    ~RealtimeLogDispatcher() override
+    {
+        this->stopThread(2000);
+    }
+
+    static std::shared_ptr<RealtimeLogDispatcher> acquire()
+    {
+        static std::mutex instanceMutex;
+        static std::weak_ptr<RealtimeLogDispatcher> instance;
+        const std::lock_guard<std::mutex> lock(instanceMutex);
+        std::shared_ptr<RealtimeLogDispatcher> dispatcher = instance.lock();
+        if (dispatcher == nullptr)
+        {
+            dispatcher = std::make_shared<RealtimeLogDispatcher>();
+            instance = dispatcher;
+        }
+        return dispatcher;
+    }
+
+    void add(InstanceLog& handle)
+    {
+        const ScopedLock lock(this->handlesLock);
+        this->handles.addIfNotAlreadyThere(&handle);
+    }
+
+    // Drains the handle one last time before it stops being polled.
+    void remove(InstanceLog& handle)
+    {
+        const ScopedLock lock(this->handlesLock);
+        handle.drainEvents();
+        this->handles.removeFirstMatchingValue(&handle);
+    }
+
+    void drain(InstanceLog& handle)
+    {
+        const ScopedLock lock(this->handlesLock);
+        handle.drainEvents();
+    }
+
+private:
+    void run() override
+    {
+        while (!this->threadShouldExit())
+        {
+            this->wait(20);
+            const ScopedLock lock(this->handlesLock);
+            for (InstanceLog* handle : this->handles)
+            {
+                handle->drainEvents();
+            }
+        }
+    }
+
+    CriticalSection handlesLock;  // never taken on the audio thread
+    Array<InstanceLog*> handles;
+};
+
+inline InstanceLog::InstanceLog()
+    : tag("#" + String(nextInstance.fetch_add(1))),
+      logger(getSharedLogger()),
+      dispatcher(RealtimeLogDispatcher::acquire()),
+      events(static_cast<size_t>(eventCapacity))
+{
+    this->dispatcher->add(*this);
+}
+
+inline InstanceLog::~InstanceLog()
+{
+    this->dispatcher->remove(*this);
+}
+
+inline void InstanceLog::flush()
+{
+    this->dispatcher->drain(*this);
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include "../models/LevelReading.h"
+
+// Service: lossless meter hand-off from the audio thread to one reader.
+// Each block raises a running peak (atomic max) and adds its sum of squares
+// and sample count to one packed 64-bit word. take() exchanges both with
+// zero, so every peak between two readings is seen exactly once and the RMS
+// covers exactly the samples since the last reading, however the block and
+// UI rates relate. Lock-free and wait-free for the reader; the writer only
+// retries when a reading lands mid-update.
+class LevelAccumulator
+{
+public:
+    // Audio thread. sumOfSquares covers numSamples samples (all channels).
+    void accumulate(float peak, float sumOfSquares, int numSamples) noexcept
+    {
+        float seenPeak = this->peak.load(std::memory_order_relaxed);
+        while (peak > seenPeak && !this->peak.compare_exchange_weak(seenPeak, peak, std::memory_order_relaxed))
+        {
+        }
+
+        if (numSamples <= 0)
+        {
+            return;
+        }
+        uint64_t packed = this->power.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            float sum = unpackSum(packed);
+            uint32_t count = unpackCount(packed);
+            // Left unread for minutes: start a new window so the float sum
+            // keeps its precision
+            if (count >= maxWindowSamples)
+            {
+                sum = 0.0f;
+                count = 0;
+            }
+            const uint64_t next = pack(sum + sumOfSquares, count + static_cast<uint32_t>(numSamples));
+            if (this->power.compare_exchange_weak(packed, next, std::memory_order_relaxed))
+            {
+                return;
+            }
+        }
+    }
+
+    // Single reader: everything since the previous take(), then starts over.
+    LevelReading take() noexcept
+    {
+        LevelReading reading;
+        reading.peak = this->peak.exchange(0.0f, std::memory_order_relaxed);
+        return withPower(reading, this->power.exchange(0, std::memory_order_relaxed));
+    }
+
+    // Everything since the last take(), without resetting. Any thread.
+    LevelReading peek() const noexcept
+    {
+        LevelReading reading;
+        reading.peak = this->peak.load(std::memory_order_relaxed);
+        return withPower(reading, this->power.load(std::memory_order_relaxed));
+    }
+
+    void reset() noexcept
+    {
+        this->peak.store(0.0f, std::memory_order_relaxed);
+        this->power.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr uint32_t maxWindowSamples = 1u << 24;
+
+    static uint64_t pack(float sum, uint32_t count) noexcept
+    {
+        uint32_t sumBits = 0;
+        std::memcpy(&sumBits, &sum, sizeof(sumBits));
+        return (static_cast<uint64_t>(count) << 32) | sumBits;
+    }
+    static float unpackSum(uint64_t packed) noexcept
+    {
+        const auto sumBits = static_cast<uint32_t>(packed);
+        float sum = 0.0f;
+        std::memcpy(&sum, &sumBits, sizeof(sum));
+        return sum;
+    }
+    static uint32_t unpackCount(uint64_t packed) noexcept
+    {
+        return static_cast<uint32_t>(packed >> 32);
+    }
+
+    static LevelReading withPower(LevelReading reading, uint64_t packed) noexcept
+    {
+        reading.numSamples = unpackCount(packed);
+        reading.meanSquare = reading.numSamples > 0 ? unpackSum(packed) / static_cast<float>(reading.numSamples) : 0.0f;
+        return reading;
+    }
+
+    std::atomic<float> peak { 0.0f };
+    std::atomic<uint64_t> power { 0 };  // count << 32 | float sum of squares
+    static_assert(std::atomic<float>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free);
+};
@@ -0,0 +1,420 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "../models/BandFrequencies.h"
+#include "../models/LoudnessReading.h"
+
+// Service: ITU-R BS.1770-4 loudness for several signals with the same channel
+// count, here the input and each crossover band.
+//
+// K-weighting is the standard's two biquads (high shelf, then RLB high-pass),
+// designed for the actual sample rate. Like CrossoverTree, every signal's
+// channels are lanes of one frame and each filter step runs the same
+// coefficients over all lanes, so the work vectorises across channels and
+// signals. Squared output is summed per 100 ms step; closing a step updates
+// the 400 ms (momentary) and 3 s (short-term) sums in O(1) from a ring of step
+// powers. Each 400 ms block (75 % overlap) feeds the gated integrated
+// loudness and each 3 s window the loudness range, both through histograms
+// of 0.1 LU bins, so memory stays fixed however long the measurement runs.
+// Every channel is weighted 1.0 (no surround weighting).
+//
+// prepare() allocates; process() and reset() do not. getReading() is safe
+// from any thread and returns the values published at the last step.
+class LoudnessMeter
+{
+public:
+    static constexpr int maxSignals = 1 + CrossoverFrequencies::maxBands;
+
+    void prepare(double sampleRate, int numChannels)
+    {
+        this->sampleRateHz = sampleRate > 0.0 ? sampleRate : 44100.0;
+        this->channels = jmax(1, numChannels);
+        const auto laneCount = static_cast<size_t>(maxSignals * this->channels);
+        this->filterState.assign(4 * laneCount, 0.0);
+        this->stepEnergy.assign(laneCount, 0.0);
+        this->histograms.assign(static_cast<size_t>(2 * maxSignals * numBins), 0);
+        // Power at each bin centre; bins are summed by their centres, so
+        // results are within half a bin (0.05 LU) of an exact per-block sum
+        this->binPowers.resize(static_cast<size_t>(numBins));
+        for (int bin = 0; bin < numBins; ++bin)
+        {
+            this->binPowers[static_cast<size_t>(bin)] = std::pow(10.0, (binCentreLufs(bin) + 0.691) / 10.0);
+        }
+        this->stepSamples = jmax(1, roundToInt(this->sampleRateHz * stepSeconds));
+        this->designKWeighting();
+        this->reset();
+    }
+
+    // Signals measured from here on (1 to maxSignals). A change restarts
+    // every signal after the first; the input (signal 0) keeps measuring.
+    void setNumSignals(int newNumSignals) noexcept
+    {
+        newNumSignals = jlimit(1, maxSignals, newNumSignals);
+        if (newNumSignals != this->numSignals)
+        {
+            this->numSignals = newNumSignals;
+            this->resetSignals(1);
+        }
+    }
+
+    int getNumSignals() const noexcept
+    {
+        return this->numSignals;
+    }
+
+    int getNumChannels() const noexcept
+    {
+        return this->channels;
+    }
+
+    // Clears filters, windows, the integrated gate and the published values
+    void reset() noexcept
+    {
+        this->samplesInStep = 0;
+        this->resetSignals(0);
+    }
+
+    size_t getStateBytes() const noexcept
+    {
+        return (this->filterState.capacity() + this->stepEnergy.capacity() + this->binPowers.capacity()) * sizeof(double)
+             + this->histograms.capacity() * sizeof(uint32_t);
+    }
+
+    // Adds numSamples frames. Each frame starts frameStride floats after the
+    // previous one and holds getNumSignals() x getNumChannels() values,
+    // signal-major, as CrossoverTree writes its band frames.
+    void process(const float* frames, int frameStride, int numSamples) noexcept
+    {
+        if (this->filterState.empty())
+        {
+            return;  // not prepared
+        }
+        const int numLanes = this->numSignals * this->channels;
+        int frameIndex = 0;
+        while (frameIndex < numSamples)
+        {
+            const int run = jmin(numSamples - frameIndex, this->stepSamples - this->samplesInStep);
+            for (int sample = 0; sample < run; ++sample)
+            {
+                this->weightFrame(frames + static_cast<ptrdiff_t>(frameIndex + sample) * frameStride, numLanes);
+            }
+            frameIndex += run;
+            this->samplesInStep += run;
+            if (this->samplesInStep == this->stepSamples)
+            {
+                this->closeStep();
+                this->samplesInStep = 0;
+            }
+        }
+    }
+
+    LoudnessReading getReading(int signal) const noexcept
+    {
+        if (!isPositiveAndBelow(signal, maxSignals))
+        {
+            return {};
+        }
+        const Published& published = this->published[static_cast<size_t>(signal)];
+        LoudnessReading reading;
+        reading.momentaryLufs = published.momentaryLufs.load(std::memory_order_relaxed);
+        reading.shortTermLufs = published.shortTermLufs.load(std::memory_order_relaxed);
+        reading.integratedLufs = published.integratedLufs.load(std::memory_order_relaxed);
+        reading.loudnessRangeLu = published.loudnessRangeLu.load(std::memory_order_relaxed);
+        return reading;
+    }
+
+    // Loudness of a mean square summed over channels
+    static double powerToLufs(double power) noexcept
+    {
+        return power > 0.0 ? -0.691 + 10.0 * std::log10(power) : -std::numeric_limits<double>::infinity();
+    }
+
+private:
+    static constexpr double stepSeconds = 0.1;
+    static constexpr int momentarySteps = 4;    // 400 ms
+    static constexpr int shortTermSteps = 30;   // 3 s
+    static constexpr double absoluteGateLufs = -70.0;
+    static constexpr double integratedRelativeGateLu = -10.0;
+    static constexpr double rangeRelativeGateLu = -20.0;
+    static constexpr double binWidthLu = 0.1;
+    static constexpr int numBins = 800;         // -70 to +10 LUFS
+
+    struct Biquad
+    {
+        double b0 { 1.0 }, b1 { 0.0 }, b2 { 0.0 }, a1 { 0.0 }, a2 { 0.0 };
+    };
+
+    struct History
+    {
+        std::array<double, shortTermSteps> stepPowers {};  // ring, summed over channels
+        int nextStep { 0 };
+        int64_t stepsSeen { 0 };
+        double momentarySum { 0.0 };
+        double shortTermSum { 0.0 };
+        // Histogram totals above the absolute gate, kept as the bins fill
+        double blockPowerSum { 0.0 };
+        int64_t blockCount { 0 };
+        double shortTermPowerSum { 0.0 };
+        int64_t shortTermCount { 0 };
+    };
+
+    struct Published
+    {
+        std::atomic<float> momentaryLufs { LoudnessReading::unmeasured };
+        std::atomic<float> shortTermLufs { LoudnessReading::unmeasured };
+        std::atomic<float> integratedLufs { LoudnessReading::unmeasured };
+        std::atomic<float> loudnessRangeLu { 0.0f };
+    };
+
+    // BS.1770-4 K-weighting, re-derived for sampleRateHz from the analog
+    // prototypes so 44.1 to 192 kHz all match the 48 kHz reference
+    void designKWeighting() noexcept
+    {
+        const double pi = MathConstants<double>::pi;
+        {
+            const double centreHz = 1681.974450955533;
+            const double gainDb = 3.999843853973347;
+            const double q = 0.7071752369554196;
+            const double k = std::tan(pi * centreHz / this->sampleRateHz);
+            const double vh = std::pow(10.0, gainDb / 20.0);
+            const double vb = std::pow(vh, 0.4996667741545416);
+            const double a0 = 1.0 + k / q + k * k;
+            this->shelf = { (vh + vb * k / q + k * k) / a0, 2.0 * (k * k - vh) / a0, (vh - vb * k / q + k * k) / a0,
+                            2.0 * (k * k - 1.0) / a0, (1.0 - k / q + k * k) / a0 };
+        }
+        {
+            const double cornerHz = 38.13547087602444;
+            const double q = 0.5003270373238773;
+            const double k = std::tan(pi * cornerHz / this->sampleRateHz);
+            const double a0 = 1.0 + k / q + k * k;
+            this->highPass = { 1.0, -2.0, 1.0, 2.0 * (k * k - 1.0) / a0, (1.0 - k / q + k * k) / a0 };
+        }
+    }
+
+    // Both biquads (transposed direct form II) on one frame, then the
+    // squared output into the step sums
+    void weightFrame(const float* frame, int numLanes) noexcept
+    {
+        const auto laneCount = static_cast<size_t>(maxSignals * this->channels);
+        double* shelfZ1 = this->filterState.data();
+        double* shelfZ2 = shelfZ1 + laneCount;
+        double* highPassZ1 = shelfZ2 + laneCount;
+        double* highPassZ2 = highPassZ1 + laneCount;
+        double* energy = this->stepEnergy.data();
+        const Biquad s = this->shelf;
+        const Biquad h = this->highPass;
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            const auto x = static_cast<double>(frame[lane]);
+            const double shelved = s.b0 * x + shelfZ1[lane];
+            shelfZ1[lane] = s.b1 * x - s.a1 * shelved + shelfZ2[lane];
+            shelfZ2[lane] = s.b2 * x - s.a2 * shelved;
+            const double weighted = h.b0 * shelved + highPassZ1[lane];
+            highPassZ1[lane] = h.b1 * shelved - h.a1 * weighted + highPassZ2[lane];
+            highPassZ2[lane] = h.b2 * shelved - h.a2 * weighted;
+            energy[lane] += weighted * weighted;
+        }
+    }
+
+    void closeStep() noexcept
+    {
+        const double inverseStepSamples = 1.0 / static_cast<double>(this->stepSamples);
+        for (int signal = 0; signal < this->numSignals; ++signal)
+        {
+            double stepPower = 0.0;
+            double* energy = this->stepEnergy.data() + signal * this->channels;
+            for (int channel = 0; channel < this->channels; ++channel)
+            {
+                stepPower += energy[channel];
+                energy[channel] = 0.0;
+            }
+            this->advance(signal, stepPower * inverseStepSamples);
+        }
+    }
+
+    // One 100 ms step of a signal: slide both windows, gate the new block
+    // and window into the histograms, publish
+    void advance(int signal, double stepPower) noexcept
+    {
+        History& history = this->histories[static_cast<size_t>(signal)];
+        const int momentaryLeaving = (history.nextStep + shortTermSteps - momentarySteps) % shortTermSteps;
+        history.momentarySum += stepPower - history.stepPowers[static_cast<size_t>(momentaryLeaving)];
+        history.shortTermSum += stepPower - history.stepPowers[static_cast<size_t>(history.nextStep)];
+        history.stepPowers[static_cast<size_t>(history.nextStep)] = stepPower;
+        history.nextStep = (history.nextStep + 1) % shortTermSteps;
+        ++history.stepsSeen;
+        // Running sums of non-negative terms only drift by rounding; keep them there
+        history.momentarySum = jmax(0.0, history.momentarySum);
+        history.shortTermSum = jmax(0.0, history.shortTermSum);
+
+        const double momentaryPower = history.momentarySum / momentarySteps;
+        const double shortTermPower = history.shortTermSum / shortTermSteps;
+        uint32_t* blockBins = this->histogram(signal, 0);
+        uint32_t* shortTermBins = this->histogram(signal, 1);
+        if (history.stepsSeen >= momentarySteps)
+        {
+            addToHistogram(blockBins, momentaryPower, history.blockPowerSum, history.blockCount);
+        }
+        if (history.stepsSeen >= shortTermSteps)
+        {
+            addToHistogram(shortTermBins, shortTermPower, history.shortTermPowerSum, history.shortTermCount);
+        }
+
+        LoudnessReading reading;
+        reading.momentaryLufs = static_cast<float>(powerToLufs(momentaryPower));
+        reading.shortTermLufs = static_cast<float>(powerToLufs(shortTermPower));
+        reading.integratedLufs = static_cast<float>(integratedLoudness(blockBins, history));
+        reading.loudnessRangeLu = static_cast<float>(loudnessRange(shortTermBins, history));
+        this->publish(signal, reading);
+    }
+
+    // Signals from firstSignal on start over; the step in progress carries
+    // on for the others, so a restarted signal's first step is partial
+    void resetSignals(int firstSignal) noexcept
+    {
+        if (!this->filterState.empty())
+        {
+            const auto laneCount = static_cast<size_t>(maxSignals * this->channels);
+            const auto firstLane = static_cast<size_t>(firstSignal * this->channels);
+            for (size_t array = 0; array < 4; ++array)
+            {
+                std::fill(this->filterState.begin() + static_cast<ptrdiff_t>(array * laneCount + firstLane),
+                          this->filterState.begin() + static_cast<ptrdiff_t>((array + 1) * laneCount), 0.0);
+            }
+            std::fill(this->stepEnergy.begin() + static_cast<ptrdiff_t>(firstLane), this->stepEnergy.end(), 0.0);
+            std::fill(this->histograms.begin() + static_cast<ptrdiff_t>(2 * firstSignal * numBins), this->histograms.end(), 0u);
+        }
+        for (int signal = firstSignal; signal < maxSignals; ++signal)
+        {
+            this->histories[static_cast<size_t>(signal)] = History {};
+            this->publish(signal, LoudnessReading {});
+        }
+    }
+
+    uint32_t* histogram(int signal, int which) noexcept
+    {
+        return this->histograms.data() + static_cast<size_t>((2 * signal + which) * numBins);
+    }
+
+    void addToHistogram(uint32_t* bins, double power, double& powerSum, int64_t& count) const noexcept
+    {
+        const double lufs = powerToLufs(power);
+        if (lufs <= absoluteGateLufs)
+        {
+            return;
+        }
+        const int bin = binForLufs(lufs);
+        ++bins[bin];
+        powerSum += this->binPowers[static_cast<size_t>(bin)];
+        ++count;
+    }
+
+    static int binForLufs(double lufs) noexcept
+    {
+        return jlimit(0, numBins - 1, static_cast<int>((lufs - absoluteGateLufs) / binWidthLu));
+    }
+
+    static double binCentreLufs(int bin) noexcept
+    {
+        return absoluteGateLufs + (bin + 0.5) * binWidthLu;
+    }
+
+    // BS.1770-4: mean of the blocks above -70 LUFS, then again over the
+    // blocks within 10 LU of that
+    double integratedLoudness(const uint32_t* bins, const History& history) const noexcept
+    {
+        if (history.blockCount == 0)
+        {
+            return -std::numeric_limits<double>::infinity();
+        }
+        const double relativeGate = powerToLufs(history.blockPowerSum / static_cast<double>(history.blockCount))
+                                  + integratedRelativeGateLu;
+        double powerSum = 0.0;
+        int64_t count = 0;
+        for (int bin = binForLufs(relativeGate); bin < numBins; ++bin)
+        {
+            if (bins[bin] != 0 && binCentreLufs(bin) > relativeGate)
+            {
+                powerSum += static_cast<double>(bins[bin]) * this->binPowers[static_cast<size_t>(bin)];
+                count += bins[bin];
+            }
+        }
+        return count > 0 ? powerToLufs(powerSum / static_cast<double>(count)) : -std::numeric_limits<double>::infinity();
+    }
+
+    // EBU Tech 3342: short-term values above -70 LUFS and within 20 LU of
+    // their mean; the range is the spread from the 10th to the 95th percentile
+    static double loudnessRange(const uint32_t* bins, const History& history) noexcept
+    {
+        if (history.shortTermCount == 0)
+        {
+            return 0.0;
+        }
+        const double relativeGate = powerToLufs(history.shortTermPowerSum / static_cast<double>(history.shortTermCount))
+                                  + rangeRelativeGateLu;
+        int firstBin = binForLufs(relativeGate);
+        while (firstBin < numBins && binCentreLufs(firstBin) <= relativeGate)
+        {
+            ++firstBin;
+        }
+        int64_t count = 0;
+        for (int bin = firstBin; bin < numBins; ++bin)
+        {
+            count += bins[bin];
+        }
+        if (count == 0)
+        {
+            return 0.0;
+        }
+        const auto lowRank = static_cast<int64_t>(std::ceil(0.10 * static_cast<double>(count)));
+        const auto highRank = static_cast<int64_t>(std::ceil(0.95 * static_cast<double>(count)));
+        double lowLufs = 0.0;
+        double highLufs = 0.0;
+        int64_t seen = 0;
+        for (int bin = firstBin; bin < numBins; ++bin)
+        {
+            const int64_t before = seen;
+            seen += bins[bin];
+            if (before < lowRank && seen >= lowRank)
+            {
+                lowLufs = binCentreLufs(bin);
+            }
+            if (before < highRank && seen >= highRank)
+            {
+                highLufs = binCentreLufs(bin);
+                break;
+            }
+        }
+        return highLufs - lowLufs;
+    }
+
+    void publish(int signal, const LoudnessReading& reading) noexcept
+    {
+        Published& published = this->published[static_cast<size_t>(signal)];
+        published.momentaryLufs.store(reading.momentaryLufs, std::memory_order_relaxed);
+        published.shortTermLufs.store(reading.shortTermLufs, std::memory_order_relaxed);
+        published.integratedLufs.store(reading.integratedLufs, std::memory_order_relaxed);
+        published.loudnessRangeLu.store(reading.loudnessRangeLu, std::memory_order_relaxed);
+    }
+
+    double sampleRateHz { 44100.0 };
+    int channels { 1 };
+    int numSignals { 1 };
+    int stepSamples { 4410 };
+    int samplesInStep { 0 };
+    Biquad shelf;
+    Biquad highPass;
+    std::vector<double> filterState;  // shelf z1, z2, high-pass z1, z2; maxSignals x channels lanes each
+    std::vector<double> stepEnergy;   // per lane, this step
+    std::vector<uint32_t> histograms; // per signal: 400 ms blocks, then 3 s windows
+    std::vector<double> binPowers;    // power at each histogram bin's centre
+    std::array<History, maxSignals> histories {};
+    std::array<Published, maxSignals> published;
+};
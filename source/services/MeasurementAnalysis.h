@@ -0,0 +1,345 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <functional>
+#include <vector>
+#include "../models/MeasuredResponse.h"
+#include "../models/MeasurementSettings.h"
+#include "../models/TestSignalType.h"
+#include "MeasurementSignals.h"
+
+// Service: plays a measurement excitation through a block callback and turns
+// the response into an impulse response, latency and magnitude/phase on the
+// multitone frequency grid. Each signal has its own analysis:
+//   impulse    the response is the impulse response
+//   sync sweep regularised spectral division by the sweep (deconvolution)
+//   MLS        circular correlation of a steady-state period with the sequence
+//   multitone  per-tone ratio of response and excitation spectra (no latency)
+// Offline only: allocates and runs FFTs, never call it from processBlock.
+class MeasurementAnalysis
+{
+public:
+    using ProcessBlock = std::function<void(AudioBuffer<float>&)>;
+
+    // Samples kept before time zero of a deconvolved sweep. Nothing above the
+    // sweep's end frequency is excited, so its impulse response is band
+    // limited and rings on both sides of every peak; cutting that ringing at
+    // time zero would bias the whole band. The second harmonic sits L ln 2
+    // earlier (1663 samples with the default settings at 48 kHz).
+    static constexpr int sweepLeadSamples = 256;
+
+    static bool isMeasurementSignal(int signalType) noexcept
+    {
+        return signalType == kImpulse || signalType == kSyncSweep || signalType == kMls || signalType == kMultitone;
+    }
+
+    // Renders the excitation in blocks of blockSize into every channel, runs
+    // processBlock on each block and analyses channel 0 of the result.
+    static MeasuredResponse measure(int signalType,
+                                    const MeasurementSettings& settings,
+                                    double sampleRate,
+                                    int numChannels,
+                                    int blockSize,
+                                    const ProcessBlock& processBlock)
+    {
+        MeasuredResponse result;
+        result.sampleRate = sampleRate;
+        if (!isMeasurementSignal(signalType) || sampleRate <= 0.0)
+        {
+            return result;
+        }
+
+        const std::vector<float> excitation = renderExcitation(signalType, settings, sampleRate);
+        const std::vector<float> response = play(excitation, jmax(1, numChannels), jmax(1, blockSize), processBlock);
+        result.audioSeconds = static_cast<double>(excitation.size()) / sampleRate;
+
+        switch (signalType)
+        {
+            case kImpulse:
+                describe(analyseImpulse(response, settings), 0, settings, result);
+                break;
+            case kSyncSweep:
+                describe(analyseSweep(excitation, response, settings, sampleRate), sweepLeadSamples, settings, result);
+                break;
+            case kMls:
+                describe(analyseMls(response, settings), 0, settings, result);
+                break;
+            case kMultitone:
+                analyseMultitone(excitation, response, settings, result);
+                break;
+            default:
+                break;
+        }
+        return result;
+    }
+
+    // What measure() plays: one period of impulse or sweep (the sweep with its
+    // tail), two periods of MLS or multitone (the first settles the system).
+    static std::vector<float> renderExcitation(int signalType, const MeasurementSettings& settings, double sampleRate)
+    {
+        std::vector<float> excitation;
+        const auto renderPeriods = [&excitation, &settings](auto& generator, int numPeriods)
+        {
+            excitation.resize(static_cast<size_t>(generator.getPeriodSamples() * numPeriods));
+            generator.render(excitation.data(), static_cast<int>(excitation.size()), settings.amplitude);
+        };
+        switch (signalType)
+        {
+            case kImpulse:
+            {
+                ImpulseTrain impulse;
+                impulse.prepare(settings.responseLength);
+                renderPeriods(impulse, 1);
+                break;
+            }
+            case kSyncSweep:
+            {
+                SyncSweep sweep;
+                sweep.prepare(sampleRate, settings);
+                renderPeriods(sweep, 1);
+                break;
+            }
+            case kMls:
+            {
+                MaximumLengthSequence sequence;
+                sequence.prepare(settings.mlsOrder);
+                renderPeriods(sequence, 2);
+                break;
+            }
+            case kMultitone:
+            {
+                Multitone multitone;
+                multitone.prepare(sampleRate, settings);
+                renderPeriods(multitone, 2);
+                break;
+            }
+            default:
+                break;
+        }
+        return excitation;
+    }
+
+    static std::vector<float> analyseImpulse(const std::vector<float>& response, const MeasurementSettings& settings)
+    {
+        const size_t length = std::min(response.size(), static_cast<size_t>(jmax(0, settings.responseLength)));
+        std::vector<float> impulseResponse(response.begin(), response.begin() + static_cast<std::ptrdiff_t>(length));
+        const float scale = settings.amplitude != 0.0f ? 1.0f / settings.amplitude : 0.0f;
+        for (float& value : impulseResponse)
+        {
+            value *= scale;
+        }
+        return impulseResponse;
+    }
+
+    // H = Y X* / (|X|^2 + eps): eps sits 60 dB under the sweep's strongest bin,
+    // far below it inside the swept band and dominant outside it. Harmonic
+    // distortion lands at negative times (the end of the buffer), before the
+    // sweepLeadSamples kept ahead of the responseLength samples from time zero.
+    static std::vector<float> analyseSweep(const std::vector<float>& excitation,
+                                           const std::vector<float>& response,
+                                           const MeasurementSettings& settings,
+                                           double sampleRate)
+    {
+        SyncSweep sweep;
+        sweep.prepare(sampleRate, settings);
+        const size_t sweepSamples = std::min(excitation.size(), static_cast<size_t>(sweep.getSweepSamples()));
+        const int order = orderFor(sweepSamples + response.size());
+        const int size = 1 << order;
+        const dsp::FFT fft(order);
+
+        std::vector<float> x = padded(excitation.data(), sweepSamples, size);
+        std::vector<float> y = padded(response.data(), response.size(), size);
+        fft.performRealOnlyForwardTransform(x.data());
+        fft.performRealOnlyForwardTransform(y.data());
+
+        float maxPower = 0.0f;
+        for (int bin = 0; bin < size; ++bin)
+        {
+            maxPower = jmax(maxPower, std::norm(binAt(x, bin)));
+        }
+        const float regularisation = jmax(1.0e-30f, maxPower * 1.0e-6f);
+        for (int bin = 0; bin < size; ++bin)
+        {
+            const std::complex<float> ratio = binAt(y, bin) * std::conj(binAt(x, bin)) / (std::norm(binAt(x, bin)) + regularisation);
+            setBin(y, bin, ratio);
+        }
+        fft.performRealOnlyInverseTransform(y.data());
+        const int length = jmin(size - sweepLeadSamples, jmax(0, settings.responseLength));
+        std::vector<float> impulseResponse(static_cast<size_t>(sweepLeadSamples + length));
+        std::copy(y.begin() + (size - sweepLeadSamples), y.begin() + size, impulseResponse.begin());
+        std::copy(y.begin(), y.begin() + length, impulseResponse.begin() + sweepLeadSamples);
+        return impulseResponse;
+    }
+
+    // A +-1 sequence of period L has circular autocorrelation L at lag 0 and
+    // -1 elsewhere, so the correlation r with a response to amplitude a is
+    // a((L + 1) h[k] - sum(h)); sum(r) = a sum(h) removes the offset exactly.
+    static std::vector<float> analyseMls(const std::vector<float>& response, const MeasurementSettings& settings)
+    {
+        MaximumLengthSequence sequence;
+        sequence.prepare(settings.mlsOrder);
+        const int period = sequence.getPeriodSamples();
+        if (static_cast<int>(response.size()) < 2 * period || settings.amplitude == 0.0f)
+        {
+            return {};
+        }
+
+        const int order = orderFor(static_cast<size_t>(3 * period));
+        const int size = 1 << order;
+        const dsp::FFT fft(order);
+        std::vector<float> reference(static_cast<size_t>(2 * size), 0.0f);
+        sequence.render(reference.data(), period, 1.0f);
+        // The steady-state second period, twice, so every lag sees a full period
+        std::vector<float> steady(static_cast<size_t>(2 * size), 0.0f);
+        std::copy(response.begin() + period, response.begin() + 2 * period, steady.begin());
+        std::copy(response.begin() + period, response.begin() + 2 * period, steady.begin() + period);
+        fft.performRealOnlyForwardTransform(reference.data());
+        fft.performRealOnlyForwardTransform(steady.data());
+        for (int bin = 0; bin < size; ++bin)
+        {
+            setBin(steady, bin, binAt(steady, bin) * std::conj(binAt(reference, bin)));
+        }
+        fft.performRealOnlyInverseTransform(steady.data());
+
+        double correlationSum = 0.0;
+        for (int lag = 0; lag < period; ++lag)
+        {
+            correlationSum += steady[static_cast<size_t>(lag)];
+        }
+        const size_t length = static_cast<size_t>(jlimit(0, period, settings.responseLength));
+        std::vector<float> impulseResponse(length);
+        const double scale = 1.0 / (static_cast<double>(settings.amplitude) * (period + 1));
+        for (size_t lag = 0; lag < length; ++lag)
+        {
+            impulseResponse[lag] = static_cast<float>((steady[lag] + correlationSum) * scale);
+        }
+        return impulseResponse;
+    }
+
+    // Transfer function from the tone bins of the second period only; the
+    // impulse response and latency are left unmeasured.
+    static void analyseMultitone(const std::vector<float>& excitation,
+                                 const std::vector<float>& response,
+                                 const MeasurementSettings& settings,
+                                 MeasuredResponse& result)
+    {
+        const int order = settings.multitoneOrder;
+        const int period = 1 << order;
+        if (static_cast<int>(excitation.size()) < 2 * period || static_cast<int>(response.size()) < 2 * period)
+        {
+            return;
+        }
+        const dsp::FFT fft(order);
+        std::vector<float> x = padded(excitation.data() + period, static_cast<size_t>(period), period);
+        std::vector<float> y = padded(response.data() + period, static_cast<size_t>(period), period);
+        fft.performRealOnlyForwardTransform(x.data());
+        fft.performRealOnlyForwardTransform(y.data());
+        for (const int bin : MeasurementSignals::toneBins(settings, result.sampleRate))
+        {
+            const std::complex<float> excitationBin = binAt(x, bin);
+            const std::complex<double> ratio = std::norm(excitationBin) > 0.0f
+                                                 ? std::complex<double>(binAt(y, bin) / excitationBin)
+                                                 : std::complex<double>();
+            addPoint(result, bin * result.sampleRate / period, ratio);
+        }
+    }
+
+    // Fills latency, peak and the transfer function from an impulse response
+    // whose time zero is at timeZeroIndex. Latency and peak are searched from
+    // time zero on; the transfer function is the DTFT of the whole response
+    // at each grid frequency.
+    static void describe(std::vector<float> impulseResponse, int timeZeroIndex, const MeasurementSettings& settings, MeasuredResponse& result)
+    {
+        result.impulseResponse = std::move(impulseResponse);
+        result.timeZeroIndex = jlimit(0, static_cast<int>(result.impulseResponse.size()), timeZeroIndex);
+        const std::vector<float>& h = result.impulseResponse;
+        const auto timeZero = h.begin() + result.timeZeroIndex;
+        if (timeZero == h.end())
+        {
+            return;
+        }
+        const auto peak = std::max_element(timeZero, h.end(), [](float a, float b) { return std::abs(a) < std::abs(b); });
+        result.peakIndex = static_cast<int>(peak - timeZero);
+        const float onsetThreshold = std::abs(*peak) * 0.1f;  // -20 dB
+        result.latencySamples = static_cast<int>(std::find_if(timeZero, h.end(), [onsetThreshold](float value)
+        {
+            return std::abs(value) >= onsetThreshold;
+        }) - timeZero);
+        const int delaySamples = result.timeZeroIndex + result.latencySamples;
+
+        const int period = 1 << settings.multitoneOrder;
+        for (const int bin : MeasurementSignals::toneBins(settings, result.sampleRate))
+        {
+            const double frequencyHz = bin * result.sampleRate / period;
+            const double increment = -MathConstants<double>::twoPi * frequencyHz / result.sampleRate;
+            std::complex<double> sum;
+            for (size_t n = 0; n < h.size(); ++n)
+            {
+                // Delay removed: measure phase from the onset
+                sum += static_cast<double>(h[n]) * std::polar(1.0, increment * static_cast<double>(static_cast<int>(n) - delaySamples));
+            }
+            addPoint(result, frequencyHz, sum);
+        }
+    }
+
+private:
+    static std::vector<float> play(const std::vector<float>& excitation,
+                                   int numChannels,
+                                   int blockSize,
+                                   const ProcessBlock& processBlock)
+    {
+        std::vector<float> response(excitation.size());
+        AudioBuffer<float> buffer(numChannels, blockSize);
+        for (size_t position = 0; position < excitation.size(); position += static_cast<size_t>(blockSize))
+        {
+            const int numSamples = static_cast<int>(std::min(static_cast<size_t>(blockSize), excitation.size() - position));
+            AudioBuffer<float> block(buffer.getArrayOfWritePointers(), numChannels, numSamples);
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                block.copyFrom(channel, 0, excitation.data() + position, numSamples);
+            }
+            processBlock(block);
+            FloatVectorOperations::copy(response.data() + position, block.getReadPointer(0), numSamples);
+        }
+        return response;
+    }
+
+    static void addPoint(MeasuredResponse& result, double frequencyHz, std::complex<double> value)
+    {
+        result.frequencyHz.push_back(frequencyHz);
+        result.magnitudeDb.push_back(20.0 * std::log10(jmax(1.0e-12, std::abs(value))));
+        result.phaseDegrees.push_back(radiansToDegrees(std::arg(value)));
+    }
+
+    static int orderFor(size_t numSamples) noexcept
+    {
+        int order = 1;
+        while ((size_t { 1 } << order) < numSamples)
+        {
+            ++order;
+        }
+        return order;
+    }
+
+    // Real-only transforms work in place on 2 * size floats
+    static std::vector<float> padded(const float* samples, size_t numSamples, int size)
+    {
+        std::vector<float> data(static_cast<size_t>(2 * size), 0.0f);
+        std::copy(samples, samples + std::min(numSamples, static_cast<size_t>(size)), data.begin());
+        return data;
+    }
+
+    static std::complex<float> binAt(const std::vector<float>& spectrum, int bin) noexcept
+    {
+        return { spectrum[static_cast<size_t>(2 * bin)], spectrum[static_cast<size_t>(2 * bin + 1)] };
+    }
+
+    static void setBin(std::vector<float>& spectrum, int bin, std::complex<float> value) noexcept
+    {
+        spectrum[static_cast<size_t>(2 * bin)] = value.real();
+        spectrum[static_cast<size_t>(2 * bin + 1)] = value.imag();
+    }
+};
@@ -0,0 +1,402 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "../models/MeasurementSettings.h"
+
+// Measurement excitations shared by the live test-signal generator and
+// MeasurementAnalysis. Each renders a periodic stream block by block and
+// restarts with reset(), so the analysis regenerates exactly what was played.
+// Only prepare() allocates.
+namespace MeasurementSignals
+{
+    // Upper sweep/tone frequency actually used at this rate.
+    inline double clampedEndHz(const MeasurementSettings& settings, double sampleRate) noexcept
+    {
+        return jmin(settings.endHz, 0.45 * sampleRate);
+    }
+
+    // Tone bins of one 2^multitoneOrder period: log spaced at tonesPerOctave
+    // from startHz to the end frequency, snapped to bins, duplicates dropped.
+    // Every analysis reports on bin * sampleRate / period.
+    inline std::vector<int> toneBins(const MeasurementSettings& settings, double sampleRate)
+    {
+        const int periodSamples = 1 << settings.multitoneOrder;
+        const double binHz = sampleRate / periodSamples;
+        const double step = std::pow(2.0, 1.0 / jmax(1, settings.tonesPerOctave));
+        std::vector<int> bins;
+        for (double frequencyHz = settings.startHz; frequencyHz <= clampedEndHz(settings, sampleRate) * 1.0001; frequencyHz *= step)
+        {
+            const int bin = static_cast<int>(std::lround(frequencyHz / binHz));
+            if (bin > 0 && bin < periodSamples / 2 && (bins.empty() || bin != bins.back()))
+            {
+                bins.push_back(bin);
+            }
+        }
+        return bins;
+    }
+}
+
+// Paul Kellet's refined pink filter: seven first-order sections that stay
+// within 0.05 dB of -3 dB/octave above 9.2 Hz (coefficients for 44.1 kHz).
+// Filters white noise in place.
+class KelletPinkFilter
+{
+public:
+    void reset() noexcept
+    {
+        this->state.fill(0.0f);
+    }
+
+    void process(float* samples, int numSamples) noexcept
+    {
+        float b0 = this->state[0], b1 = this->state[1], b2 = this->state[2], b3 = this->state[3];
+        float b4 = this->state[4], b5 = this->state[5], b6 = this->state[6];
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float white = samples[i];
+            b0 = 0.99886f * b0 + white * 0.0555179f;
+            b1 = 0.99332f * b1 + white * 0.0750759f;
+            b2 = 0.96900f * b2 + white * 0.1538520f;
+            b3 = 0.86650f * b3 + white * 0.3104856f;
+            b4 = 0.55000f * b4 + white * 0.5329522f;
+            b5 = -0.7616f * b5 - white * 0.0168980f;
+            samples[i] = (b0 + b1 + b2 + b3 + b4 + b5 + b6 + white * 0.5362f) * outputGain;
+            b6 = white * 0.115926f;
+        }
+        this->state = { b0, b1, b2, b3, b4, b5, b6 };
+    }
+
+private:
+    static constexpr float outputGain = 0.11f;  // roughly the white input's level
+    std::array<float, 7> state {};
+};
+
+// sin(startPhase + phaseScale (exp(logGrowth n) - 1)) for n = 0, 1, ...
+// without a sin per sample. The per-sample phase increment grows by the
+// constant ratio g = exp(logGrowth), so the output phasor is rotated by
+// e^(i increment), that by e^(i increment (g - 1)), and so on down to
+// (g - 1)^order: a binomial expansion of g^n, four complex multiplies per
+// sample. All of them are rebuilt from the closed-form phase on a fixed
+// sample count (not per block, so block sizes do not matter), chosen from the
+// growth so the truncated expansion stays under maxPhaseError.
+class ExponentialChirp
+{
+public:
+    static constexpr int order = 4;
+    static constexpr int maxSamplesPerResync = 256;
+    static constexpr double maxPhaseError = 1.0e-7;
+
+    void start(double newStartPhase, double newPhaseScale, double newLogGrowth) noexcept
+    {
+        this->startPhase = newStartPhase;
+        this->phaseScale = newPhaseScale;
+        this->logGrowth = newLogGrowth;
+        this->position = 0;
+        // The first dropped term accumulates to about
+        // increment (logGrowth m)^order m / (order + 1)! after m samples
+        // (increment <= pi)
+        this->samplesPerResync = maxSamplesPerResync;
+        while (this->samplesPerResync > 1
+               && MathConstants<double>::pi * std::pow(std::abs(this->logGrowth) * this->samplesPerResync, order)
+                      * this->samplesPerResync / 120.0 > maxPhaseError)
+        {
+            this->samplesPerResync /= 2;
+        }
+    }
+
+    // Unwrapped phase of sample n.
+    double phaseAt(long long n) const noexcept
+    {
+        return this->startPhase + this->phaseScale * std::expm1(this->logGrowth * static_cast<double>(n));
+    }
+
+    double next() noexcept
+    {
+        if (this->position % this->samplesPerResync == 0)
+        {
+            this->resync();
+        }
+        const double value = this->phasor.im;
+        this->phasor.rotateBy(this->rotations[0]);
+        for (int level = 1; level < order; ++level)
+        {
+            this->rotations[static_cast<size_t>(level - 1)].rotateBy(this->rotations[static_cast<size_t>(level)]);
+        }
+        ++this->position;
+        return value;
+    }
+
+    long long getPosition() const noexcept
+    {
+        return this->position;
+    }
+
+private:
+    struct Phasor
+    {
+        double re { 1.0 };
+        double im { 0.0 };
+
+        static Phasor fromAngle(double radians) noexcept
+        {
+            return { std::cos(radians), std::sin(radians) };
+        }
+
+        void rotateBy(const Phasor& rotation) noexcept
+        {
+            const double nextRe = this->re * rotation.re - this->im * rotation.im;
+            this->im = this->re * rotation.im + this->im * rotation.re;
+            this->re = nextRe;
+        }
+    };
+
+    void resync() noexcept
+    {
+        const double growthMinusOne = std::expm1(this->logGrowth);
+        double angle = this->phaseScale * std::exp(this->logGrowth * static_cast<double>(this->position)) * growthMinusOne;
+        this->phasor = Phasor::fromAngle(std::fmod(this->phaseAt(this->position), MathConstants<double>::twoPi));
+        for (Phasor& rotation : this->rotations)
+        {
+            rotation = Phasor::fromAngle(angle);
+            angle *= growthMinusOne;
+        }
+    }
+
+    double startPhase { 0.0 };
+    double phaseScale { 0.0 };
+    double logGrowth { 0.0 };
+    long long position { 0 };
+    int samplesPerResync { maxSamplesPerResync };
+    Phasor phasor;
+    std::array<Phasor, order> rotations {};  // e^(i increment (g - 1)^k)
+};
+
+// Synchronized exponential sweep (Novak et al.): the rate L is rounded so
+// startHz * L is a whole number of cycles, which makes the instantaneous phase
+// 2 pi f1 L (exp(t / L) - 1) line up for every harmonic. After deconvolution
+// the linear response sits at time zero and each harmonic at a fixed negative
+// time. One sweep per period, then silence for the response tail; the last
+// 2 ms are faded out. Rendered with ExponentialChirp, so no sin per sample.
+class SyncSweep
+{
+public:
+    void prepare(double sampleRate, const MeasurementSettings& settings)
+    {
+        const double startHz = jmax(1.0, settings.startHz);
+        const double logRatio = std::log(jmax(startHz * 2.0, clampedEnd(settings, sampleRate)) / startHz);
+        const double cycles = jmax(1.0, std::round(startHz * settings.sweepSeconds / logRatio));
+        const double rateSeconds = cycles / startHz;
+        this->sweepSamples = static_cast<int>(std::ceil(rateSeconds * logRatio * sampleRate));
+        this->periodSamples = this->sweepSamples + jmax(0, settings.responseLength);
+        this->phaseScale = MathConstants<double>::twoPi * cycles;
+        this->logGrowth = 1.0 / (rateSeconds * sampleRate);
+        const int fadeSamples = jmax(1, static_cast<int>(sampleRate * 0.002));
+        this->fadeGains.resize(static_cast<size_t>(fadeSamples));
+        for (int remaining = 0; remaining < fadeSamples; ++remaining)
+        {
+            this->fadeGains[static_cast<size_t>(remaining)] = 0.5 - 0.5 * std::cos(MathConstants<double>::pi * remaining / fadeSamples);
+        }
+        this->reset();
+    }
+
+    void reset() noexcept
+    {
+        this->position = 0;
+        this->chirp.start(0.0, this->phaseScale, this->logGrowth);
+    }
+
+    void render(float* destination, int numSamples, float amplitude) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float value = 0.0f;
+            if (this->position < this->sweepSamples)
+            {
+                double sample = this->chirp.next();
+                const int remaining = this->sweepSamples - this->position;
+                if (remaining < static_cast<int>(this->fadeGains.size()))
+                {
+                    sample *= this->fadeGains[static_cast<size_t>(remaining)];
+                }
+                value = static_cast<float>(sample) * amplitude;
+            }
+            destination[i] = value;
+            if (++this->position == this->periodSamples)
+            {
+                this->reset();
+            }
+        }
+    }
+
+    int getSweepSamples() const noexcept
+    {
+        return this->sweepSamples;
+    }
+
+    int getPeriodSamples() const noexcept
+    {
+        return this->periodSamples;
+    }
+
+private:
+    static double clampedEnd(const MeasurementSettings& settings, double sampleRate) noexcept
+    {
+        return MeasurementSignals::clampedEndHz(settings, sampleRate);
+    }
+
+    int sweepSamples { 0 };
+    int periodSamples { 1 };
+    int position { 0 };
+    double phaseScale { 0.0 };  // 2 pi f1 L
+    double logGrowth { 0.0 };   // 1 / (L sampleRate)
+    ExponentialChirp chirp;
+    std::vector<double> fadeGains;  // raised cosine by samples remaining
+};
+
+// Maximum length sequence of +-amplitude from a Fibonacci shift register with
+// primitive feedback taps. Circular correlation of one steady-state period of
+// the response with the sequence gives the impulse response.
+class MaximumLengthSequence
+{
+public:
+    static constexpr int minOrder = 8;
+    static constexpr int maxOrder = 18;
+
+    void prepare(int order) noexcept
+    {
+        this->order = jlimit(minOrder, maxOrder, order);
+        this->taps = tapMasks[static_cast<size_t>(this->order - minOrder)];
+        this->reset();
+    }
+
+    void reset() noexcept
+    {
+        this->state = (1u << this->order) - 1u;
+    }
+
+    void render(float* destination, int numSamples, float amplitude) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            destination[i] = (this->state & 1u) != 0 ? amplitude : -amplitude;
+            const uint32_t feedback = static_cast<uint32_t>(std::popcount(this->state & this->taps)) & 1u;
+            this->state = (this->state >> 1) | (feedback << (this->order - 1));
+        }
+    }
+
+    int getPeriodSamples() const noexcept
+    {
+        return (1 << this->order) - 1;
+    }
+
+private:
+    // Bit k set: stage k feeds back. Orders 8 to 18.
+    static constexpr std::array<uint32_t, maxOrder - minOrder + 1> tapMasks {
+        0x0000001du, 0x00000011u, 0x00000009u, 0x00000005u, 0x00000053u, 0x0000001bu,
+        0x0000002bu, 0x00000003u, 0x0000002du, 0x00000009u, 0x00000081u
+    };
+
+    int order { minOrder };
+    uint32_t taps { tapMasks[0] };
+    uint32_t state { 1u };
+};
+
+// Sum of equal-amplitude cosines on the toneBins() grid with Schroeder phases
+// (low crest factor), one 2^order period precomputed and played in a loop.
+// Every tone completes whole cycles per period, so one steady-state period
+// analyses without a window.
+class Multitone
+{
+public:
+    void prepare(double sampleRate, const MeasurementSettings& settings)
+    {
+        const int periodSamples = 1 << settings.multitoneOrder;
+        const std::vector<int> bins = MeasurementSignals::toneBins(settings, sampleRate);
+        this->table.assign(static_cast<size_t>(periodSamples), 0.0f);
+        std::vector<double> sum(static_cast<size_t>(periodSamples), 0.0);
+        const double numTones = static_cast<double>(jmax<size_t>(1, bins.size()));
+        for (size_t tone = 0; tone < bins.size(); ++tone)
+        {
+            const double phase = -MathConstants<double>::pi * static_cast<double>(tone * tone) / numTones;
+            const double increment = MathConstants<double>::twoPi * bins[tone] / periodSamples;
+            for (int n = 0; n < periodSamples; ++n)
+            {
+                sum[static_cast<size_t>(n)] += std::cos(increment * n + phase);
+            }
+        }
+        double peak = 0.0;
+        for (const double value : sum)
+        {
+            peak = jmax(peak, std::abs(value));
+        }
+        const double scale = peak > 0.0 ? 1.0 / peak : 0.0;
+        for (int n = 0; n < periodSamples; ++n)
+        {
+            this->table[static_cast<size_t>(n)] = static_cast<float>(sum[static_cast<size_t>(n)] * scale);
+        }
+        this->reset();
+    }
+
+    void reset() noexcept
+    {
+        this->position = 0;
+    }
+
+    void render(float* destination, int numSamples, float amplitude) noexcept
+    {
+        const int periodSamples = static_cast<int>(this->table.size());
+        for (int i = 0; i < numSamples; ++i)
+        {
+            destination[i] = periodSamples > 0 ? this->table[static_cast<size_t>(this->position)] * amplitude : 0.0f;
+            this->position = this->position + 1 < periodSamples ? this->position + 1 : 0;
+        }
+    }
+
+    int getPeriodSamples() const noexcept
+    {
+        return static_cast<int>(this->table.size());
+    }
+
+private:
+    std::vector<float> table;  // one period, peak 1
+    int position { 0 };
+};
+
+// One unit impulse every period.
+class ImpulseTrain
+{
+public:
+    void prepare(int periodSamples) noexcept
+    {
+        this->periodSamples = jmax(1, periodSamples);
+        this->reset();
+    }
+
+    void reset() noexcept
+    {
+        this->position = 0;
+    }
+
+    void render(float* destination, int numSamples, float amplitude) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            destination[i] = this->position == 0 ? amplitude : 0.0f;
+            this->position = this->position + 1 < this->periodSamples ? this->position + 1 : 0;
+        }
+    }
+
+    int getPeriodSamples() const noexcept
+    {
+        return this->periodSamples;
+    }
+
+private:
+    int periodSamples { 1 };
+    int position { 0 };
+};
@@ -0,0 +1,282 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "../models/BandAnalysisChunk.h"
+#include "../models/BandFrequencies.h"
+#include "../models/OfflineAnalysisSettings.h"
+#include "CrossoverTree.h"
+#include "SpectrumProcessing.h"
+
+// Per-band level statistics over all analysed frames.
+struct BandLevelStats
+{
+    float mean { 0.0f };
+    float min { 0.0f };
+    float max { 0.0f };
+    float p50 { 0.0f };
+    float p95 { 0.0f };
+};
+
+// Service: offline version of the processor's analysis path.
+// Runs the same chain per frame (mono mix, DC removal, Hann FFT, per-bin power
+// smoothing, guard, triangular smoothing, taper, fractional log-band
+// aggregation, band smoothing) plus the crossover band peak metering,
+// frame by frame from an AudioFormatReader. One instance per worker thread;
+// chunks are independent, so a file can be split across cores and merged in
+// frame order with identical results for any thread count.
+class OfflineBandAnalyzer
+{
+public:
+    OfflineBandAnalyzer(const OfflineAnalysisSettings& analysisSettings, double sampleRate, int numChannels)
+        : settings(analysisSettings),
+          frameSize(1 << analysisSettings.fftOrder),
+          numBins(frameSize / 2),
+          channels(jmax(1, numChannels)),
+          sampleRateHz(sampleRate),
+          fft(analysisSettings.fftOrder),
+          window(static_cast<size_t>(frameSize), dsp::WindowingFunction<float>::hann, false)
+    {
+        const float guard = jlimit(0.0f, 0.2f, this->settings.guardPercent);
+        this->hiGuardBins = jmax(8, static_cast<int>(std::floor(static_cast<double>(this->numBins) * static_cast<double>(guard))));
+        this->allowedEnd = SpectrumProcessing::computeAllowedEndBin(sampleRate, this->frameSize, this->hiGuardBins);
+        this->displayMaxHz = SpectrumProcessing::computeLogBandEdges(sampleRate, this->frameSize, this->hiGuardBins,
+                                                                     this->settings.numBands, this->bandF0Hz,
+                                                                     this->bandF1Hz, this->bandBinStart, this->bandBinEnd);
+        this->dcAlpha = jlimit(0.00001f, 1.0f, static_cast<float>(1.0 - std::exp(-2.0 * MathConstants<double>::pi * 5.0 / sampleRate)));
+
+        this->crossover.prepare(sampleRate, this->channels);
+        this->crossover.setCutoffs(this->settings.crossover.constrainedTo(sampleRate));
+
+        this->frame.setSize(this->channels, this->frameSize);
+        this->mono.assign(static_cast<size_t>(this->frameSize), 0.0f);
+        this->fftData.assign(static_cast<size_t>(2 * this->frameSize), 0.0f);
+        this->powerSmoothed.assign(static_cast<size_t>(this->numBins), 0.0f);
+        this->powerForAggregation.assign(static_cast<size_t>(this->numBins), 0.0f);
+        this->bands.assign(static_cast<size_t>(this->settings.numBands), 0.0f);
+        this->bandsPreSmooth.assign(static_cast<size_t>(this->settings.numBands), 0.0f);
+    }
+
+    int getFrameSize() const noexcept { return this->frameSize; }
+    int getNumBins() const noexcept { return this->numBins; }
+    int getNumBands() const noexcept { return this->settings.numBands; }
+    int getNumMeters() const noexcept { return 1 + this->crossover.getNumBands(); }
+    double getBinHz() const noexcept { return this->sampleRateHz / static_cast<double>(this->frameSize); }
+    double getDisplayMaxHz() const noexcept { return this->displayMaxHz; }
+    const std::vector<double>& getBandStartHz() const noexcept { return this->bandF0Hz; }
+    const std::vector<double>& getBandEndHz() const noexcept { return this->bandF1Hz; }
+
+    static int64 countFrames(int64 lengthInSamples, int fftOrder) noexcept
+    {
+        return lengthInSamples / (static_cast<int64>(1) << fftOrder);
+    }
+
+    // Analyse frames [firstFrame, firstFrame + numFrames) of the reader, after
+    // up to overlapFrames of discarded warm-up. Resets all state first.
+    BandAnalysisChunk analyseChunk(AudioFormatReader& reader, int64 firstFrame, int numFrames)
+    {
+        this->reset();
+        BandAnalysisChunk chunk;
+        chunk.firstFrame = firstFrame;
+        chunk.numMeters = this->getNumMeters();
+        chunk.bands.reserve(static_cast<size_t>(numFrames) * this->bands.size());
+        chunk.meterPeaks.reserve(static_cast<size_t>(numFrames) * static_cast<size_t>(chunk.numMeters));
+        chunk.binPowerSum.assign(static_cast<size_t>(this->numBins), 0.0);
+
+        const int64 warmUpStart = jmax(static_cast<int64>(0), firstFrame - this->settings.overlapFrames);
+        for (int64 frameIndex = warmUpStart; frameIndex < firstFrame + numFrames; ++frameIndex)
+        {
+            reader.read(&this->frame, 0, this->frameSize, frameIndex * this->frameSize, true, true);
+            this->analyseFrame(frameIndex >= firstFrame ? &chunk : nullptr);
+        }
+        return chunk;
+    }
+
+    // Concatenate chunks in frame order and sum their LTAS accumulators.
+    static BandAnalysisChunk mergeChunks(std::vector<BandAnalysisChunk> chunks)
+    {
+        std::sort(chunks.begin(), chunks.end(), [] (const BandAnalysisChunk& a, const BandAnalysisChunk& b)
+        {
+            return a.firstFrame < b.firstFrame;
+        });
+        BandAnalysisChunk merged;
+        for (BandAnalysisChunk& chunk : chunks)
+        {
+            merged.numFrames += chunk.numFrames;
+            merged.numMeters = chunk.numMeters;
+            merged.bands.insert(merged.bands.end(), chunk.bands.begin(), chunk.bands.end());
+            merged.meterPeaks.insert(merged.meterPeaks.end(), chunk.meterPeaks.begin(), chunk.meterPeaks.end());
+            if (merged.binPowerSum.empty())
+            {
+                merged.binPowerSum.assign(chunk.binPowerSum.size(), 0.0);
+            }
+            for (size_t bin = 0; bin < chunk.binPowerSum.size() && bin < merged.binPowerSum.size(); ++bin)
+            {
+                merged.binPowerSum[bin] += chunk.binPowerSum[bin];
+            }
+        }
+        return merged;
+    }
+
+    // Statistics of one column (band or meter) of a row-major numFrames x stride table.
+    static BandLevelStats columnStats(const std::vector<float>& table, int stride, int column)
+    {
+        BandLevelStats stats;
+        const size_t rows = stride > 0 ? table.size() / static_cast<size_t>(stride) : 0;
+        if (rows == 0)
+        {
+            return stats;
+        }
+        std::vector<float> values(rows);
+        double sum = 0.0;
+        for (size_t row = 0; row < rows; ++row)
+        {
+            values[row] = table[row * static_cast<size_t>(stride) + static_cast<size_t>(column)];
+            sum += values[row];
+        }
+        std::sort(values.begin(), values.end());
+        const auto rank = [&values] (double fraction)
+        {
+            return values[static_cast<size_t>(std::round(fraction * static_cast<double>(values.size() - 1)))];
+        };
+        stats.mean = static_cast<float>(sum / static_cast<double>(rows));
+        stats.min = values.front();
+        stats.max = values.back();
+        stats.p50 = rank(0.50);
+        stats.p95 = rank(0.95);
+        return stats;
+    }
+
+    // Long-term average spectrum per band in dB (mean power of the tapered bins).
+    std::vector<float> longTermAverageDb(const BandAnalysisChunk& merged) const
+    {
+        std::vector<float> meanPower(static_cast<size_t>(this->numBins), 0.0f);
+        if (merged.numFrames > 0)
+        {
+            for (size_t bin = 0; bin < meanPower.size() && bin < merged.binPowerSum.size(); ++bin)
+            {
+                meanPower[bin] = static_cast<float>(merged.binPowerSum[bin] / static_cast<double>(merged.numFrames));
+            }
+        }
+        std::vector<float> ltasDb(this->bands.size(), -120.0f);
+        for (int band = 0; band < this->getNumBands(); ++band)
+        {
+            const double power = SpectrumProcessing::bandMeanPower(meanPower, this->allowedEnd, this->getBinHz(),
+                                                                   this->bandF0Hz, this->bandF1Hz, band);
+            ltasDb[static_cast<size_t>(band)] = power > 1.0e-12 ? static_cast<float>(10.0 * std::log10(power)) : -120.0f;
+        }
+        return ltasDb;
+    }
+
+private:
+    void reset()
+    {
+        this->crossover.reset();
+        std::fill(this->powerSmoothed.begin(), this->powerSmoothed.end(), 0.0f);
+        this->dcMean = 0.0f;
+    }
+
+    void analyseFrame(BandAnalysisChunk* keep)
+    {
+        // Crossover metering as in processBlock: total peak, then one per band
+        std::array<float, 1 + CrossoverTree::maxBands> peaks {};
+        for (int channel = 0; channel < this->channels; ++channel)
+        {
+            const float* samples = this->frame.getReadPointer(channel);
+            for (int sampleIndex = 0; sampleIndex < this->frameSize; ++sampleIndex)
+            {
+                peaks[0] = jmax(peaks[0], std::abs(samples[sampleIndex]));
+            }
+        }
+        CrossoverTree::BandTaps taps;
+        taps.peaks = peaks.data() + 1;
+        this->crossover.process(this->frame.getArrayOfReadPointers(), nullptr, this->channels, 0, this->frameSize, -1, taps);
+
+        // Mono mixdown with DC removal, then the windowed FFT
+        const float channelScale = 1.0f / static_cast<float>(this->channels);
+        for (int sampleIndex = 0; sampleIndex < this->frameSize; ++sampleIndex)
+        {
+            float mixedSample = 0.0f;
+            for (int channel = 0; channel < this->channels; ++channel)
+            {
+                mixedSample += this->frame.getReadPointer(channel)[sampleIndex];
+            }
+            mixedSample *= channelScale;
+            this->dcMean += this->dcAlpha * (mixedSample - this->dcMean);
+            this->mono[static_cast<size_t>(sampleIndex)] = mixedSample - this->dcMean;
+        }
+        this->window.multiplyWithWindowingTable(this->mono.data(), static_cast<size_t>(this->frameSize));
+        std::fill(this->fftData.begin(), this->fftData.end(), 0.0f);
+        for (int sampleIndex = 0; sampleIndex < this->frameSize; ++sampleIndex)
+        {
+            this->fftData[static_cast<size_t>(2 * sampleIndex)] = this->mono[static_cast<size_t>(sampleIndex)];
+        }
+        this->fft.performRealOnlyForwardTransform(this->fftData.data(), true);
+
+        const float perBinScale = 4.0f / static_cast<float>(this->frameSize);
+        const float smoothingCoeff = jlimit(0.0f, 1.0f, this->settings.specSmoothing);
+        for (int bin = 0; bin < this->numBins; ++bin)
+        {
+            const float real = this->fftData[static_cast<size_t>(2 * bin)];
+            const float imag = this->fftData[static_cast<size_t>(2 * bin + 1)];
+            const float mag = std::sqrt(real * real + imag * imag) * perBinScale;
+            float& smoothed = this->powerSmoothed[static_cast<size_t>(bin)];
+            smoothed = smoothed * (1.0f - smoothingCoeff) + mag * mag * smoothingCoeff;
+        }
+
+        SpectrumProcessing::zeroStrictlyAbove(this->powerSmoothed, this->allowedEnd);
+        SpectrumProcessing::frequencySmoothTriangularIfEnabled(this->powerSmoothed, this->powerForAggregation,
+                                                               this->allowedEnd, this->settings.freqSmoothEnabled);
+        SpectrumProcessing::applyCosineTaper(this->powerForAggregation, this->allowedEnd, this->settings.taperPercent);
+        SpectrumProcessing::zeroStrictlyAbove(this->powerForAggregation, this->allowedEnd);
+        SpectrumProcessing::aggregateBandsFractional(this->powerForAggregation, this->allowedEnd, this->getBinHz(),
+                                                     this->bandF0Hz, this->bandF1Hz, -120.0f, 0.0f,
+                                                     this->bands, this->bandsPreSmooth);
+        SpectrumProcessing::smoothBandsInPlace(this->bands, this->settings.bandSmoothEnabled);
+
+        if (keep == nullptr)
+        {
+            return;
+        }
+        ++keep->numFrames;
+        keep->bands.insert(keep->bands.end(), this->bands.begin(), this->bands.end());
+        keep->meterPeaks.insert(keep->meterPeaks.end(), peaks.begin(), peaks.begin() + this->getNumMeters());
+        for (int bin = 0; bin < this->numBins; ++bin)
+        {
+            keep->binPowerSum[static_cast<size_t>(bin)] += this->powerForAggregation[static_cast<size_t>(bin)];
+        }
+    }
+
+    OfflineAnalysisSettings settings;
+    const int frameSize;
+    const int numBins;
+    const int channels;
+    const double sampleRateHz;
+    int hiGuardBins { 8 };
+    int allowedEnd { 0 };
+    double displayMaxHz { 20000.0 };
+
+    dsp::FFT fft;
+    dsp::WindowingFunction<float> window;
+    CrossoverTree crossover;
+    float dcMean { 0.0f };
+    float dcAlpha { 0.0f };
+
+    AudioBuffer<float> frame;
+    std::vector<float> mono;
+    std::vector<float> fftData;
+    std::vector<float> powerSmoothed;
+    std::vector<float> powerForAggregation;
+    std::vector<float> bands;
+    std::vector<float> bandsPreSmooth;
+    std::vector<double> bandF0Hz;
+    std::vector<double> bandF1Hz;
+    std::vector<int> bandBinStart;
+    std::vector<int> bandBinEnd;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OfflineBandAnalyzer)
+};
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include "../models/PipelineStage.h"
+#include "../models/SpectrumFrameView.h"
+#include "SpectrumFrameExchange.h"
+
+// Service: full-width capture of every spectrum pipeline stage.
+// Each stage owns a SpectrumFrameExchange sized once in prepare() (per-bin
+// stages hold numBins values, band stages numBands), so capturing on the
+// audio thread is a copy into a preallocated slot plus one atomic swap:
+// no locks and no allocations. Stages are enabled by a bitmask of
+// pipelineStageBit() values and cost nothing while disabled.
+class PipelineCapture
+{
+public:
+    // Size the per-stage storage. Call from prepareToPlay; storage is only
+    // reallocated when the capacity actually changes, so readers that started
+    // after the first prepare keep valid slots across later prepares.
+    void prepare(int numBins, int numBands)
+    {
+        for (int stageIndex = 0; stageIndex < numPipelineStages; ++stageIndex)
+        {
+            const auto stage = static_cast<PipelineStage>(stageIndex);
+            const int capacity = isPerBinStage(stage) ? numBins : numBands;
+            SpectrumFrameExchange& exchange = this->stages[static_cast<size_t>(stageIndex)];
+            if (exchange.getCapacity() != capacity)
+            {
+                exchange.allocate(capacity);
+            }
+        }
+    }
+
+    // Heap bytes held by all stages.
+    size_t getStorageBytes() const noexcept
+    {
+        size_t bytes = 0;
+        for (const SpectrumFrameExchange& exchange : this->stages)
+        {
+            bytes += exchange.getStorageBytes();
+        }
+        return bytes;
+    }
+
+    void setStageMask(uint32_t mask) noexcept
+    {
+        this->stageMask.store(mask & allPipelineStages, std::memory_order_relaxed);
+    }
+
+    uint32_t getStageMask() const noexcept
+    {
+        return this->stageMask.load(std::memory_order_relaxed);
+    }
+
+    bool isEnabled(PipelineStage stage) const noexcept
+    {
+        return (this->getStageMask() & pipelineStageBit(stage)) != 0;
+    }
+
+    // ===== Producer (audio thread) =====
+
+    // Slot for numValues of the given stage, or nullptr when the stage is disabled
+    // or does not fit. A non-null result must be followed by publish(stage).
+    float* beginStage(PipelineStage stage, int numValues) noexcept
+    {
+        if (!this->isEnabled(stage))
+        {
+            return nullptr;
+        }
+        return this->stages[static_cast<size_t>(stage)].beginWrite(numValues);
+    }
+
+    void publish(PipelineStage stage) noexcept
+    {
+        this->stages[static_cast<size_t>(stage)].publish();
+    }
+
+    // Copy a finished stage buffer if the stage is enabled.
+    void capture(PipelineStage stage, const float* values, int numValues) noexcept
+    {
+        if (float* slot = this->beginStage(stage, numValues))
+        {
+            FloatVectorOperations::copy(slot, values, numValues);
+            this->publish(stage);
+        }
+    }
+
+    // ===== Consumer (one reader per stage) =====
+
+    // Newest frame of a stage, read in place; empty until the stage was captured.
+    SpectrumFrameView acquire(PipelineStage stage) noexcept
+    {
+        return this->stages[static_cast<size_t>(stage)].acquireLatest();
+    }
+
+private:
+    std::array<SpectrumFrameExchange, numPipelineStages> stages;
+    std::atomic<uint32_t> stageMask { 0 };
+};
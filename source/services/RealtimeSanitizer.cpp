@@ -0,0 +1,403 @@
+#include "RealtimeSanitizer.h"
+
+#if TRINITY_RT_SANITIZER
+
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+
+#if defined(__GLIBC__)
+ #include <cerrno>
+ #include <dlfcn.h>
+ #include <pthread.h>
+ #include <semaphore.h>
+
+// glibc's own allocator entry points, used to forward the interposed
+// malloc family without recursing into it.
+extern "C"
+{
+    void* __libc_malloc(size_t bytes);
+    void* __libc_calloc(size_t count, size_t bytes);
+    void* __libc_realloc(void* pointer, size_t bytes);
+    void* __libc_memalign(size_t alignment, size_t bytes);
+    void __libc_free(void* pointer);
+}
+#endif
+
+namespace
+{
+    // Plain thread_locals: constant-initialised, so touching them from inside
+    // malloc never allocates.
+    thread_local int realtimeDepth = 0;
+    thread_local bool reporting = false;
+    std::atomic<int> violationCount { 0 };
+
+    struct ViolationLog
+    {
+        std::mutex lock;
+        std::vector<RealtimeViolation> violations;
+    };
+
+    ViolationLog& getViolationLog()
+    {
+        static ViolationLog log;
+        return log;
+    }
+
+    const char* kindName(RealtimeViolationKind kind) noexcept
+    {
+        switch (kind)
+        {
+            case RealtimeViolationKind::Allocation:   return "allocation";
+            case RealtimeViolationKind::Deallocation: return "deallocation";
+            case RealtimeViolationKind::Lock:         return "lock";
+        }
+        return "unknown";
+    }
+
+    void* rawAllocate(size_t bytes) noexcept
+    {
+       #if defined(__GLIBC__)
+        return __libc_malloc(bytes);
+       #else
+        return std::malloc(bytes);
+       #endif
+    }
+
+    void* rawAllocateAligned(size_t bytes, size_t alignment) noexcept
+    {
+       #if defined(__GLIBC__)
+        return __libc_memalign(alignment, bytes);
+       #else
+        void* pointer = nullptr;
+        return posix_memalign(&pointer, jmax(alignment, sizeof(void*)), bytes) == 0 ? pointer : nullptr;
+       #endif
+    }
+
+    void rawFree(void* pointer) noexcept
+    {
+       #if defined(__GLIBC__)
+        __libc_free(pointer);
+       #else
+        std::free(pointer);
+       #endif
+    }
+
+    void* checkedNew(size_t bytes, const char* function)
+    {
+        RealtimeSanitizer::reportViolation(RealtimeViolationKind::Allocation, function, bytes);
+        if (void* pointer = rawAllocate(bytes == 0 ? 1 : bytes))
+        {
+            return pointer;
+        }
+        throw std::bad_alloc();
+    }
+
+    void* checkedNewAligned(size_t bytes, std::align_val_t alignment, const char* function)
+    {
+        RealtimeSanitizer::reportViolation(RealtimeViolationKind::Allocation, function, bytes);
+        if (void* pointer = rawAllocateAligned(bytes == 0 ? 1 : bytes, static_cast<size_t>(alignment)))
+        {
+            return pointer;
+        }
+        throw std::bad_alloc();
+    }
+
+    void checkedDelete(void* pointer, const char* function) noexcept
+    {
+        if (pointer != nullptr)
+        {
+            RealtimeSanitizer::reportViolation(RealtimeViolationKind::Deallocation, function, 0);
+            rawFree(pointer);
+        }
+    }
+}
+
+void RealtimeSanitizer::enterRealtime() noexcept
+{
+    ++realtimeDepth;
+}
+
+void RealtimeSanitizer::exitRealtime() noexcept
+{
+    --realtimeDepth;
+}
+
+bool RealtimeSanitizer::isRealtimeThread() noexcept
+{
+    return realtimeDepth > 0;
+}
+
+void RealtimeSanitizer::reportViolation(RealtimeViolationKind kind, const char* function, size_t bytes) noexcept
+{
+    // Recording allocates and locks itself; those calls must not recurse.
+    if (realtimeDepth == 0 || reporting)
+    {
+        return;
+    }
+    reporting = true;
+    if (violationCount.fetch_add(1) < maxRecordedViolations)
+    {
+        try
+        {
+            RealtimeViolation violation;
+            violation.kind = kind;
+            violation.function = function;
+            violation.bytes = bytes;
+            violation.stackTrace = SystemStats::getStackBacktrace();
+
+            ViolationLog& log = getViolationLog();
+            const std::lock_guard<std::mutex> guard(log.lock);
+            log.violations.push_back(std::move(violation));
+        }
+        catch (...)
+        {
+        }
+    }
+    reporting = false;
+}
+
+int RealtimeSanitizer::getViolationCount() noexcept
+{
+    return violationCount.load();
+}
+
+std::vector<RealtimeViolation> RealtimeSanitizer::getViolations()
+{
+    ViolationLog& log = getViolationLog();
+    const std::lock_guard<std::mutex> guard(log.lock);
+    return log.violations;
+}
+
+void RealtimeSanitizer::reset()
+{
+    ViolationLog& log = getViolationLog();
+    const std::lock_guard<std::mutex> guard(log.lock);
+    log.violations.clear();
+    violationCount.store(0);
+}
+
+String RealtimeSanitizer::describeViolations()
+{
+    String description;
+    for (const RealtimeViolation& violation : getViolations())
+    {
+        description << kindName(violation.kind) << " in real-time section: " << violation.function;
+        if (violation.bytes > 0)
+        {
+            description << " (" << static_cast<int64>(violation.bytes) << " bytes)";
+        }
+        description << newLine << violation.stackTrace << newLine;
+    }
+    return description;
+}
+
+// ===== Global operator new/delete =====
+
+void* operator new(size_t bytes)                                          { return checkedNew(bytes, "operator new"); }
+void* operator new[](size_t bytes)                                        { return checkedNew(bytes, "operator new[]"); }
+void* operator new(size_t bytes, std::align_val_t alignment)              { return checkedNewAligned(bytes, alignment, "operator new"); }
+void* operator new[](size_t bytes, std::align_val_t alignment)            { return checkedNewAligned(bytes, alignment, "operator new[]"); }
+
+void* operator new(size_t bytes, const std::nothrow_t&) noexcept
+{
+    RealtimeSanitizer::reportViolation(RealtimeViolationKind::Allocation, "operator new(nothrow)", bytes);
+    return rawAllocate(bytes == 0 ? 1 : bytes);
+}
+
+void* operator new[](size_t bytes, const std::nothrow_t&) noexcept
+{
+    RealtimeSanitizer::reportViolation(RealtimeViolationKind::Allocation, "operator new[](nothrow)", bytes);
+    return rawAllocate(bytes == 0 ? 1 : bytes);
+}
+
+void operator delete(void* pointer) noexcept                                          { checkedDelete(pointer, "operator delete"); }
+void operator delete[](void* pointer) noexcept                                        { checkedDelete(pointer, "operator delete[]"); }
+void operator delete(void* pointer, size_t) noexcept                                  { checkedDelete(pointer, "operator delete"); }
+void operator delete[](void* pointer, size_t) noexcept                                { checkedDelete(pointer, "operator delete[]"); }
+void operator delete(void* pointer, std::align_val_t) noexcept                        { checkedDelete(pointer, "operator delete"); }
+void operator delete[](void* pointer, std::align_val_t) noexcept                      { checkedDelete(pointer, "operator delete[]"); }
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept                { checkedDelete(pointer, "operator delete"); }
+void operator delete[](void* pointer, size_t, std::align_val_t) noexcept              { checkedDelete(pointer, "operator delete[]"); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept                   { checkedDelete(pointer, "operator delete"); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept                 { checkedDelete(pointer, "operator delete[]"); }
+
+// ===== C allocator and lock interposition (glibc) =====
+// Symbols defined in the executable take precedence over libc's, so these
+// also see calls made from inside JUCE, libstdc++ and spdlog.
+
+#if defined(__GLIBC__)
+namespace
+{
+    template <typename Function>
+    Function resolveNext(std::atomic<Function>& cache, const char* name) noexcept
+    {
+        Function function = cache.load(std::memory_order_acquire);
+        if (function == nullptr)
+        {
+            function = reinterpret_cast<Function>(dlsym(RTLD_NEXT, name));
+            cache.store(function, std::memory_order_release);
+        }
+        return function;
+    }
+
+    // pthread_cond_* keep a pre-2.3.2 compatibility version on some targets,
+    // which plain dlsym may return; ask for the current one first.
+    template <typename Function>
+    Function resolveNextCondition(std::atomic<Function>& cache, const char* name) noexcept
+    {
+        Function function = cache.load(std::memory_order_acquire);
+        if (function == nullptr)
+        {
+            function = reinterpret_cast<Function>(dlvsym(RTLD_NEXT, name, "GLIBC_2.3.2"));
+            if (function == nullptr)
+            {
+                function = reinterpret_cast<Function>(dlsym(RTLD_NEXT, name));
+            }
+            cache.store(function, std::memory_order_release);
+        }
+        return function;
+    }
+
+    using MutexLockFunction = int (*)(pthread_mutex_t*);
+    using RwLockFunction = int (*)(pthread_rwlock_t*);
+    using ConditionWaitFunction = int (*)(pthread_cond_t*, pthread_mutex_t*);
+    using ConditionTimedWaitFunction = int (*)(pthread_cond_t*, pthread_mutex_t*, const timespec*);
+    using SemaphoreWaitFunction = int (*)(sem_t*);
+    using SemaphoreTimedWaitFunction = int (*)(sem_t*, const timespec*);
+    std::atomic<MutexLockFunction> nextMutexLock { nullptr };
+    std::atomic<RwLockFunction> nextRwLockRead { nullptr };
+    std::atomic<RwLockFunction> nextRwLockWrite { nullptr };
+    std::atomic<ConditionWaitFunction> nextConditionWait { nullptr };
+    std::atomic<ConditionTimedWaitFunction> nextConditionTimedWait { nullptr };
+    std::atomic<SemaphoreWaitFunction> nextSemaphoreWait { nullptr };
+    std::atomic<SemaphoreTimedWaitFunction> nextSemaphoreTimedWait { nullptr };
+   #if __GLIBC_PREREQ(2, 30)
+    using ConditionClockWaitFunction = int (*)(pthread_cond_t*, pthread_mutex_t*, clockid_t, const timespec*);
+    std::atomic<ConditionClockWaitFunction> nextConditionClockWait { nullptr };
+   #endif
+
+    bool isValidAlignment(size_t alignment) noexcept
+    {
+        return alignment != 0 && (alignment & (alignment - 1)) == 0;
+    }
+}
+
+extern "C"
+{
+    void* malloc(size_t bytes) noexcept
+    {
+        RealtimeSanitizer::reportViolation(RealtimeViolationKind::Allocation, "malloc", bytes);
+        return __libc_malloc(bytes);
+    }
+
+    void* calloc(size_t count, size_t bytes) noexcept
+    {
+        RealtimeSanitizer::reportViolation(RealtimeViolationKind::Allocation, "calloc", count * bytes);
+        return __libc_calloc(count, bytes);
+    }
+
+    void* realloc(void* pointer, size_t bytes) noexcept
+    {
+        RealtimeSanitizer::reportViolation(RealtimeViolationKind::Allocation, "realloc", bytes);
+        return __libc_realloc(pointer, bytes);
+    }
+
+    int posix_memalign(void** pointer, size_t alignment, size_t bytes) noexcept
+    {
+        RealtimeSanitizer::reportViolation(RealtimeViolationKind::Allocation, "posix_memalign", bytes);
+        if (!isValidAlignment(alignment) || alignment % sizeof(void*) != 0)
+        {
+            return EINVAL;
+        }
+        void* allocated = __libc_memalign(alignment, bytes);
+        if (allocated == nullptr)
+        {
+            return ENOMEM;
+        }
+        *pointer = allocated;
+        return 0;
+    }
+
+    void* aligned_alloc(size_t alignment, size_t bytes) noexcept
+    {
+        RealtimeSanitizer::reportViolation(RealtimeViolationKind::Allocation, "aligned_alloc", bytes);
+        if (!isValidAlignment(alignment))
+        {
+            errno = EINVAL;
+            return nullptr;
+        }
+        return __libc_memalign(alignment, bytes);
+    }
+
+    void* memalign(size_t alignment, size_t bytes) noexcept
+    {
+        RealtimeSanitizer::reportViolation(RealtimeViolationKind::Allocation, "memalign", bytes);
+        return __libc_memalign(alignment, bytes);
+    }
+
+    void free(void* pointer) noexcept
+    {
+        if (pointer != nullptr)
+        {
+            RealtimeSanitizer::reportViolation(RealtimeViolationKind::Deallocation, "free", 0);
+        }
+        __libc_free(pointer);
+    }
+
+    int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept
+    {
+        RealtimeSanitizer::reportViolation(RealtimeViolationKind::Lock, "pthread_mutex_lock", 0);
+        return resolveNext(nextMutexLock, "pthread_mutex_lock")(mutex);
+    }
+
+    int pthread_rwlock_rdlock(pthread_rwlock_t* lock) noexcept
+    {
+        RealtimeSanitizer::reportViolation(RealtimeViolationKind::Lock, "pthread_rwlock_rdlock", 0);
+        return resolveNext(nextRwLockRead, "pthread_rwlock_rdlock")(lock);
+    }
+
+    int pthread_rwlock_wrlock(pthread_rwlock_t* lock) noexcept
+    {
+        RealtimeSanitizer::reportViolation(RealtimeViolationKind::Lock, "pthread_rwlock_wrlock", 0);
+        return resolveNext(nextRwLockWrite, "pthread_rwlock_wrlock")(lock);
+    }
+
+    // Waits block by definition; cancellation points, hence not noexcept
+    int pthread_cond_wait(pthread_cond_t* condition, pthread_mutex_t* mutex)
+    {
+        RealtimeSanitizer::reportViolation(RealtimeViolationKind::Lock, "pthread_cond_wait", 0);
+        return resolveNextCondition(nextConditionWait, "pthread_cond_wait")(condition, mutex);
+    }
+
+    int pthread_cond_timedwait(pthread_cond_t* condition, pthread_mutex_t* mutex, const timespec* deadline)
+    {
+        RealtimeSanitizer::reportViolation(RealtimeViolationKind::Lock, "pthread_cond_timedwait", 0);
+        return resolveNextCondition(nextConditionTimedWait, "pthread_cond_timedwait")(condition, mutex, deadline);
+    }
+
+   #if __GLIBC_PREREQ(2, 30)
+    // What std::condition_variable's timed waits call on current glibc
+    int pthread_cond_clockwait(pthread_cond_t* condition, pthread_mutex_t* mutex, clockid_t clock, const timespec* deadline)
+    {
+        RealtimeSanitizer::reportViolation(RealtimeViolationKind::Lock, "pthread_cond_clockwait", 0);
+        return resolveNext(nextConditionClockWait, "pthread_cond_clockwait")(condition, mutex, clock, deadline);
+    }
+   #endif
+
+    int sem_wait(sem_t* semaphore)
+    {
+        RealtimeSanitizer::reportViolation(RealtimeViolationKind::Lock, "sem_wait", 0);
+        return resolveNext(nextSemaphoreWait, "sem_wait")(semaphore);
+    }
+
+    int sem_timedwait(sem_t* semaphore, const timespec* deadline)
+    {
+        RealtimeSanitizer::reportViolation(RealtimeViolationKind::Lock, "sem_timedwait", 0);
+        return resolveNext(nextSemaphoreTimedWait, "sem_timedwait")(semaphore, deadline);
+    }
+}
+#endif
+
+#endif
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <cstddef>
+#include <vector>
+
+// Test-mode real-time safety instrumentation.
+// Builds that define TRINITY_RT_SANITIZER=1 (the unit tests) link
+// RealtimeSanitizer.cpp, which replaces global operator new/delete and, on
+// glibc, malloc/calloc/realloc/free, posix_memalign/aligned_alloc/memalign,
+// pthread_mutex_lock, the rwlock locks, the pthread_cond waits and
+// sem_wait/sem_timedwait. While a thread is inside a ScopedRealtimeSection
+// every such call is recorded as a violation with a stack trace; try-locks,
+// spin locks and raw futex calls are not seen. processBlock opens a section
+// through TRINITY_REALTIME_SCOPE, which compiles to nothing in plugin builds.
+enum class RealtimeViolationKind
+{
+    Allocation,
+    Deallocation,
+    Lock            // a lock or a blocking wait
+};
+
+struct RealtimeViolation
+{
+    RealtimeViolationKind kind { RealtimeViolationKind::Allocation };
+    String function;        // intercepted call, e.g. "operator new" or "pthread_mutex_lock"
+    size_t bytes { 0 };     // requested size for allocations
+    String stackTrace;
+};
+
+struct RealtimeSanitizer
+{
+    // Only the first violations keep their stack trace; all are counted.
+    static constexpr int maxRecordedViolations = 64;
+
+    // Marks the calling thread as real-time; sections nest.
+    static void enterRealtime() noexcept;
+    static void exitRealtime() noexcept;
+    static bool isRealtimeThread() noexcept;
+
+    // Called by the interceptors; ignored outside a real-time section.
+    static void reportViolation(RealtimeViolationKind kind, const char* function, size_t bytes) noexcept;
+
+    static int getViolationCount() noexcept;
+    static std::vector<RealtimeViolation> getViolations();
+    static void reset();
+
+    // One line per recorded violation followed by its stack trace.
+    static String describeViolations();
+
+    struct ScopedRealtimeSection
+    {
+        ScopedRealtimeSection() noexcept { RealtimeSanitizer::enterRealtime(); }
+        ~ScopedRealtimeSection() { RealtimeSanitizer::exitRealtime(); }
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedRealtimeSection)
+    };
+};
+
+#if TRINITY_RT_SANITIZER
+ #define TRINITY_REALTIME_SCOPE const RealtimeSanitizer::ScopedRealtimeSection trinityRealtimeSection
+#else
+ #define TRINITY_REALTIME_SCOPE do {} while (false)
+#endif
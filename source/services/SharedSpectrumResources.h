@@ -0,0 +1,119 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include "../models/SpectrumBandLayout.h"
+#include "SpectrumProcessing.h"
+
+// Service: process-wide cache of the immutable analysis resources every
+// processor instance would otherwise build for itself: window tables and
+// log-band layouts. Entries are keyed by exactly what they depend
+// on and held weakly, so an object lives as long as some instance still uses
+// it and the next request after that builds a fresh one. Lookups lock a
+// mutex and may allocate: call them from prepareToPlay or the message thread,
+// never from processBlock. The objects handed out are const and only read,
+// so concurrent audio threads can share them. FFT plans are deliberately not
+// shared: a JUCE fallback FFT serialises its transforms on a spin lock, so
+// every instance keeps its own.
+class SharedSpectrumResources
+{
+public:
+    using Window = dsp::WindowingFunction<float>;
+
+    static std::shared_ptr<const Window> getWindow(int size, Window::WindowingMethod method, bool normalise)
+    {
+        Caches& caches = getCaches();
+        return findOrCreate(caches, caches.windows, WindowKey { size, static_cast<int>(method), normalise }, [=]
+        {
+            return std::make_shared<Window>(static_cast<size_t>(size), method, normalise);
+        });
+    }
+
+    static std::shared_ptr<const SpectrumBandLayout> getBandLayout(double sampleRate, int fftSize, int hiGuardBins, int numBands)
+    {
+        Caches& caches = getCaches();
+        return findOrCreate(caches, caches.layouts, LayoutKey { sampleRate, fftSize, hiGuardBins, numBands }, [=]
+        {
+            auto layout = std::make_shared<SpectrumBandLayout>();
+            layout->sampleRate = sampleRate;
+            layout->fftSize = fftSize;
+            layout->hiGuardBins = hiGuardBins;
+            layout->numBands = numBands;
+            layout->displayMaxHz = SpectrumProcessing::computeLogBandEdges(sampleRate,
+                                                                           fftSize,
+                                                                           hiGuardBins,
+                                                                           numBands,
+                                                                           layout->bandF0Hz,
+                                                                           layout->bandF1Hz,
+                                                                           layout->bandBinStart,
+                                                                           layout->bandBinEnd);
+            return layout;
+        });
+    }
+
+    // Cached objects still in use by someone (diagnostics and tests).
+    static int getLiveEntryCount()
+    {
+        Caches& caches = getCaches();
+        const std::lock_guard<std::mutex> lock(caches.mutex);
+        return countLive(caches.windows) + countLive(caches.layouts);
+    }
+
+private:
+    using WindowKey = std::tuple<int, int, bool>;               // size, method, normalise
+    using LayoutKey = std::tuple<double, int, int, int>;        // sample rate, FFT size, guard bins, bands
+
+    struct Caches
+    {
+        std::mutex mutex;
+        std::map<WindowKey, std::weak_ptr<const Window>> windows;
+        std::map<LayoutKey, std::weak_ptr<const SpectrumBandLayout>> layouts;
+    };
+
+    static Caches& getCaches()
+    {
+        static Caches caches;
+        return caches;
+    }
+
+    // Built under the lock, so racing instances never construct the same entry twice
+    template <typename Key, typename Value, typename Factory>
+    static std::shared_ptr<const Value> findOrCreate(Caches& caches,
+                                                     std::map<Key, std::weak_ptr<const Value>>& cache,
+                                                     const Key& key,
+                                                     Factory&& create)
+    {
+        const std::lock_guard<std::mutex> lock(caches.mutex);
+        if (std::shared_ptr<const Value> existing = cache[key].lock())
+        {
+            return existing;
+        }
+        pruneExpired(cache);
+        std::shared_ptr<const Value> created = create();
+        cache[key] = created;
+        return created;
+    }
+
+    template <typename Map>
+    static void pruneExpired(Map& cache)
+    {
+        for (auto entry = cache.begin(); entry != cache.end();)
+        {
+            entry = entry->second.expired() ? cache.erase(entry) : std::next(entry);
+        }
+    }
+
+    template <typename Map>
+    static int countLive(const Map& cache)
+    {
+        int live = 0;
+        for (const auto& entry : cache)
+        {
+            live += entry.second.expired() ? 0 : 1;
+        }
+        return live;
+    }
+};
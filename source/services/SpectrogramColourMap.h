@@ -0,0 +1,38 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include "LevelColourScale.h"
+
+// Precomputed colour LUT for the spectrogram. Hue follows LevelColourScale so
+// the history reads like the meters (green -> yellow -> red); brightness ramps
+// with level so quiet regions fade to black. Lookups are a single index.
+struct SpectrogramColourMap
+{
+    static constexpr int size = 256;
+    static constexpr float minDb = -120.0f;
+    static constexpr float maxDb = 0.0f;
+
+    using Lut = std::array<PixelARGB, size>;
+
+    static Lut build() noexcept
+    {
+        Lut lut {};
+        for (int index = 0; index < size; ++index)
+        {
+            const float normalised = static_cast<float>(index) / static_cast<float>(size - 1);
+            const float decibels = jmap(normalised, minDb, maxDb);
+            const float brightness = std::pow(normalised, 1.6f);
+            const Colour colour = LevelColourScale::colourForDb(decibels).withMultipliedBrightness(brightness);
+            lut[static_cast<size_t>(index)] = colour.getPixelARGB();
+        }
+        return lut;
+    }
+
+    // Normalised magnitude [0..1] to LUT index.
+    static int indexFor(float normalised) noexcept
+    {
+        const float clamped = jlimit(0.0f, 1.0f, normalised);
+        return static_cast<int>(clamped * static_cast<float>(size - 1) + 0.5f);
+    }
+};
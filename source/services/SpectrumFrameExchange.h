@@ -0,0 +1,102 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include "../models/SpectrumFrameView.h"
+
+// Service: single-producer/single-consumer triple buffer for analysis frames.
+// The audio thread fills its back slot and publishes it with one atomic swap;
+// the UI takes the newest slot the same way and reads it in place. Each side
+// owns its slot exclusively between swaps, so publishing and reading need no
+// lock, copy or allocation. Sequence numbers let the reader skip repeated
+// frames and count frames it never saw.
+class SpectrumFrameExchange
+{
+public:
+    // Size all slots. Not thread-safe: call before the producer and consumer start.
+    void allocate(int maxValues)
+    {
+        for (Slot& slot : this->slots)
+        {
+            slot.values.assign(static_cast<size_t>(maxValues), 0.0f);
+            slot.numValues = 0;
+            slot.sequence = 0;
+        }
+        this->writeIndex = 0;
+        this->readIndex = 1;
+        this->latest.store(2, std::memory_order_release);
+        this->lastSequence = 0;
+    }
+
+    int getCapacity() const noexcept
+    {
+        return static_cast<int>(this->slots[0].values.size());
+    }
+
+    // Heap bytes held by all slots.
+    size_t getStorageBytes() const noexcept
+    {
+        size_t bytes = 0;
+        for (const Slot& slot : this->slots)
+        {
+            bytes += slot.values.capacity() * sizeof(float);
+        }
+        return bytes;
+    }
+
+    // ===== Producer (audio thread) =====
+
+    // Back slot storage for a frame of numValues, or nullptr if it does not fit.
+    float* beginWrite(int numValues) noexcept
+    {
+        Slot& slot = this->slots[static_cast<size_t>(this->writeIndex)];
+        if (numValues <= 0 || numValues > static_cast<int>(slot.values.size()))
+        {
+            return nullptr;
+        }
+        slot.numValues = numValues;
+        return slot.values.data();
+    }
+
+    void publish() noexcept
+    {
+        Slot& slot = this->slots[static_cast<size_t>(this->writeIndex)];
+        slot.sequence = ++this->lastSequence;
+        const int previous = this->latest.exchange(this->writeIndex | freshBit, std::memory_order_acq_rel);
+        this->writeIndex = previous & indexMask;
+    }
+
+    // ===== Consumer (UI thread) =====
+
+    // View of the newest published frame; repeats the previous view (same
+    // sequence) when nothing new arrived. Valid until the next call.
+    SpectrumFrameView acquireLatest() noexcept
+    {
+        if ((this->latest.load(std::memory_order_acquire) & freshBit) != 0)
+        {
+            const int previous = this->latest.exchange(this->readIndex, std::memory_order_acq_rel);
+            this->readIndex = previous & indexMask;
+        }
+        const Slot& slot = this->slots[static_cast<size_t>(this->readIndex)];
+        return { slot.values.data(), slot.numValues, slot.sequence };
+    }
+
+private:
+    struct Slot
+    {
+        std::vector<float> values;
+        int numValues { 0 };
+        uint64_t sequence { 0 };
+    };
+
+    static constexpr int indexMask = 0x3;
+    static constexpr int freshBit = 0x4;
+
+    std::array<Slot, 3> slots;
+    std::atomic<int> latest { 2 };  // middle slot index, plus freshBit when unread
+    int writeIndex { 0 };           // producer-owned
+    int readIndex { 1 };            // consumer-owned
+    uint64_t lastSequence { 0 };    // producer-owned
+};
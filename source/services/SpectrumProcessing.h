@@ -3,10 +3,77 @@
 #include <vector>
 #include <algorithm>
 #include <cmath>
+#include <span>
 #include <JuceHeader.h>
 
+// The per-frame kernels take spans so they run on arena-backed buffers; the
+// std::vector overloads size their outputs first and forward to them.
 struct SpectrumProcessing
 {
+    // Log-spaced band edges from 20 Hz up to the last usable bin (Nyquist guard
+    // and 20 kHz cap). Fills fractional edges in Hz and the nearest bins, and
+    // returns the display maximum in Hz.
+    static double computeLogBandEdges(double sampleRate,
+                                      int fftSize,
+                                      int hiGuardBins,
+                                      int numBands,
+                                      std::vector<double>& bandF0Hz,
+                                      std::vector<double>& bandF1Hz,
+                                      std::vector<int>& bandBinStart,
+                                      std::vector<int>& bandBinEnd)
+    {
+        const int numBins = fftSize / 2;
+        bandF0Hz.clear();
+        bandF1Hz.clear();
+        bandBinStart.clear();
+        bandBinEnd.clear();
+        bandF0Hz.reserve(static_cast<size_t>(numBands));
+        bandF1Hz.reserve(static_cast<size_t>(numBands));
+        bandBinStart.reserve(static_cast<size_t>(numBands));
+        bandBinEnd.reserve(static_cast<size_t>(numBands));
+
+        const double binHz = sampleRate / static_cast<double>(fftSize);
+        const double fMin = 20.0; // start around 20 Hz
+        // Map bands only up to the last allowed bin considering both guard and a hard 20 kHz cap
+        const int allowedEndByGuard = jlimit(0, numBins - 1, numBins - hiGuardBins - 1);
+        const int capBy20k = jlimit(0, numBins - 1, static_cast<int>(std::floor(20000.0 / binHz)) - 1);
+        const int allowedEndBin = jlimit(0, numBins - 1, jmin(allowedEndByGuard, capBy20k));
+        // Use the end of the last allowed bin as the display cap but not above 20 kHz
+        const double allowedEndHz = jmin(20000.0, static_cast<double>(allowedEndBin + 1) * binHz);
+        const double displayMaxHz = jmax(fMin * 2.0, allowedEndHz);
+        const double logMin = std::log(fMin);
+        const double logMax = std::log(displayMaxHz);
+
+        for (int bandIndex = 0; bandIndex < numBands; ++bandIndex)
+        {
+            // t spans [0,1]
+            const double fractionStart = static_cast<double>(bandIndex) / static_cast<double>(numBands);
+            const double fractionEnd = static_cast<double>(bandIndex + 1) / static_cast<double>(numBands);
+            double bandStartHz = std::exp(logMin + (logMax - logMin) * fractionStart);
+            double bandEndHz = std::exp(logMin + (logMax - logMin) * fractionEnd);
+            // Clamp to [fMin .. allowedEndHz]
+            bandStartHz = jlimit(fMin, allowedEndHz, bandStartHz);
+            bandEndHz   = jlimit(fMin, allowedEndHz, bandEndHz);
+            if (bandEndHz <= bandStartHz) bandEndHz = jmin(allowedEndHz, bandStartHz + binHz);
+
+            int bin0 = static_cast<int>(std::floor(bandStartHz / binHz + 0.5)); // round to nearest bin
+            int bin1 = static_cast<int>(std::floor(bandEndHz / binHz + 0.5));
+
+            bin0 = jlimit(0, numBins - 1, bin0);
+            bin1 = jlimit(0, numBins - 1, bin1);
+            if (bin1 < bin0)
+            {
+                bin1 = bin0;
+            }
+
+            bandF0Hz.push_back(bandStartHz);
+            bandF1Hz.push_back(bandEndHz);
+            bandBinStart.push_back(bin0);
+            bandBinEnd.push_back(bin1);
+        }
+        return displayMaxHz;
+    }
+
     static int computeAllowedEndBin(double sampleRate,
                                     int fftSize,
                                     int hiGuardBins) noexcept
@@ -20,6 +87,10 @@ struct SpectrumProcessing
         return allowedEnd;
     }
     static void zeroStrictlyAbove(std::vector<float>& buffer, int allowedEnd) noexcept
+    {
+        zeroStrictlyAbove(std::span<float>(buffer), allowedEnd);
+    }
+    static void zeroStrictlyAbove(std::span<float> buffer, int allowedEnd) noexcept
     {
         const int numBins = static_cast<int>(buffer.size());
         const int startIndex = std::min(std::max(allowedEnd + 1, 0), std::max(0, numBins));
@@ -32,16 +103,25 @@ struct SpectrumProcessing
                                                    std::vector<float>& dst,
                                                    int allowedEnd,
                                                    bool enabled) noexcept
+    {
+        if (dst.size() != src.size())
+        {
+            dst.assign(src.size(), 0.0f);
+        }
+        frequencySmoothTriangularIfEnabled(std::span<const float>(src), std::span<float>(dst), allowedEnd, enabled);
+    }
+    // dst must hold at least src.size() values.
+    static void frequencySmoothTriangularIfEnabled(std::span<const float> src,
+                                                   std::span<float> dst,
+                                                   int allowedEnd,
+                                                   bool enabled) noexcept
     {
         // Use descriptive aliases for clarity without changing the public API
-        const auto& sourceBins = src;
-        auto& destinationBins = dst;
+        const auto sourceBins = src;
+        const auto destinationBins = dst;
 
         const int numBins = static_cast<int>(sourceBins.size());
-        if (static_cast<int>(destinationBins.size()) != numBins)
-        {
-            destinationBins.assign(static_cast<size_t>(numBins), 0.0f);
-        }
+        jassert(destinationBins.size() >= sourceBins.size());
         if (!enabled || numBins < 5)
         {
             std::copy(sourceBins.begin(), sourceBins.end(), destinationBins.begin());
@@ -85,6 +165,12 @@ struct SpectrumProcessing
     static void applyCosineTaper(std::vector<float>& buffer,
                                  int allowedEnd,
                                  float taperPercent) noexcept
+    {
+        applyCosineTaper(std::span<float>(buffer), allowedEnd, taperPercent);
+    }
+    static void applyCosineTaper(std::span<float> buffer,
+                                 int allowedEnd,
+                                 float taperPercent) noexcept
     {
         const int numBins = static_cast<int>(buffer.size());
         const float clampedPercent = std::max(0.0f, std::min(0.2f, taperPercent));
@@ -100,85 +186,107 @@ struct SpectrumProcessing
         }
     }
 
-    static void aggregateBandsFractional(const std::vector<float>& srcPower,
-                                         int allowedEnd,
-                                         double binHz,
-                                         const std::vector<double>& bandF0Hz,
-                                         const std::vector<double>& bandF1Hz,
-                                         float minDb,
-                                         float maxDb,
-                                         std::vector<float>& outBands,
-                                         std::vector<float>& outBandsPreSmooth) noexcept
+    // Bin-overlap-weighted mean linear power of one band; 0 when the band lies
+    // outside the usable range.
+    static double bandMeanPower(const std::vector<float>& srcPower,
+                                int allowedEnd,
+                                double binHz,
+                                const std::vector<double>& bandF0Hz,
+                                const std::vector<double>& bandF1Hz,
+                                int bandIndex) noexcept
+    {
+        return bandMeanPower(std::span<const float>(srcPower), allowedEnd, binHz,
+                             std::span<const double>(bandF0Hz), std::span<const double>(bandF1Hz), bandIndex);
+    }
+    static double bandMeanPower(std::span<const float> srcPower,
+                                int allowedEnd,
+                                double binHz,
+                                std::span<const double> bandF0Hz,
+                                std::span<const double> bandF1Hz,
+                                int bandIndex) noexcept
     {
         const int numBins = static_cast<int>(srcPower.size());
         const int numBands = static_cast<int>(bandF0Hz.size());
-        if (static_cast<int>(outBands.size()) != numBands)
-        {
-            outBands.assign(static_cast<size_t>(numBands), 0.0f);
-        }
-        else
+        const int allowedEndForBands = std::max(1, std::min(numBins - 2, allowedEnd));
+        const double allowedEndHzLocal = static_cast<double>(allowedEnd + 1) * binHz;
+
+        double bandStartHz = bandF0Hz.size() == static_cast<size_t>(numBands) ? bandF0Hz[static_cast<size_t>(bandIndex)] : 20.0;
+        double bandEndHz = bandF1Hz.size() == static_cast<size_t>(numBands) ? bandF1Hz[static_cast<size_t>(bandIndex)] : allowedEndHzLocal;
+        if (bandEndHz <= bandStartHz)
         {
-            std::fill(outBands.begin(), outBands.end(), 0.0f);
+            bandEndHz = bandStartHz + binHz;
         }
-        if (static_cast<int>(outBandsPreSmooth.size()) != numBands)
+
+        if (bandEndHz <= bandStartHz + 1e-12 || bandStartHz >= allowedEndHzLocal)
         {
-            outBandsPreSmooth.assign(static_cast<size_t>(numBands), 0.0f);
+            return 0.0;
         }
-        else
+
+        int binStartIndex = std::max(1, std::min(allowedEndForBands, static_cast<int>(std::floor(bandStartHz / binHz))));
+        int binEndIndex = std::max(1, std::min(allowedEndForBands, static_cast<int>(std::floor(bandEndHz / binHz))));
+        if (binEndIndex < binStartIndex)
         {
-            std::fill(outBandsPreSmooth.begin(), outBandsPreSmooth.end(), 0.0f);
+            binEndIndex = binStartIndex;
         }
 
-        const int allowedEndForBands = std::max(1, std::min(numBins - 2, allowedEnd));
-        const double allowedEndHzLocal = static_cast<double>(allowedEnd + 1) * binHz;
-
-        for (int bandIndex = 0; bandIndex < numBands; ++bandIndex)
+        double sumPower = 0.0;
+        double weightSum = 0.0;
+        for (int binIndex = binStartIndex; binIndex <= binEndIndex; ++binIndex)
         {
-            double bandStartHz = bandF0Hz.size() == static_cast<size_t>(numBands) ? bandF0Hz[static_cast<size_t>(bandIndex)] : 20.0;
-            double bandEndHz = bandF1Hz.size() == static_cast<size_t>(numBands) ? bandF1Hz[static_cast<size_t>(bandIndex)] : allowedEndHzLocal;
-            if (bandEndHz <= bandStartHz)
-            {
-                bandEndHz = bandStartHz + binHz;
-            }
-
-            if (bandEndHz <= bandStartHz + 1e-12 || bandStartHz >= allowedEndHzLocal)
+            const double binStartHzEdge = static_cast<double>(binIndex) * binHz;
+            const double binEndHzEdge = static_cast<double>(binIndex + 1) * binHz;
+            const double overlapStart = std::max(bandStartHz, binStartHzEdge);
+            const double overlapEnd = std::min(bandEndHz, binEndHzEdge);
+            const double overlapWidth = std::max(0.0, overlapEnd - overlapStart);
+            if (overlapWidth > 0.0)
             {
-                outBands[static_cast<size_t>(bandIndex)] = 0.0f;
-                outBandsPreSmooth[static_cast<size_t>(bandIndex)] = 0.0f;
-                continue;
-            }
-
-            int binStartIndex = std::max(1, std::min(allowedEndForBands, static_cast<int>(std::floor(bandStartHz / binHz))));
-            int binEndIndex = std::max(1, std::min(allowedEndForBands, static_cast<int>(std::floor(bandEndHz / binHz))));
-            if (binEndIndex < binStartIndex)
-            {
-                binEndIndex = binStartIndex;
+                sumPower  += static_cast<double>(srcPower[static_cast<size_t>(binIndex)]) * overlapWidth;
+                weightSum += overlapWidth;
             }
+        }
+        return weightSum > 0.0 ? sumPower / weightSum : 0.0;
+    }
 
-            double sumPower = 0.0;
-            double weightSum = 0.0;
-            for (int binIndex = binStartIndex; binIndex <= binEndIndex; ++binIndex)
-            {
-                const double binStartHzEdge = static_cast<double>(binIndex) * binHz;
-                const double binEndHzEdge = static_cast<double>(binIndex + 1) * binHz;
-                const double overlapStart = std::max(bandStartHz, binStartHzEdge);
-                const double overlapEnd = std::min(bandEndHz, binEndHzEdge);
-                const double overlapWidth = std::max(0.0, overlapEnd - overlapStart);
-                if (overlapWidth > 0.0)
-                {
-                    sumPower  += static_cast<double>(srcPower[static_cast<size_t>(binIndex)]) * overlapWidth;
-                    weightSum += overlapWidth;
-                }
-            }
+    static void aggregateBandsFractional(const std::vector<float>& srcPower,
+                                         int allowedEnd,
+                                         double binHz,
+                                         const std::vector<double>& bandF0Hz,
+                                         const std::vector<double>& bandF1Hz,
+                                         float minDb,
+                                         float maxDb,
+                                         std::vector<float>& outBands,
+                                         std::vector<float>& outBandsPreSmooth) noexcept
+    {
+        outBands.resize(bandF0Hz.size());
+        outBandsPreSmooth.resize(bandF0Hz.size());
+        aggregateBandsFractional(std::span<const float>(srcPower), allowedEnd, binHz,
+                                 std::span<const double>(bandF0Hz), std::span<const double>(bandF1Hz),
+                                 minDb, maxDb, std::span<float>(outBands), std::span<float>(outBandsPreSmooth));
+    }
+    // Both outputs must hold at least bandF0Hz.size() values.
+    static void aggregateBandsFractional(std::span<const float> srcPower,
+                                         int allowedEnd,
+                                         double binHz,
+                                         std::span<const double> bandF0Hz,
+                                         std::span<const double> bandF1Hz,
+                                         float minDb,
+                                         float maxDb,
+                                         std::span<float> outBands,
+                                         std::span<float> outBandsPreSmooth) noexcept
+    {
+        const int numBands = static_cast<int>(bandF0Hz.size());
+        jassert(outBands.size() >= bandF0Hz.size() && outBandsPreSmooth.size() >= bandF0Hz.size());
 
-            if (weightSum <= 0.0)
+        for (int bandIndex = 0; bandIndex < numBands; ++bandIndex)
+        {
+            const double meanPower = bandMeanPower(srcPower, allowedEnd, binHz, bandF0Hz, bandF1Hz, bandIndex);
+            if (meanPower <= 0.0)
             {
                 outBands[static_cast<size_t>(bandIndex)] = 0.0f;
                 outBandsPreSmooth[static_cast<size_t>(bandIndex)] = 0.0f;
                 continue;
             }
 
-            const double meanPower = sumPower / weightSum;
             const float meanMag = static_cast<float>(std::sqrt(std::max(0.0, meanPower))) + 1e-20f;
             float db = Decibels::gainToDecibels(meanMag, minDb);
             db = db < minDb ? minDb : (db > maxDb ? maxDb : db);
@@ -193,6 +301,11 @@ struct SpectrumProcessing
     // Band-domain smoothing: median3 for top 15% bands, 3-point weighted average elsewhere.
     static void smoothBandsInPlace(std::vector<float>& bands,
                                    bool enabled) noexcept
+    {
+        smoothBandsInPlace(std::span<float>(bands), enabled);
+    }
+    static void smoothBandsInPlace(std::span<float> bands,
+                                   bool enabled) noexcept
     {
         if (!enabled) { return; }
         const int bandCount = static_cast<int>(bands.size());
@@ -205,22 +318,24 @@ struct SpectrumProcessing
             return (bandLow + bandMid + bandHigh) - minValue - maxValue;
         };
 
-        std::vector tempBands(static_cast<size_t>(bandCount), 0.0f);
+        // In place: only the previous band is overwritten before it is read
+        // again, so it is carried in a local instead of a scratch vector.
         const int topRegionStartIndex = static_cast<int>(std::floor(bandCount * 0.85));
-        tempBands[0] = bands[0];
+        float previousBand = bands[0];
         for (int bandIndex = 1; bandIndex < bandCount - 1; ++bandIndex)
         {
+            const float currentBand = bands[static_cast<size_t>(bandIndex)];
+            const float nextBand = bands[static_cast<size_t>(bandIndex + 1)];
             if (bandIndex >= topRegionStartIndex)
             {
-                tempBands[static_cast<size_t>(bandIndex)] = median3(bands[static_cast<size_t>(bandIndex - 1)], bands[static_cast<size_t>(bandIndex)], bands[static_cast<size_t>(bandIndex + 1)]);
+                bands[static_cast<size_t>(bandIndex)] = median3(previousBand, currentBand, nextBand);
             }
             else
             {
-                tempBands[static_cast<size_t>(bandIndex)] = (bands[static_cast<size_t>(bandIndex - 1)] + 2.0f * bands[static_cast<size_t>(bandIndex)] + bands[static_cast<size_t>(bandIndex + 1)]) * 0.25f;
+                bands[static_cast<size_t>(bandIndex)] = (previousBand + 2.0f * currentBand + nextBand) * 0.25f;
             }
+            previousBand = currentBand;
         }
-        tempBands[static_cast<size_t>(bandCount - 1)] = (bands[static_cast<size_t>(bandCount - 2)] + bands[static_cast<size_t>(bandCount - 1)]) * 0.5f;
-        // Copy back
-        std::copy(tempBands.begin(), tempBands.end(), bands.begin());
+        bands[static_cast<size_t>(bandCount - 1)] = (previousBand + bands[static_cast<size_t>(bandCount - 1)]) * 0.5f;
     }
 };
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+#include "../models/ProcessorParameterSnapshot.h"
+
+// One captured input block and the controls in effect when it was processed.
+struct SpikeBundleBlock
+{
+    ProcessorParameterSnapshot parameters;
+    AudioBuffer<float> audio;
+};
+
+// Context behind one slow processBlock: the input blocks leading up to it,
+// oldest first, with the spike as block spikeBlockIndex.
+struct SpikeBundle
+{
+    double sampleRate { 0.0 };
+    int preparedBlockSize { 0 };
+    int numChannels { 0 };
+    double thresholdMs { 0.0 };
+    double spikeMs { 0.0 };           // measured duration of the spike block
+    int spikeBlockIndex { -1 };
+    std::vector<SpikeBundleBlock> blocks;
+};
+
+// Binary replay bundle written by SpikeCatcher and read by trinity_render --replay.
+//
+// File layout (little-endian):
+//   header: "TRSB" magic, uint32 version, double sampleRate,
+//           int32 preparedBlockSize, int32 numChannels, double thresholdMs,
+//           double spikeMs, int32 spikeBlockIndex, int32 numBlocks
+//   block:  int32 soloMode, int32 testEnabled, int32 testType,
+//           int32 freqSmoothEnabled, int32 bandSmoothEnabled,
+//           float32 guardPercent, float32 taperPercent, float32 specSmoothing,
+//           int32 numBands, then numBands - 1 float32 cutoffs,
+//           int32 numSamples, then numChannels * numSamples float32 samples
+//           channel by channel.
+struct SpikeBundleFile
+{
+    static constexpr uint32 formatVersion = 1;
+    static constexpr const char* fileExtension = ".trspike";
+    static constexpr int maxChannels = 64;
+    static constexpr int maxBlockSamples = 1 << 20;
+
+    static void write(OutputStream& stream, const SpikeBundle& bundle)
+    {
+        stream.write("TRSB", 4);
+        stream.writeInt(static_cast<int>(formatVersion));
+        stream.writeDouble(bundle.sampleRate);
+        stream.writeInt(bundle.preparedBlockSize);
+        stream.writeInt(bundle.numChannels);
+        stream.writeDouble(bundle.thresholdMs);
+        stream.writeDouble(bundle.spikeMs);
+        stream.writeInt(bundle.spikeBlockIndex);
+        stream.writeInt(static_cast<int>(bundle.blocks.size()));
+        for (const SpikeBundleBlock& block : bundle.blocks)
+        {
+            writeParameters(stream, block.parameters);
+            const int numSamples = block.audio.getNumSamples();
+            stream.writeInt(numSamples);
+            for (int channel = 0; channel < bundle.numChannels; ++channel)
+            {
+                const float* samples = channel < block.audio.getNumChannels() ? block.audio.getReadPointer(channel) : nullptr;
+                for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex)
+                {
+                    stream.writeFloat(samples != nullptr ? samples[sampleIndex] : 0.0f);
+                }
+            }
+        }
+    }
+
+    // Returns false when the stream is not a complete, valid bundle.
+    static bool read(InputStream& stream, SpikeBundle& bundle)
+    {
+        char magic[4] {};
+        if (stream.read(magic, 4) != 4 || std::memcmp(magic, "TRSB", 4) != 0)
+        {
+            return false;
+        }
+        if (static_cast<uint32>(stream.readInt()) != formatVersion)
+        {
+            return false;
+        }
+        bundle.sampleRate = stream.readDouble();
+        bundle.preparedBlockSize = stream.readInt();
+        bundle.numChannels = stream.readInt();
+        bundle.thresholdMs = stream.readDouble();
+        bundle.spikeMs = stream.readDouble();
+        bundle.spikeBlockIndex = stream.readInt();
+        const int numBlocks = stream.readInt();
+        if (bundle.sampleRate <= 0.0 || bundle.preparedBlockSize <= 0
+            || bundle.numChannels <= 0 || bundle.numChannels > maxChannels || numBlocks < 0)
+        {
+            return false;
+        }
+
+        bundle.blocks.clear();
+        for (int blockIndex = 0; blockIndex < numBlocks; ++blockIndex)
+        {
+            SpikeBundleBlock block;
+            if (!readParameters(stream, block.parameters))
+            {
+                return false;
+            }
+            const int numSamples = stream.readInt();
+            const int64 payloadBytes = 4 * static_cast<int64>(numSamples) * bundle.numChannels;
+            if (numSamples < 0 || numSamples > maxBlockSamples || stream.getNumBytesRemaining() < payloadBytes)
+            {
+                return false;
+            }
+            block.audio.setSize(bundle.numChannels, numSamples);
+            for (int channel = 0; channel < bundle.numChannels; ++channel)
+            {
+                float* samples = block.audio.getWritePointer(channel);
+                for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex)
+                {
+                    samples[sampleIndex] = stream.readFloat();
+                }
+            }
+            bundle.blocks.push_back(std::move(block));
+        }
+        return bundle.spikeBlockIndex < numBlocks;
+    }
+
+    static bool read(const File& file, SpikeBundle& bundle)
+    {
+        FileInputStream stream(file);
+        return stream.openedOk() && read(stream, bundle);
+    }
+
+private:
+    static void writeParameters(OutputStream& stream, const ProcessorParameterSnapshot& parameters)
+    {
+        stream.writeInt(static_cast<int>(parameters.soloMode));
+        stream.writeInt(parameters.testEnabled ? 1 : 0);
+        stream.writeInt(parameters.testType);
+        stream.writeInt(parameters.freqSmoothEnabled ? 1 : 0);
+        stream.writeInt(parameters.bandSmoothEnabled ? 1 : 0);
+        stream.writeFloat(parameters.guardPercent);
+        stream.writeFloat(parameters.taperPercent);
+        stream.writeFloat(parameters.specSmoothing);
+        stream.writeInt(parameters.crossover.numBands);
+        for (int cutoff = 0; cutoff < parameters.crossover.getNumCutoffs(); ++cutoff)
+        {
+            stream.writeFloat(parameters.crossover.cutoffsHz[static_cast<size_t>(cutoff)]);
+        }
+    }
+
+    // False when the band count is out of range; its cutoffs are not read then.
+    static bool readParameters(InputStream& stream, ProcessorParameterSnapshot& parameters)
+    {
+        parameters.soloMode = static_cast<SoloMode>(jlimit(0, maxSoloBands, stream.readInt()));
+        parameters.testEnabled = stream.readInt() != 0;
+        parameters.testType = stream.readInt();
+        parameters.freqSmoothEnabled = stream.readInt() != 0;
+        parameters.bandSmoothEnabled = stream.readInt() != 0;
+        parameters.guardPercent = stream.readFloat();
+        parameters.taperPercent = stream.readFloat();
+        parameters.specSmoothing = stream.readFloat();
+        const int numBands = stream.readInt();
+        if (numBands < CrossoverFrequencies::minBands || numBands > CrossoverFrequencies::maxBands)
+        {
+            return false;
+        }
+        parameters.crossover.numBands = numBands;
+        for (int cutoff = 0; cutoff < parameters.crossover.getNumCutoffs(); ++cutoff)
+        {
+            parameters.crossover.cutoffsHz[static_cast<size_t>(cutoff)] = stream.readFloat();
+        }
+        return true;
+    }
+};
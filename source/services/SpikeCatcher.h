@@ -0,0 +1,354 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <utility>
+#include <vector>
+#include "../models/ProcessorParameterSnapshot.h"
+#include "SpikeBundleFile.h"
+
+// Service: captures the context behind slow processBlock calls.
+// While armed, the audio thread copies every input block and the parameter
+// snapshot into a ring of the last historyBlocks blocks, allocated by arm()
+// so that instances which are never armed hold no history. When a
+// block takes longer than the threshold, the ring is frozen and handed to a
+// background thread, which writes it as a SpikeBundleFile and then returns
+// the (emptied) ring to the audio thread. The audio thread never allocates,
+// locks or waits; spikes while a bundle is being written are only counted.
+class SpikeCatcher : private Thread
+{
+public:
+    static constexpr int defaultHistoryBlocks = 8;
+    static constexpr int defaultMaxBundles = 16;   // per arm(); a slow machine must not fill the disk
+
+    explicit SpikeCatcher(int historyBlocksToKeep = defaultHistoryBlocks)
+        : Thread("Trinity spike catcher"),
+          historyBlocks(jmax(1, historyBlocksToKeep))
+    {
+    }
+
+    ~SpikeCatcher() override
+    {
+        this->disarm();
+    }
+
+    // Message thread, never concurrently with processBlock: blocks of up to
+    // maximumBlockSize samples will be captured. An armed catcher stays armed
+    // with its ring resized; otherwise any old ring is freed.
+    void prepare(double newSampleRate, int numChannelsToCapture, int maximumBlockSize)
+    {
+        const bool wasArmed = this->isArmed();
+        this->stopWriter();
+
+        this->sampleRate = newSampleRate;
+        this->numChannels = jmax(1, numChannelsToCapture);
+        this->blockCapacity = jmax(1, maximumBlockSize);
+        this->ringSamples = {};
+        this->slots = {};
+        this->clearRing();
+
+        if (wasArmed)
+        {
+            this->allocateRing();
+            this->startWriter();
+        }
+    }
+
+    // Message thread. Bundles go to directory; blocks slower than thresholdMs trigger one.
+    bool arm(const File& directory, double thresholdMs, int maxBundles = defaultMaxBundles)
+    {
+        this->disarm();
+        if (!directory.createDirectory())
+        {
+            return false;
+        }
+        this->allocateRing();
+        this->outputDirectory = directory;
+        this->thresholdSeconds.store(jmax(0.0, thresholdMs) * 0.001, std::memory_order_relaxed);
+        this->bundleBudget.store(jmax(1, maxBundles), std::memory_order_relaxed);
+        this->spikesSeen.store(0, std::memory_order_relaxed);
+        this->bundlesWritten.store(0, std::memory_order_relaxed);
+        this->startWriter();
+        return true;
+    }
+
+    // Any thread: the next captured block starts an empty history, e.g. when
+    // playback restarts without a configuration change (no thread restart).
+    void restartHistory() noexcept
+    {
+        this->armGeneration.fetch_add(1, std::memory_order_release);
+    }
+
+    // Message thread. A bundle being written is finished first.
+    void disarm()
+    {
+        this->stopWriter();
+    }
+
+    bool isArmed() const noexcept
+    {
+        return this->state.load(std::memory_order_acquire) != State::Disarmed;
+    }
+
+    double getThresholdMs() const noexcept
+    {
+        return this->thresholdSeconds.load(std::memory_order_relaxed) * 1000.0;
+    }
+
+    // Blocks over the threshold since arm(), written or not.
+    uint64 getSpikesSeen() const noexcept
+    {
+        return this->spikesSeen.load(std::memory_order_relaxed);
+    }
+
+    // Heap bytes held by the history ring; message thread.
+    size_t getRingBytes() const noexcept
+    {
+        return this->ringSamples.capacity() * sizeof(float) + this->slots.capacity() * sizeof(Slot);
+    }
+
+    int getBundlesWritten() const noexcept
+    {
+        return this->bundlesWritten.load(std::memory_order_acquire);
+    }
+
+    // Most recent bundle; empty until one was written.
+    File getLastBundleFile() const
+    {
+        const ScopedLock lock(this->lastBundleLock);
+        return this->lastBundleFile;
+    }
+
+    // ===== Audio thread =====
+
+    // Copies the block's input before processing. Blocks larger than the
+    // prepared size break the history and are not captured. getParameters()
+    // returns the ProcessorParameterSnapshot and is only called for captured
+    // blocks, so a disarmed catcher costs one atomic load.
+    template <typename GetParameters>
+    void captureInput(const AudioBuffer<float>& input, GetParameters&& getParameters) noexcept
+    {
+        this->lastBlockCaptured = false;
+        if (this->state.load(std::memory_order_acquire) != State::Recording)
+        {
+            return;
+        }
+        // A new arm() starts an empty history; the audio thread applies it so
+        // the ring keeps a single owner
+        const uint32 generation = this->armGeneration.load(std::memory_order_acquire);
+        if (generation != this->ringGeneration)
+        {
+            this->ringGeneration = generation;
+            this->clearRing();
+        }
+        const int numSamples = input.getNumSamples();
+        if (numSamples > this->blockCapacity || this->slots.empty())
+        {
+            this->ringCount = 0;
+            return;
+        }
+
+        Slot& slot = this->slots[static_cast<size_t>(this->ringHead)];
+        slot.numSamples = numSamples;
+        slot.parameters = getParameters();
+        for (int channel = 0; channel < this->numChannels; ++channel)
+        {
+            float* destination = this->slotChannel(this->ringHead, channel);
+            if (channel < input.getNumChannels())
+            {
+                FloatVectorOperations::copy(destination, input.getReadPointer(channel), numSamples);
+            }
+            else
+            {
+                FloatVectorOperations::clear(destination, numSamples);
+            }
+        }
+        this->ringHead = (this->ringHead + 1) % this->historyBlocks;
+        this->ringCount = jmin(this->ringCount + 1, this->historyBlocks);
+        this->lastBlockCaptured = true;
+    }
+
+    // Called once the block finished; freezes the ring when it was too slow.
+    void finishBlock(double elapsedSeconds) noexcept
+    {
+        if (elapsedSeconds <= this->thresholdSeconds.load(std::memory_order_relaxed)
+            || this->state.load(std::memory_order_acquire) == State::Disarmed)
+        {
+            return;
+        }
+        this->spikesSeen.fetch_add(1, std::memory_order_relaxed);
+        if (!this->lastBlockCaptured || this->bundlesWritten.load(std::memory_order_relaxed) >= this->bundleBudget.load(std::memory_order_relaxed))
+        {
+            return;
+        }
+        this->frozenSpikeSeconds = elapsedSeconds;
+        State expected = State::Recording;
+        // The writer picks the ring up on its next poll; no signalling from here
+        this->state.compare_exchange_strong(expected, State::Frozen, std::memory_order_acq_rel);
+    }
+
+    // Captures the block's input on construction and reports its duration on destruction.
+    class ScopedBlock
+    {
+    public:
+        template <typename GetParameters>
+        ScopedBlock(SpikeCatcher& catcherToUse,
+                    const AudioBuffer<float>& input,
+                    GetParameters&& getParameters) noexcept
+            : catcher(catcherToUse),
+              startTicks(Time::getHighResolutionTicks())
+        {
+            this->catcher.captureInput(input, std::forward<GetParameters>(getParameters));
+        }
+
+        ~ScopedBlock()
+        {
+            const int64 elapsedTicks = Time::getHighResolutionTicks() - this->startTicks;
+            this->catcher.finishBlock(Time::highResolutionTicksToSeconds(elapsedTicks));
+        }
+
+    private:
+        SpikeCatcher& catcher;
+        int64 startTicks;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedBlock)
+    };
+
+private:
+    enum class State
+    {
+        Disarmed,
+        Recording,  // audio thread owns the ring
+        Frozen      // writer thread owns the ring
+    };
+
+    struct Slot
+    {
+        int numSamples { 0 };
+        ProcessorParameterSnapshot parameters;
+    };
+
+    void startWriter()
+    {
+        this->armGeneration.fetch_add(1, std::memory_order_release);
+        this->state.store(State::Recording, std::memory_order_release);
+        this->startThread();
+    }
+
+    void stopWriter()
+    {
+        this->signalThreadShouldExit();
+        this->stopThread(5000);
+        this->state.store(State::Disarmed, std::memory_order_release);
+    }
+
+    void run() override
+    {
+        while (!this->threadShouldExit())
+        {
+            this->wait(20);
+            if (this->state.load(std::memory_order_acquire) == State::Frozen)
+            {
+                this->writeFrozenRing();
+                this->clearRing();
+                this->state.store(State::Recording, std::memory_order_release);
+            }
+        }
+    }
+
+    void writeFrozenRing()
+    {
+        SpikeBundle bundle;
+        bundle.sampleRate = this->sampleRate;
+        bundle.preparedBlockSize = this->blockCapacity;
+        bundle.numChannels = this->numChannels;
+        bundle.thresholdMs = this->getThresholdMs();
+        bundle.spikeMs = this->frozenSpikeSeconds * 1000.0;
+        bundle.spikeBlockIndex = this->ringCount - 1;  // the newest block
+        const int oldest = (this->ringHead - this->ringCount + this->historyBlocks) % this->historyBlocks;
+        for (int offset = 0; offset < this->ringCount; ++offset)
+        {
+            const int slotIndex = (oldest + offset) % this->historyBlocks;
+            const Slot& slot = this->slots[static_cast<size_t>(slotIndex)];
+            SpikeBundleBlock block;
+            block.parameters = slot.parameters;
+            block.audio.setSize(this->numChannels, slot.numSamples);
+            for (int channel = 0; channel < this->numChannels; ++channel)
+            {
+                block.audio.copyFrom(channel, 0, this->slotChannel(slotIndex, channel), slot.numSamples);
+            }
+            bundle.blocks.push_back(std::move(block));
+        }
+
+        const String stem = "trinity_spike_" + Time::getCurrentTime().formatted("%Y%m%d_%H%M%S");
+        const File file = this->outputDirectory.getNonexistentChildFile(stem, SpikeBundleFile::fileExtension, false);
+        FileOutputStream stream(file);
+        if (!stream.openedOk())
+        {
+            return;
+        }
+        SpikeBundleFile::write(stream, bundle);
+        stream.flush();
+        {
+            const ScopedLock lock(this->lastBundleLock);
+            this->lastBundleFile = file;
+        }
+        this->bundlesWritten.fetch_add(1, std::memory_order_release);
+    }
+
+    // Sized for the prepared configuration. A ring that already fits is
+    // kept: after a re-arm the audio thread may still be finishing a copy.
+    void allocateRing()
+    {
+        const size_t ringSize = static_cast<size_t>(this->historyBlocks) * static_cast<size_t>(this->numChannels)
+                              * static_cast<size_t>(this->blockCapacity);
+        if (this->ringSamples.size() != ringSize)
+        {
+            this->ringSamples.assign(ringSize, 0.0f);
+        }
+        if (this->slots.size() != static_cast<size_t>(this->historyBlocks))
+        {
+            this->slots.assign(static_cast<size_t>(this->historyBlocks), {});
+        }
+    }
+
+    void clearRing() noexcept
+    {
+        this->ringHead = 0;
+        this->ringCount = 0;
+    }
+
+    float* slotChannel(int slotIndex, int channel) noexcept
+    {
+        const size_t slotSize = static_cast<size_t>(this->numChannels) * static_cast<size_t>(this->blockCapacity);
+        return this->ringSamples.data() + static_cast<size_t>(slotIndex) * slotSize
+             + static_cast<size_t>(channel) * static_cast<size_t>(this->blockCapacity);
+    }
+
+    const int historyBlocks;
+    double sampleRate { 0.0 };
+    int numChannels { 0 };
+    int blockCapacity { 0 };
+
+    // Ring, owned by whichever side the state says; sized in arm()
+    std::vector<float> ringSamples;
+    std::vector<Slot> slots;
+    int ringHead { 0 };
+    int ringCount { 0 };
+    bool lastBlockCaptured { false };  // audio thread only
+    uint32 ringGeneration { 0 };       // audio thread only
+    double frozenSpikeSeconds { 0.0 };
+
+    std::atomic<State> state { State::Disarmed };
+    std::atomic<uint32> armGeneration { 0 };
+    std::atomic<double> thresholdSeconds { 0.010 };
+    std::atomic<int> bundleBudget { defaultMaxBundles };
+    std::atomic<uint64> spikesSeen { 0 };
+    std::atomic<int> bundlesWritten { 0 };
+
+    File outputDirectory;
+    CriticalSection lastBundleLock;
+    File lastBundleFile;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpikeCatcher)
+};
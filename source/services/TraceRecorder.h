@@ -0,0 +1,216 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <limits>
+#include <vector>
+#include "../models/TraceStage.h"
+
+#ifndef TRINITY_ENABLE_TRACING
+ #define TRINITY_ENABLE_TRACING 0
+#endif
+
+struct TraceEvent
+{
+    int64 startTicks { 0 };  // Time::getHighResolutionTicks()
+    int64 endTicks { 0 };
+    TraceStage stage { TraceStage::ProcessBlock };
+};
+
+// Fixed-size event ring written by exactly one thread. The writer never
+// blocks; once full, the oldest events are overwritten. Readers copy what is
+// in the ring and drop any slot the writer reused while they were copying.
+class TraceRing
+{
+public:
+    static constexpr int capacity = 8192;  // power of two
+
+    void push(const TraceEvent& event) noexcept
+    {
+        const uint64 index = this->head.load(std::memory_order_relaxed);
+        this->events[static_cast<size_t>(index & mask)] = event;
+        this->head.store(index + 1, std::memory_order_release);
+    }
+
+    // Appends the events still held, oldest first.
+    void snapshot(std::vector<TraceEvent>& out) const
+    {
+        const uint64 end = this->head.load(std::memory_order_acquire);
+        const uint64 begin = end > capacity ? end - capacity : 0;
+        const size_t firstOut = out.size();
+        for (uint64 index = begin; index < end; ++index)
+        {
+            out.push_back(this->events[static_cast<size_t>(index & mask)]);
+        }
+        const uint64 endAfterCopy = this->head.load(std::memory_order_acquire);
+        const uint64 oldestIntact = endAfterCopy > capacity ? endAfterCopy - capacity : 0;
+        if (oldestIntact > begin)
+        {
+            const auto numOverwritten = static_cast<std::ptrdiff_t>(jmin(oldestIntact, end) - begin);
+            out.erase(out.begin() + static_cast<std::ptrdiff_t>(firstOut),
+                      out.begin() + static_cast<std::ptrdiff_t>(firstOut) + numOverwritten);
+        }
+    }
+
+    // Only while the owning thread is not tracing.
+    void clear() noexcept
+    {
+        this->head.store(0, std::memory_order_release);
+    }
+
+    uint64 getTotalPushed() const noexcept
+    {
+        return this->head.load(std::memory_order_acquire);
+    }
+
+private:
+    static constexpr uint64 mask = capacity - 1;
+    std::atomic<uint64> head { 0 };
+    std::array<TraceEvent, capacity> events {};
+};
+
+// Service: hot-path stage tracing exported as Chrome trace_event JSON.
+// TRINITY_TRACE_SCOPE(stage) timestamps a section and pushes one event into
+// the calling thread's ring. Rings live in static storage and are claimed on
+// a thread's first event, so tracing never allocates or locks. Without
+// TRINITY_ENABLE_TRACING the macro expands to nothing. writeChromeTrace()
+// produces a file that loads in Perfetto or chrome://tracing.
+class TraceRecorder
+{
+public:
+    static constexpr int maxThreads = 64;
+
+    static constexpr bool isCompiledIn() noexcept
+    {
+        return TRINITY_ENABLE_TRACING != 0;
+    }
+
+    static void record(TraceStage stage, int64 startTicks, int64 endTicks) noexcept
+    {
+        if (TraceRing* ring = currentRing())
+        {
+            ring->push({ startTicks, endTicks, stage });
+        }
+        else
+        {
+            droppedEvents.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // Events recorded by threads beyond maxThreads.
+    static uint64 getDroppedEvents() noexcept
+    {
+        return droppedEvents.load(std::memory_order_relaxed);
+    }
+
+    // Discards recorded events; call while no traced code is running.
+    static void clear() noexcept
+    {
+        for (TraceRing& ring : rings)
+        {
+            ring.clear();
+        }
+        droppedEvents.store(0, std::memory_order_relaxed);
+    }
+
+    // Complete ("X") events with microsecond timestamps relative to the
+    // earliest event, one tid per traced thread.
+    static void writeChromeTrace(OutputStream& out)
+    {
+        const int numThreads = jmin(maxThreads, nextRing.load(std::memory_order_acquire));
+        std::vector<std::vector<TraceEvent>> perThread(static_cast<size_t>(numThreads));
+        int64 originTicks = std::numeric_limits<int64>::max();
+        for (int threadIndex = 0; threadIndex < numThreads; ++threadIndex)
+        {
+            std::vector<TraceEvent>& events = perThread[static_cast<size_t>(threadIndex)];
+            rings[static_cast<size_t>(threadIndex)].snapshot(events);
+            for (const TraceEvent& event : events)
+            {
+                originTicks = jmin(originTicks, event.startTicks);
+            }
+        }
+
+        const double ticksToMicroseconds = 1.0e6 / static_cast<double>(Time::getHighResolutionTicksPerSecond());
+        out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        bool first = true;
+        for (int threadIndex = 0; threadIndex < numThreads; ++threadIndex)
+        {
+            const int tid = threadIndex + 1;
+            out << (first ? "" : ",") << newLine
+                << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid
+                << ",\"args\":{\"name\":\"trinity thread " << tid << "\"}}";
+            first = false;
+            for (const TraceEvent& event : perThread[static_cast<size_t>(threadIndex)])
+            {
+                const double startUs = static_cast<double>(event.startTicks - originTicks) * ticksToMicroseconds;
+                const double durationUs = static_cast<double>(event.endTicks - event.startTicks) * ticksToMicroseconds;
+                out << "," << newLine
+                    << "{\"name\":\"" << traceStageName(event.stage) << "\",\"cat\":\"trinity\",\"ph\":\"X\""
+                    << ",\"ts\":" << String(startUs, 3) << ",\"dur\":" << String(durationUs, 3)
+                    << ",\"pid\":1,\"tid\":" << tid << "}";
+            }
+        }
+        out << newLine << "]}" << newLine;
+    }
+
+    static bool writeChromeTrace(const File& file)
+    {
+        file.deleteFile();
+        FileOutputStream stream(file);
+        if (!stream.openedOk())
+        {
+            return false;
+        }
+        writeChromeTrace(stream);
+        stream.flush();
+        return stream.getStatus().wasOk();
+    }
+
+private:
+    static TraceRing* currentRing() noexcept
+    {
+        if (!threadHasRing)
+        {
+            threadHasRing = true;
+            const int index = nextRing.fetch_add(1, std::memory_order_acq_rel);
+            threadRing = index < maxThreads ? &rings[static_cast<size_t>(index)] : nullptr;
+        }
+        return threadRing;
+    }
+
+    // Constant-initialised static storage: no allocation on first use
+    inline static std::array<TraceRing, maxThreads> rings {};
+    inline static std::atomic<int> nextRing { 0 };
+    inline static std::atomic<uint64> droppedEvents { 0 };
+    inline static thread_local TraceRing* threadRing = nullptr;
+    inline static thread_local bool threadHasRing = false;
+};
+
+// Records the enclosing scope as one event of the given stage.
+class TraceScope
+{
+public:
+    explicit TraceScope(TraceStage tracedStage) noexcept
+        : stage(tracedStage),
+          startTicks(Time::getHighResolutionTicks())
+    {
+    }
+
+    ~TraceScope()
+    {
+        TraceRecorder::record(this->stage, this->startTicks, Time::getHighResolutionTicks());
+    }
+
+private:
+    TraceStage stage;
+    int64 startTicks;
+
+    JUCE_DECLARE_NON_COPYABLE(TraceScope)
+};
+
+#if TRINITY_ENABLE_TRACING
+ #define TRINITY_TRACE_SCOPE(stage) const TraceScope JUCE_JOIN_MACRO(trinityTraceScope, __LINE__) (TraceStage::stage)
+#else
+ #define TRINITY_TRACE_SCOPE(stage) do {} while (false)
+#endif
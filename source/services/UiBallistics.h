@@ -0,0 +1,101 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <cmath>
+
+// Service: time-constant UI ballistics shared by the spectrum analyzer and meters.
+// Dynamics are expressed in milliseconds and advanced by the elapsed time of
+// each UI frame, so they look the same at any refresh rate. Array kernels are
+// branch-free and built on FloatVectorOperations so they vectorize across bands.
+struct UiBallistics
+{
+    // One-pole coefficient for elapsedMs; a step reaches ~63% after timeConstantMs.
+    // A non-positive time constant means "follow instantly".
+    static float coefficientForElapsed(float timeConstantMs, float elapsedMs) noexcept
+    {
+        if (timeConstantMs <= 0.0f)
+        {
+            return 1.0f;
+        }
+        return 1.0f - std::exp(-std::max(0.0f, elapsedMs) / timeConstantMs);
+    }
+
+    // Multiplicative decay over elapsedMs for a given time constant.
+    static float decayForElapsed(float timeConstantMs, float elapsedMs) noexcept
+    {
+        return 1.0f - coefficientForElapsed(timeConstantMs, elapsedMs);
+    }
+
+    // ===== Array kernels =====
+
+    // current += attack * max(target - current, 0) + release * min(target - current, 0)
+    // Exactly one of the two terms is non-zero per element, which replaces the
+    // per-band attack/release branch. rise/fall are scratch of count floats.
+    // Returns the largest change applied to any element.
+    static float applyAttackRelease(float* current,
+                                    const float* target,
+                                    float* rise,
+                                    float* fall,
+                                    int count,
+                                    float attackCoeff,
+                                    float releaseCoeff) noexcept
+    {
+        if (count <= 0)
+        {
+            return 0.0f;
+        }
+        FloatVectorOperations::max(rise, target, current, count);
+        FloatVectorOperations::subtract(rise, current, count);
+        FloatVectorOperations::min(fall, target, current, count);
+        FloatVectorOperations::subtract(fall, current, count);
+        FloatVectorOperations::addWithMultiply(current, rise, attackCoeff, count);
+        FloatVectorOperations::addWithMultiply(current, fall, releaseCoeff, count);
+
+        const float largestRise = FloatVectorOperations::findMaximum(rise, count);
+        const float largestFall = -FloatVectorOperations::findMinimum(fall, count);
+        return std::max(largestRise * attackCoeff, largestFall * releaseCoeff);
+    }
+
+    // peaks = max(peaks * decay, source)
+    static void applyPeakHold(float* peaks, const float* source, int count, float decay) noexcept
+    {
+        if (count <= 0)
+        {
+            return;
+        }
+        FloatVectorOperations::multiply(peaks, decay, count);
+        FloatVectorOperations::max(peaks, peaks, source, count);
+    }
+
+    // Largest |a - b|; scratch receives a - b.
+    static float maxAbsDifference(const float* a, const float* b, float* scratch, int count) noexcept
+    {
+        if (count <= 0)
+        {
+            return 0.0f;
+        }
+        FloatVectorOperations::subtract(scratch, a, b, count);
+        const Range<float> range = FloatVectorOperations::findMinAndMax(scratch, count);
+        return std::max(std::abs(range.getStart()), std::abs(range.getEnd()));
+    }
+
+    // ===== Scalar forms (same maths, for single meters) =====
+
+    static float attackRelease(float current, float target, float attackCoeff, float releaseCoeff) noexcept
+    {
+        const float delta = target - current;
+        return current + attackCoeff * std::max(delta, 0.0f) + releaseCoeff * std::min(delta, 0.0f);
+    }
+
+    static float peakHold(float peak, float source, float decay) noexcept
+    {
+        return std::max(peak * decay, source);
+    }
+
+    // Count a hold period down by elapsedMs, never below zero.
+    static float advanceHold(float remainingMs, float elapsedMs) noexcept
+    {
+        return std::max(0.0f, remainingMs - std::max(0.0f, elapsedMs));
+    }
+};
@@ -3,17 +3,25 @@
 #include <vector>
 #include <algorithm>
 #include "../models/UiDynamicsSettings.h"
+#include "UiBallistics.h"
 
 // Service: applies UI magnitude smoothing and peak-hold behaviour.
 // Keeps the heavy logic reusable and consistent across components.
+// Dynamics are time-constant based (see UiBallistics) and advanced by the
+// elapsed time since the previous update.
 struct UiMagnitudeProcessor
 {
-    static void process(const std::vector<float>& magnitudes,
-                        std::vector<float>& smoothed,
-                        std::vector<float>& peaks,
-                        const UiDynamicsSettings& settings) noexcept
+    // scratch is caller-owned working memory; it only grows when the band count does.
+    // Returns the largest change applied to any smoothed or peak value so
+    // callers can tell when the display has settled.
+    static float process(const float* magnitudes,
+                         size_t sampleCount,
+                         std::vector<float>& smoothed,
+                         std::vector<float>& peaks,
+                         std::vector<float>& scratch,
+                         const UiDynamicsSettings& settings,
+                         float elapsedMs) noexcept
     {
-        const size_t sampleCount = magnitudes.size();
         if (smoothed.size() != sampleCount)
         {
             smoothed.assign(sampleCount, 0.0f);
@@ -22,40 +30,56 @@ struct UiMagnitudeProcessor
         {
             peaks.assign(sampleCount, 0.0f);
         }
+        if (scratch.size() < 3 * sampleCount)
+        {
+            scratch.resize(3 * sampleCount);
+        }
+        if (sampleCount == 0 || magnitudes == nullptr)
+        {
+            return 0.0f;
+        }
 
+        const int count = static_cast<int>(sampleCount);
+        float* target = scratch.data();
+        float* rise = target + sampleCount;
+        float* fall = rise + sampleCount;
+        FloatVectorOperations::clip(target, magnitudes, 0.0f, 1.0f, count);
+
+        float maxChange = 0.0f;
         if (!settings.smoothingEnabled)
         {
-            for (size_t index = 0; index < sampleCount; ++index)
-            {
-                const float inputMagnitude = magnitudes[index];
-                const float clamped = inputMagnitude < 0.0f ? 0.0f : (inputMagnitude > 1.0f ? 1.0f : inputMagnitude);
-                smoothed[index] = clamped;
-            }
+            maxChange = UiBallistics::maxAbsDifference(target, smoothed.data(), rise, count);
+            FloatVectorOperations::copy(smoothed.data(), target, count);
         }
         else
         {
-            for (size_t index = 0; index < sampleCount; ++index)
-            {
-                const float inputMagnitude = magnitudes[index];
-                const float targetValue = inputMagnitude < 0.0f ? 0.0f : (inputMagnitude > 1.0f ? 1.0f : inputMagnitude);
-                const float currentValue = smoothed[index];
-                const float smoothingCoefficient = targetValue > currentValue ? settings.attackCoeff
-                                                                             : settings.releaseCoeff;
-                smoothed[index] = currentValue * (1.0f - smoothingCoefficient) + targetValue * smoothingCoefficient;
-            }
+            const float attackCoeff = UiBallistics::coefficientForElapsed(settings.attackMs, elapsedMs);
+            const float releaseCoeff = UiBallistics::coefficientForElapsed(settings.releaseMs, elapsedMs);
+            maxChange = UiBallistics::applyAttackRelease(smoothed.data(), target, rise, fall,
+                                                         count, attackCoeff, releaseCoeff);
         }
 
         if (!settings.peakHoldEnabled)
         {
-            std::fill(peaks.begin(), peaks.end(), 0.0f);
+            FloatVectorOperations::clear(peaks.data(), count);
         }
         else
         {
-            for (size_t index = 0; index < sampleCount; ++index)
-            {
-                const float decayedPeakValue = peaks[index] * settings.peakHoldDecay;
-                peaks[index] = decayedPeakValue > smoothed[index] ? decayedPeakValue : smoothed[index];
-            }
+            FloatVectorOperations::copy(rise, peaks.data(), count);
+            const float peakDecay = UiBallistics::decayForElapsed(settings.peakHoldReleaseMs, elapsedMs);
+            UiBallistics::applyPeakHold(peaks.data(), smoothed.data(), count, peakDecay);
+            maxChange = std::max(maxChange, UiBallistics::maxAbsDifference(peaks.data(), rise, fall, count));
         }
+        return maxChange;
+    }
+
+    static float process(const std::vector<float>& magnitudes,
+                         std::vector<float>& smoothed,
+                         std::vector<float>& peaks,
+                         std::vector<float>& scratch,
+                         const UiDynamicsSettings& settings,
+                         float elapsedMs) noexcept
+    {
+        return process(magnitudes.data(), magnitudes.size(), smoothed, peaks, scratch, settings, elapsedMs);
     }
 };
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <cstdint>
+
+// Service: uniform noise in [-1, 1) from eight interleaved xorshift32 lanes.
+// Lanes advance together, one group of eight samples at a time, so the inner
+// loop has no dependency between samples and vectorises. Groups split by a
+// block boundary are finished on the next call, which makes the stream
+// depend only on the seed, never on the host's block sizes.
+class XorshiftNoise
+{
+public:
+    static constexpr int numLanes = 8;
+    static constexpr uint32_t defaultSeed = 0x7249u;
+
+    explicit XorshiftNoise(uint32_t seed = defaultSeed) noexcept
+    {
+        this->reseed(seed);
+    }
+
+    // Restarts the sequence; equal seeds give bit-identical output.
+    void reseed(uint32_t seed) noexcept
+    {
+        // splitmix32 spreads one seed over the lanes; xorshift needs non-zero state
+        uint32_t mix = seed;
+        for (uint32_t& lane : this->state)
+        {
+            mix += 0x9e3779b9u;
+            uint32_t value = mix;
+            value = (value ^ (value >> 16)) * 0x85ebca6bu;
+            value = (value ^ (value >> 13)) * 0xc2b2ae35u;
+            value ^= value >> 16;
+            lane = value != 0 ? value : 0x1u;
+        }
+        this->pendingIndex = numLanes;
+    }
+
+    void fill(float* destination, int numSamples, float amplitude) noexcept
+    {
+        int written = 0;
+        while (written < numSamples && this->pendingIndex < numLanes)
+        {
+            destination[written++] = this->pending[static_cast<size_t>(this->pendingIndex++)] * amplitude;
+        }
+        for (; written + numLanes <= numSamples; written += numLanes)
+        {
+            this->nextGroup(destination + written, amplitude);
+        }
+        if (written < numSamples)
+        {
+            this->nextGroup(this->pending.data(), 1.0f);
+            this->pendingIndex = 0;
+            while (written < numSamples)
+            {
+                destination[written++] = this->pending[static_cast<size_t>(this->pendingIndex++)] * amplitude;
+            }
+        }
+    }
+
+private:
+    void nextGroup(float* destination, float amplitude) noexcept
+    {
+        constexpr float scale = 1.0f / 2147483648.0f;  // 2^-31
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            uint32_t value = this->state[static_cast<size_t>(lane)];
+            value ^= value << 13;
+            value ^= value >> 17;
+            value ^= value << 5;
+            this->state[static_cast<size_t>(lane)] = value;
+            destination[lane] = static_cast<float>(static_cast<int32_t>(value)) * scale * amplitude;
+        }
+    }
+
+    std::array<uint32_t, numLanes> state {};
+    std::array<float, numLanes> pending {};
+    int pendingIndex { numLanes };
+};
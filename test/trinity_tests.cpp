@@ -1,7 +1,32 @@
 #include <gtest/gtest.h>
+#include <complex>
+#include <cstdlib>
+#include <mutex>
+#if defined(__GLIBC__)
+ #include <semaphore.h>
+#endif
 #include "../source/TrinityProcessor.h"
 #include "../source/services/UiMagnitudeProcessor.h"
 #include "../source/services/SpectrumProcessing.h"
+#include "../source/services/FramePacer.h"
+#include "../source/services/SpectrumFrameExchange.h"
+#include "../source/components/SpectrogramView.h"
+#include "../source/services/DebugCaptureFile.h"
+#include "../source/services/PipelineCapture.h"
+#include "../source/services/OfflineBandAnalyzer.h"
+#include "../source/services/AlignedArena.h"
+#include "../source/services/AudioProcessorTest.h"
+#include "../source/services/CrossoverTree.h"
+#include "../source/services/BenchmarkComparison.h"
+#include "../source/services/DeadlineMonitor.h"
+#include "../source/services/InstanceLog.h"
+#include "../source/services/LevelAccumulator.h"
+#include "../source/services/LoudnessMeter.h"
+#include "../source/services/MeasurementAnalysis.h"
+#include "../source/services/RealtimeSanitizer.h"
+#include "../source/services/SharedSpectrumResources.h"
+#include "../source/services/SpikeCatcher.h"
+#include "../source/services/TraceRecorder.h"
 
 TEST(TrinityBasic, CanConstructProcessor) {
     TrinityAudioProcessor processor;
@@ -14,14 +39,15 @@ TEST(UiMagnitudeProcessorTest, SmoothingAndPeaksBasic) {
     std::vector<float> magnitudes { 0.0f, 0.5f, 1.0f };
     std::vector<float> smoothed;
     std::vector<float> peaks;
+    std::vector<float> scratch;
     UiDynamicsSettings settings;
     settings.smoothingEnabled = true;
-    settings.attackCoeff = 1.0f;
-    settings.releaseCoeff = 1.0f;
+    settings.attackMs = 0.0f;   // follow instantly
+    settings.releaseMs = 0.0f;
     settings.peakHoldEnabled = true;
-    settings.peakHoldDecay = 1.0f;
+    settings.peakHoldReleaseMs = 1.0e9f; // effectively no decay
 
-    UiMagnitudeProcessor::process(magnitudes, smoothed, peaks, settings);
+    UiMagnitudeProcessor::process(magnitudes, smoothed, peaks, scratch, settings, 1000.0f / 30.0f);
     ASSERT_EQ(smoothed.size(), magnitudes.size());
     ASSERT_EQ(peaks.size(), magnitudes.size());
     for (size_t vectorIndex = 0; vectorIndex < magnitudes.size(); ++vectorIndex) {
@@ -30,6 +56,1169 @@ TEST(UiMagnitudeProcessorTest, SmoothingAndPeaksBasic) {
     }
 }
 
+TEST(UiMagnitudeProcessorTest, SmoothingIsFrameRateIndependent) {
+    std::vector<float> magnitudes { 1.0f };
+    UiDynamicsSettings settings;
+
+    std::vector<float> scratch;
+
+    std::vector<float> smoothedAt30 { 0.0f };
+    std::vector<float> peaksAt30 { 0.0f };
+    for (int frame = 0; frame < 3; ++frame) {
+        UiMagnitudeProcessor::process(magnitudes, smoothedAt30, peaksAt30, scratch, settings, 1000.0f / 30.0f);
+    }
+
+    std::vector<float> smoothedAt90 { 0.0f };
+    std::vector<float> peaksAt90 { 0.0f };
+    for (int frame = 0; frame < 9; ++frame) {
+        UiMagnitudeProcessor::process(magnitudes, smoothedAt90, peaksAt90, scratch, settings, 1000.0f / 90.0f);
+    }
+    EXPECT_NEAR(smoothedAt30[0], smoothedAt90[0], 1e-4f);
+    EXPECT_NEAR(smoothedAt30[0], 1.0f - std::exp(-100.0f / settings.attackMs), 1e-4f);
+}
+
+TEST(UiBallisticsTest, AttackReleaseKernelMatchesScalarForm) {
+    std::vector<float> current { 0.2f, 0.8f, 0.5f, 0.0f };
+    const std::vector<float> target { 0.9f, 0.1f, 0.5f, 1.0f };
+    std::vector<float> rise(current.size());
+    std::vector<float> fall(current.size());
+    std::vector<float> expected(current.size());
+    for (size_t index = 0; index < current.size(); ++index) {
+        expected[index] = UiBallistics::attackRelease(current[index], target[index], 0.5f, 0.25f);
+    }
+    UiBallistics::applyAttackRelease(current.data(), target.data(), rise.data(), fall.data(),
+                                     static_cast<int>(current.size()), 0.5f, 0.25f);
+    for (size_t index = 0; index < current.size(); ++index) {
+        EXPECT_NEAR(current[index], expected[index], 1e-6f);
+    }
+}
+
+TEST(FramePacerTest, IdlesWhenStaticAndStepsDownWhenOverBudget) {
+    FramePacer pacer;
+    pacer.reset(0.0);
+    const double startRate = pacer.getTargetRateHz();
+
+    for (int frame = 0; frame < 4 * pacer.settings.framesBeforeRateChange; ++frame) {
+        pacer.reportPaintCost(1.0 / startRate); // a full interval: well over budget
+    }
+    EXPECT_LT(pacer.getTargetRateHz(), startRate);
+
+    for (int frame = 0; frame < pacer.settings.framesBeforeIdle; ++frame) {
+        pacer.reportActivity(false);
+    }
+    EXPECT_TRUE(pacer.isIdle());
+    EXPECT_DOUBLE_EQ(pacer.getTargetRateHz(), pacer.settings.idleRateHz);
+
+    pacer.reportActivity(true);
+    EXPECT_FALSE(pacer.isIdle());
+}
+
+TEST(SpectrumFrameExchangeTest, SequencesSkipRepeatsAndCountMissedFrames) {
+    SpectrumFrameExchange exchange;
+    exchange.allocate(4);
+    EXPECT_TRUE(exchange.acquireLatest().isEmpty());
+
+    auto publishValue = [&exchange](float value) {
+        float* frame = exchange.beginWrite(4);
+        ASSERT_NE(frame, nullptr);
+        std::fill(frame, frame + 4, value);
+        exchange.publish();
+    };
+
+    publishValue(1.0f);
+    const SpectrumFrameView first = exchange.acquireLatest();
+    ASSERT_FALSE(first.isEmpty());
+    EXPECT_EQ(first.sequence, 1u);
+    EXPECT_FLOAT_EQ(first.values[3], 1.0f);
+
+    // Nothing new: same frame, same storage
+    const SpectrumFrameView repeated = exchange.acquireLatest();
+    EXPECT_EQ(repeated.sequence, first.sequence);
+    EXPECT_EQ(repeated.values, first.values);
+
+    publishValue(2.0f);
+    publishValue(3.0f);
+    publishValue(4.0f);
+    const SpectrumFrameView latest = exchange.acquireLatest();
+    EXPECT_EQ(latest.sequence, 4u);
+    EXPECT_FLOAT_EQ(latest.values[0], 4.0f);
+    EXPECT_EQ(latest.framesMissedSince(first.sequence), 2u);
+    EXPECT_EQ(exchange.beginWrite(5), nullptr);
+}
+
+TEST(SpectrogramViewTest, WritesOneColumnPerAnalysisFrameAtAnyUiRate) {
+    ScopedJuceInitialiser_GUI juceInitialiser;
+    SpectrumFrameExchange exchange;
+    exchange.allocate(4);
+    SpectrogramView spectrogram;
+    spectrogram.setHistoryLength(16);
+    spectrogram.setBounds(0, 0, 64, 32);
+    auto publishValue = [&exchange](float value) {
+        float* frame = exchange.beginWrite(4);
+        ASSERT_NE(frame, nullptr);
+        std::fill(frame, frame + 4, value);
+        exchange.publish();
+    };
+
+    EXPECT_FALSE(spectrogram.setFrame(exchange.acquireLatest()));
+    publishValue(0.5f);
+    EXPECT_TRUE(spectrogram.setFrame(exchange.acquireLatest()));
+    EXPECT_EQ(spectrogram.getColumnsWritten(), 1u);
+
+    // UI tick repeats the same frame: no new column
+    EXPECT_FALSE(spectrogram.setFrame(exchange.acquireLatest()));
+    EXPECT_EQ(spectrogram.getColumnsWritten(), 1u);
+
+    // A slow tick after five frames: the four skipped ones still take columns
+    for (int frame = 0; frame < 5; ++frame)
+    {
+        publishValue(0.1f * static_cast<float>(frame));
+    }
+    EXPECT_TRUE(spectrogram.setFrame(exchange.acquireLatest()));
+    EXPECT_EQ(spectrogram.getColumnsWritten(), 6u);
+
+    // A gap longer than the history still counts every frame
+    for (int frame = 0; frame < 40; ++frame)
+    {
+        publishValue(0.9f);
+    }
+    spectrogram.setFrame(exchange.acquireLatest());
+    EXPECT_EQ(spectrogram.getColumnsWritten(), 46u);
+}
+
+TEST(DebugCaptureFileTest, RecordsRoundTripAndConvertToCsvColumns) {
+    std::vector<float> bins(1024);
+    for (size_t bin = 0; bin < bins.size(); ++bin) bins[bin] = static_cast<float>(bin);
+    const std::vector<float> bands { 0.25f, 0.5f, 0.75f };
+
+    DebugFrameRecord record;
+    record.frameIndex = 42;
+    record.allowedEndBin = 852;
+    record.sampleRate = 48000.0;
+    record.fftSize = 2048;
+    record.numTailPreSmooth = DebugFrameRecord::copyTail(record.tailPreSmooth, bins.data(), 1023);
+    record.numTailPostSmooth = DebugFrameRecord::copyTail(record.tailPostSmooth, bins.data(), 10);
+    record.numBandsFinal = DebugFrameRecord::copyBands(record.bandsFinal, bands.data(), 3);
+    EXPECT_EQ(record.numTailPreSmooth, DebugFrameRecord::maxTailBins);
+    EXPECT_FLOAT_EQ(record.tailPreSmooth[0], 960.0f);
+    EXPECT_EQ(record.numTailPostSmooth, 11);
+
+    MemoryOutputStream output;
+    DebugCaptureFile::writeHeader(output);
+    DebugCaptureFile::writeRecord(output, record);
+    DebugCaptureFile::writeRecord(output, record);
+    output.writeInt(7); // truncated trailing record is ignored
+
+    MemoryInputStream input(output.getData(), output.getDataSize(), false);
+    ASSERT_EQ(DebugCaptureFile::readHeader(input), DebugCaptureFile::formatVersion);
+    DebugFrameRecord readBack;
+    int recordsRead = 0;
+    while (DebugCaptureFile::readRecord(input, readBack)) ++recordsRead;
+    EXPECT_EQ(recordsRead, 2);
+    EXPECT_EQ(readBack.frameIndex, 42u);
+    EXPECT_EQ(readBack.numTailPostTaper, 0);
+    EXPECT_FLOAT_EQ(readBack.tailPostSmooth[10], 10.0f);
+    EXPECT_FLOAT_EQ(readBack.bandsFinal[2], 0.75f);
+
+    const String header = DebugCaptureFile::csvHeader(readBack);
+    EXPECT_TRUE(header.startsWith("csvVersion=2\nframe,hiGuard,allowedEndBin"));
+    const String columnLine = header.fromFirstOccurrenceOf("\n", false, false).trim();
+    const int headerColumns = StringArray::fromTokens(columnLine, ",", "").size();
+    const int lineColumns = StringArray::fromTokens(DebugCaptureFile::csvLine(readBack).trim(), ",", "").size();
+    EXPECT_EQ(headerColumns, lineColumns);
+    EXPECT_EQ(lineColumns, 7 + 64 + 11 + 3);
+}
+
+TEST(PipelineCaptureTest, OnlyMaskedStagesPublishFullWidthFrames) {
+    PipelineCapture capture;
+    capture.prepare(1024, 96);
+    std::vector<float> bins(1024, 0.5f);
+    std::vector<float> bands(96, 0.25f);
+
+    capture.setStageMask(pipelineStageBit(PipelineStage::Tapered) | pipelineStageBit(PipelineStage::BandSmoothed));
+    EXPECT_EQ(capture.beginStage(PipelineStage::RawPower, 1024), nullptr);
+    EXPECT_EQ(capture.beginStage(PipelineStage::Tapered, 1025), nullptr); // larger than prepared
+    capture.capture(PipelineStage::PerBinSmoothed, bins.data(), 1024);
+    capture.capture(PipelineStage::Tapered, bins.data(), 1024);
+    capture.capture(PipelineStage::BandSmoothed, bands.data(), 96);
+
+    EXPECT_TRUE(capture.acquire(PipelineStage::PerBinSmoothed).isEmpty());
+    const SpectrumFrameView tapered = capture.acquire(PipelineStage::Tapered);
+    ASSERT_FALSE(tapered.isEmpty());
+    EXPECT_EQ(tapered.numValues, 1024);
+    EXPECT_FLOAT_EQ(tapered.values[1023], 0.5f);
+    EXPECT_EQ(capture.acquire(PipelineStage::BandSmoothed).numValues, 96);
+
+    // Re-preparing with the same sizes keeps the published data
+    capture.prepare(1024, 96);
+    EXPECT_EQ(capture.acquire(PipelineStage::Tapered).sequence, tapered.sequence);
+}
+
+TEST(OfflineBandAnalyzerTest, ChunkedAnalysisMatchesSinglePass) {
+    constexpr double sampleRate = 48000.0;
+    constexpr int numFrames = 120;
+    AudioBuffer<float> audio(2, numFrames * 2048);
+    for (int sampleIndex = 0; sampleIndex < audio.getNumSamples(); ++sampleIndex)
+    {
+        const float value = 0.5f * std::sin(2.0f * MathConstants<float>::pi * 1000.0f * static_cast<float>(sampleIndex) / 48000.0f);
+        audio.setSample(0, sampleIndex, value);
+        audio.setSample(1, sampleIndex, value);
+    }
+    MemoryBlock wavData;
+    {
+        WavAudioFormat wav;
+        std::unique_ptr<AudioFormatWriter> writer(wav.createWriterFor(new MemoryOutputStream(wavData, false),
+                                                                      sampleRate, 2, 32, {}, 0));
+        ASSERT_NE(writer, nullptr);
+        writer->writeFromAudioSampleBuffer(audio, 0, audio.getNumSamples());
+    }
+    WavAudioFormat wav;
+    std::unique_ptr<AudioFormatReader> reader(wav.createReaderFor(new MemoryInputStream(wavData, false), true));
+    ASSERT_NE(reader, nullptr);
+
+    OfflineAnalysisSettings settings;
+    settings.overlapFrames = 32;
+    OfflineBandAnalyzer analyzer(settings, sampleRate, 2);
+    const BandAnalysisChunk single = analyzer.analyseChunk(*reader, 0, numFrames);
+    std::vector<BandAnalysisChunk> chunks;
+    for (int firstFrame = 80; firstFrame >= 0; firstFrame -= 40) // out of order on purpose
+    {
+        chunks.push_back(analyzer.analyseChunk(*reader, firstFrame, 40));
+    }
+    const BandAnalysisChunk merged = OfflineBandAnalyzer::mergeChunks(std::move(chunks));
+
+    ASSERT_EQ(merged.numFrames, numFrames);
+    ASSERT_EQ(merged.bands.size(), single.bands.size());
+    for (size_t index = 0; index < single.bands.size(); ++index)
+    {
+        EXPECT_NEAR(merged.bands[index], single.bands[index], 1.0e-3f);
+    }
+    EXPECT_EQ(merged.meterPeaks.size(), static_cast<size_t>(numFrames * merged.numMeters));
+    EXPECT_NEAR(merged.meterPeaks.back(), 0.5f, 1.0e-3f); // total peak of the last frame
+
+    // The 1 kHz tone dominates the long-term average spectrum
+    const std::vector<float> ltas = analyzer.longTermAverageDb(merged);
+    const auto loudest = std::max_element(ltas.begin(), ltas.end()) - ltas.begin();
+    EXPECT_LE(analyzer.getBandStartHz()[static_cast<size_t>(loudest)], 1000.0);
+    EXPECT_GE(analyzer.getBandEndHz()[static_cast<size_t>(loudest)], 1000.0);
+}
+
+TEST(AlignedArenaTest, HotRegionsComeFirstOnTheirOwnCacheLinesAndMemoryIsReused) {
+    AlignedArena arena;
+    const auto plan = [&arena]
+    {
+        arena.beginPlan();
+        const int cold = arena.addRegion("cold", 100, AlignedArena::Heat::Cold);
+        const int hot = arena.addRegion("hot", 3, AlignedArena::Heat::Hot);
+        arena.allocate();
+        return std::make_pair(cold, hot);
+    };
+    const auto [cold, hot] = plan();
+    const std::span<float> hotValues = arena.region(hot);
+    const std::span<float> coldValues = arena.region(cold);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(hotValues.data()) % AlignedArena::alignment, 0u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(coldValues.data()) % AlignedArena::alignment, 0u);
+    EXPECT_EQ(reinterpret_cast<char*>(coldValues.data()) - reinterpret_cast<char*>(hotValues.data()),
+              static_cast<std::ptrdiff_t>(AlignedArena::alignment));
+    EXPECT_EQ(arena.getBytesUsed(), AlignedArena::alignment + AlignedArena::roundUpToLine(100 * sizeof(float)));
+
+    // Same plan again: same block, zeroed
+    coldValues[5] = 1.0f;
+    plan();
+    EXPECT_EQ(arena.region(cold).data(), coldValues.data());
+    EXPECT_EQ(arena.region(cold)[5], 0.0f);
+
+    TrinityAudioProcessor processor;
+    processor.prepareToPlay(48000.0, 512);
+    const MemoryFootprint footprint = processor.getMemoryFootprint();
+    size_t hotBytes = 0;
+    size_t arenaBytes = 0;
+    for (const MemoryFootprint::Entry& entry : footprint.entries)
+    {
+        hotBytes += entry.kind == MemoryFootprintKind::ArenaHot ? entry.bytes : 0;
+        arenaBytes += entry.kind == MemoryFootprintKind::ArenaHot || entry.kind == MemoryFootprintKind::ArenaCold
+                   || entry.kind == MemoryFootprintKind::ArenaPadding ? entry.bytes : 0;
+    }
+    EXPECT_EQ(hotBytes, 2048u * sizeof(float));  // the mono FIFO
+    EXPECT_EQ(arenaBytes % AlignedArena::alignment, 0u);
+    EXPECT_GT(footprint.getInstanceBytes(), arenaBytes);
+    processor.releaseResources();
+}
+
+TEST(AudioTestProcessorTest, SignalsAreSeededAndIndependentOfBlockSizes) {
+    // Renders numSamples of a signal in blocks cycling through blockSizes
+    const auto render = [](int signalType, uint32 seed, std::initializer_list<int> blockSizes, int numSamples)
+    {
+        AudioTestProcessor generator;
+        generator.setType(signalType);
+        generator.setSeed(seed);
+        generator.prepare(48000.0, 20000.0);
+        std::vector<float> rendered;
+        auto blockSize = blockSizes.begin();
+        while (static_cast<int>(rendered.size()) < numSamples)
+        {
+            const int count = jmin(*blockSize, numSamples - static_cast<int>(rendered.size()));
+            blockSize = std::next(blockSize) == blockSizes.end() ? blockSizes.begin() : std::next(blockSize);
+            AudioBuffer<float> block(3, count);
+            generator.generate(block);
+            for (int sampleIndex = 0; sampleIndex < count; ++sampleIndex)
+            {
+                EXPECT_EQ(block.getSample(2, sampleIndex), block.getSample(0, sampleIndex));
+                rendered.push_back(block.getSample(0, sampleIndex));
+            }
+        }
+        return rendered;
+    };
+
+    constexpr int numSamples = 6000;
+    for (const int signalType : { kSine17k, kWhiteNoise, kPinkNoise, kLogSweep, kSyncSweep })
+    {
+        EXPECT_EQ(render(signalType, 7, { 512 }, numSamples), render(signalType, 7, { 1, 37, 300, 64 }, numSamples))
+            << "type " << signalType;
+    }
+    EXPECT_NE(render(kWhiteNoise, 7, { 512 }, numSamples), render(kWhiteNoise, 8, { 512 }, numSamples));
+
+    // The recurrences track the closed forms
+    const std::vector<float> sine = render(kSine17k, 7, { 512 }, numSamples);
+    const std::vector<float> sweep = render(kLogSweep, 7, { 512 }, numSamples);
+    double sweepPhase = 0.0;
+    for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex)
+    {
+        const double expectedSine = 0.25 * std::sin(MathConstants<double>::twoPi * 17000.0 / 48000.0 * sampleIndex);
+        EXPECT_NEAR(sine[static_cast<size_t>(sampleIndex)], expectedSine, 1.0e-6);
+        const double frequencyHz = 20.0 * std::pow(1000.0, sampleIndex / (48000.0 * 10.0));
+        sweepPhase += MathConstants<double>::twoPi * frequencyHz / 48000.0;
+        EXPECT_NEAR(sweep[static_cast<size_t>(sampleIndex)], 0.25 * std::sin(sweepPhase), 1.0e-6);
+    }
+}
+
+TEST(ExponentialChirpTest, TracksTheClosedFormPhaseOfAFastSweep) {
+    // 20 Hz to 20 kHz in a third of a second at 44.1 kHz, as the default sync sweep
+    constexpr double logGrowth = 4.5e-4;
+    constexpr double phaseScale = MathConstants<double>::twoPi;
+    ExponentialChirp chirp;
+    chirp.start(0.5, phaseScale, logGrowth);
+    for (long long sampleIndex = 0; sampleIndex < 15000; ++sampleIndex)
+    {
+        const double expected = std::sin(0.5 + phaseScale * std::expm1(logGrowth * static_cast<double>(sampleIndex)));
+        ASSERT_NEAR(chirp.next(), expected, 1.0e-6) << "sample " << sampleIndex;
+    }
+    EXPECT_EQ(chirp.getPosition(), 15000);
+}
+
+TEST(MeasurementAnalysisTest, SignalsMeasureCrossoverResponseAndLatencyInUnderASecond) {
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 480;
+    const MeasurementSettings settings;
+    const auto measure = [&settings](int signalType, SoloMode soloMode)
+    {
+        TrinityAudioProcessor processor;
+        processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+        processor.setSoloMode(soloMode);
+        MidiBuffer midi;
+        return MeasurementAnalysis::measure(signalType, settings, sampleRate, 2, blockSize, [&](AudioBuffer<float>& block)
+        {
+            processor.processBlock(block, midi);
+        });
+    };
+    const auto nearestPoint = [](const MeasuredResponse& response, double frequencyHz)
+    {
+        size_t nearest = 0;
+        for (size_t point = 0; point < response.frequencyHz.size(); ++point)
+        {
+            if (std::abs(std::log(response.frequencyHz[point] / frequencyHz)) < std::abs(std::log(response.frequencyHz[nearest] / frequencyHz)))
+            {
+                nearest = point;
+            }
+        }
+        return nearest;
+    };
+
+    const MeasuredResponse reference = measure(kImpulse, SoloMode::None);
+    ASSERT_GT(reference.frequencyHz.size(), 25u);
+    for (const int signalType : { kImpulse, kSyncSweep, kMls, kMultitone })
+    {
+        const MeasuredResponse full = measure(signalType, SoloMode::None);
+        EXPECT_LT(full.audioSeconds, 0.5) << "type " << signalType;
+        EXPECT_EQ(full.latencySamples, signalType == kMultitone ? -1 : TrinityAudioProcessor().getLatencySamples());
+        ASSERT_EQ(full.frequencyHz, reference.frequencyHz);
+        for (size_t point = 0; point < full.frequencyHz.size(); ++point)
+        {
+            // The compensated band sum is an allpass; all methods agree
+            EXPECT_NEAR(full.magnitudeDb[point], 0.0, 0.2) << "type " << signalType << " at " << full.frequencyHz[point];
+            EXPECT_NEAR(full.magnitudeDb[point], reference.magnitudeDb[point], 0.05);
+            EXPECT_NEAR(std::remainder(full.phaseDegrees[point] - reference.phaseDegrees[point], 360.0), 0.0, 0.5);
+        }
+
+        // Linkwitz-Riley low band: flat, -6 dB at the crossover, 24 dB/octave beyond
+        const MeasuredResponse low = measure(signalType, SoloMode::Band1);
+        const double crossoverHz = static_cast<double>(BandFrequencies::LowBandEndHz);
+        EXPECT_NEAR(low.magnitudeDb[nearestPoint(low, 40.0)], 0.0, 0.2);
+        EXPECT_NEAR(low.magnitudeDb[nearestPoint(low, crossoverHz)], -6.0, 0.5);
+        EXPECT_LT(low.magnitudeDb[nearestPoint(low, crossoverHz * 8.0)], -60.0);
+        // Its onset trails the reported latency by the filter's own delay,
+        // which is why latency is checked on the full-band sum only
+        if (signalType != kMultitone)
+        {
+            EXPECT_GT(low.latencySamples, TrinityAudioProcessor().getLatencySamples()) << "type " << signalType;
+        }
+    }
+
+    // The live generator loops the same excitation the analysis expects
+    AudioTestProcessor generator;
+    generator.setType(kMls);
+    generator.prepare(sampleRate, 20000.0);
+    const std::vector<float> excitation = MeasurementAnalysis::renderExcitation(kMls, settings, sampleRate);
+    AudioBuffer<float> block(1, static_cast<int>(excitation.size()));
+    generator.generate(block);
+    EXPECT_EQ(std::vector<float>(block.getReadPointer(0), block.getReadPointer(0) + block.getNumSamples()), excitation);
+}
+
+TEST(BenchmarkComparisonTest, FlagsOnlySignificantSlowdownsBeyondThreshold) {
+    const var json = JSON::parse(R"({"benchmarks": [
+        {"name": "BM_A", "run_name": "BM_A", "run_type": "iteration", "cpu_time": 1.5, "time_unit": "us"},
+        {"name": "BM_A", "run_name": "BM_A", "run_type": "iteration", "cpu_time": 1.7, "time_unit": "us"},
+        {"name": "BM_A_mean", "run_name": "BM_A", "run_type": "aggregate", "cpu_time": 1.6, "time_unit": "us"}
+    ]})");
+    const BenchmarkComparison::RunTimes times = BenchmarkComparison::loadRunTimes(json);
+    ASSERT_EQ(times.size(), 1u);
+    ASSERT_EQ(times.at("BM_A").size(), 2u); // aggregate rows are skipped
+    EXPECT_DOUBLE_EQ(times.at("BM_A")[0], 1500.0);
+
+    std::vector<double> baseline, noisy, slower, slightlySlower;
+    for (int repetition = 0; repetition < 10; ++repetition)
+    {
+        const double jitter = static_cast<double>((repetition * 7) % 10);
+        baseline.push_back(100.0 + jitter);
+        noisy.push_back(100.0 + static_cast<double>((repetition * 3) % 10));
+        slower.push_back(150.0 + jitter);
+        slightlySlower.push_back(112.0 + jitter);
+    }
+
+    const BenchmarkVerdict same = BenchmarkComparison::compare("noise", baseline, noisy, 0.10, 0.01);
+    EXPECT_FALSE(same.regressed);
+    EXPECT_GT(same.pSlower, 0.05);
+
+    const BenchmarkVerdict regressed = BenchmarkComparison::compare("slower", baseline, slower, 0.10, 0.01);
+    EXPECT_TRUE(regressed.regressed);
+    EXPECT_LT(regressed.pSlower, 0.001);
+    EXPECT_NEAR(regressed.ratio, 1.5, 0.01);
+
+    // Significant but within the threshold
+    const BenchmarkVerdict small = BenchmarkComparison::compare("small", baseline, slightlySlower, 0.20, 0.01);
+    EXPECT_LT(small.pSlower, 0.01);
+    EXPECT_FALSE(small.regressed);
+
+    const BenchmarkVerdict faster = BenchmarkComparison::compare("faster", slower, baseline, 0.10, 0.01);
+    EXPECT_TRUE(faster.improved);
+    EXPECT_FALSE(faster.regressed);
+}
+
+TEST(TraceRecorderTest, RingKeepsNewestEventsAndWritesChromeTraceJson) {
+    TraceRing ring;
+    for (int eventIndex = 0; eventIndex < TraceRing::capacity + 10; ++eventIndex)
+    {
+        ring.push({ eventIndex, eventIndex + 1, TraceStage::Taper });
+    }
+    std::vector<TraceEvent> events;
+    ring.snapshot(events);
+    ASSERT_EQ(events.size(), static_cast<size_t>(TraceRing::capacity));
+    EXPECT_EQ(events.front().startTicks, 10); // oldest ten overwritten
+
+    TraceRecorder::clear();
+    const int64 start = Time::getHighResolutionTicks();
+    TraceRecorder::record(TraceStage::ProcessBlock, start, start + 1000);
+    TraceRecorder::record(TraceStage::Crossover, start + 100, start + 400);
+
+    MemoryOutputStream json;
+    TraceRecorder::writeChromeTrace(json);
+    const var trace = JSON::parse(json.toString());
+    const Array<var>* traceEvents = trace["traceEvents"].getArray();
+    ASSERT_NE(traceEvents, nullptr);
+    StringArray names;
+    for (const var& event : *traceEvents)
+    {
+        if (event["ph"].toString() == "X")
+        {
+            names.add(event["name"].toString());
+            EXPECT_GE(static_cast<double>(event["dur"]), 0.0);
+        }
+    }
+    EXPECT_TRUE(names.contains("processBlock"));
+    EXPECT_TRUE(names.contains("crossover"));
+    TraceRecorder::clear();
+}
+
+TEST(DeadlineMonitorTest, BucketsLoadRatiosCountsOverrunsAndResets) {
+    DeadlineMonitor monitor;
+    monitor.prepare(48000.0, 480);
+    const double budget = 480.0 / 48000.0; // 10 ms
+    for (int block = 0; block < 98; ++block) {
+        monitor.registerBlock(0.25 * budget, 480);
+    }
+    monitor.registerBlock(1.5 * budget, 480);
+    monitor.registerBlock(3.0 * budget, 480);
+
+    DeadlineStats stats = monitor.getStats();
+    EXPECT_EQ(stats.blocks, 100u);
+    EXPECT_EQ(stats.overruns, 2u);
+    EXPECT_DOUBLE_EQ(stats.worstRatio, 3.0);
+    EXPECT_NEAR(stats.worstMs, 30.0, 1.0e-9);
+    EXPECT_EQ(stats.worstBlockSize, 480);
+    EXPECT_NEAR(stats.averageLoad, (98 * 0.25 + 1.5 + 3.0) / 100.0, 1.0e-9);
+    EXPECT_EQ(stats.histogram[static_cast<size_t>(DeadlineStats::bucketForRatio(0.25))], 98u);
+    // The histogram and the overrun counter agree on where the budget ends
+    for (const double ratio : { 0.5, 1.0, std::nextafter(1.0, 2.0), 1.5, 2.0 }) {
+        EXPECT_EQ(DeadlineStats::bucketForRatio(ratio) >= DeadlineStats::firstOverrunBucket(), DeadlineStats::isOverrun(ratio)) << ratio;
+    }
+    EXPECT_EQ(DeadlineStats::bucketForRatio(1.0), DeadlineStats::firstOverrunBucket() - 1);
+    EXPECT_EQ(DeadlineStats::bucketForRatio(1.0e-9), 0);
+    EXPECT_EQ(DeadlineStats::bucketForRatio(1.0e9), DeadlineStats::numBuckets - 1);
+    // The median lies in the 0.25 bucket; p99.9 reaches the overrun buckets
+    EXPECT_LE(stats.percentileRatio(0.5), 0.25 * std::sqrt(2.0) + 1.0e-12);
+    EXPECT_GT(stats.percentileRatio(0.999), 1.0);
+
+    // Reset is applied by the next audio block; snapshots read empty meanwhile
+    monitor.requestReset();
+    EXPECT_EQ(monitor.getStats().blocks, 0u);
+    monitor.registerBlock(0.5 * budget, 480);
+    stats = monitor.getStats();
+    EXPECT_EQ(stats.blocks, 1u);
+    EXPECT_EQ(stats.overruns, 0u);
+    EXPECT_DOUBLE_EQ(stats.worstRatio, 0.5);
+}
+
+TEST(InstanceLogTest, InstancesShareOneLoggerAndRealtimeEventsAreWritten) {
+    // Several processors in one process used to collide on the logger name
+    TrinityAudioProcessor first;
+    TrinityAudioProcessor second;
+    EXPECT_EQ(spdlog::get("Trinity"), InstanceLog::getSharedLogger());
+
+    InstanceLog log;
+    InstanceLog other;
+    EXPECT_NE(log.getTag(), other.getTag());
+    EXPECT_TRUE(log.post(RealtimeLogEvent::xrun(12.5, 10.0, 480)));
+    EXPECT_TRUE(log.post(RealtimeLogEvent::sampleRateChange(44100.0, 48000.0)));
+    log.flush();
+    EXPECT_EQ(log.getWrittenEvents(), 2u);
+    EXPECT_EQ(log.getDroppedEvents(), 0u);
+
+    EXPECT_EQ(InstanceLog::formatEvent(RealtimeLogEvent::xrun(12.5, 10.0, 480)),
+              "xrun: 480-sample block took 12.500 ms of 10.000 ms budget");
+    EXPECT_EQ(InstanceLog::formatEvent(RealtimeLogEvent::channelLayoutChange(2, 1)), "channel layout 2 -> 1 channels");
+    EXPECT_EQ(InstanceLog::formatEvent(RealtimeLogEvent::oversizedBlock(1024, 512)),
+              "block of 1024 samples exceeds prepared size 512");
+}
+
+TEST(SpikeCatcherTest, SlowBlockFreezesHistoryIntoReadableBundle) {
+    const File directory = File::getSpecialLocation(File::tempDirectory).getNonexistentChildFile("trinity_spikes", "");
+    SpikeCatcher catcher(4);
+    catcher.prepare(48000.0, 2, 64);
+    EXPECT_EQ(catcher.getRingBytes(), 0u); // the history is only allocated once armed
+    AudioBuffer<float> input(2, 64);
+    ProcessorParameterSnapshot parameters;
+    int snapshotsTaken = 0;
+    const auto getParameters = [&] {
+        ++snapshotsTaken;
+        return parameters;
+    };
+    catcher.captureInput(input, getParameters);
+    EXPECT_EQ(snapshotsTaken, 0); // a disarmed catcher never builds the snapshot
+    ASSERT_TRUE(catcher.arm(directory, 5.0));
+    EXPECT_GE(catcher.getRingBytes(), 4u * 2u * 64u * sizeof(float));
+
+    for (int block = 0; block < 6; ++block) {
+        input.clear();
+        input.setSample(0, 0, static_cast<float>(block));
+        input.setSample(1, 63, -static_cast<float>(block));
+        parameters.soloMode = block == 5 ? SoloMode::Band3 : SoloMode::None;
+        catcher.captureInput(input, getParameters);
+        catcher.finishBlock(block == 5 ? 0.020 : 0.001); // only the last block exceeds 5 ms
+    }
+    EXPECT_EQ(snapshotsTaken, 6);
+    for (int attempt = 0; attempt < 200 && catcher.getBundlesWritten() == 0; ++attempt) {
+        Thread::sleep(10);
+    }
+    catcher.disarm();
+    ASSERT_EQ(catcher.getBundlesWritten(), 1);
+    EXPECT_EQ(catcher.getSpikesSeen(), 1u);
+
+    SpikeBundle bundle;
+    ASSERT_TRUE(SpikeBundleFile::read(catcher.getLastBundleFile(), bundle));
+    EXPECT_DOUBLE_EQ(bundle.sampleRate, 48000.0);
+    EXPECT_EQ(bundle.preparedBlockSize, 64);
+    EXPECT_NEAR(bundle.spikeMs, 20.0, 1.0e-9);
+    ASSERT_EQ(bundle.blocks.size(), 4u); // history keeps the newest four, oldest first
+    EXPECT_EQ(bundle.spikeBlockIndex, 3);
+    for (int index = 0; index < 4; ++index) {
+        const SpikeBundleBlock& block = bundle.blocks[static_cast<size_t>(index)];
+        EXPECT_EQ(block.audio.getNumSamples(), 64);
+        EXPECT_FLOAT_EQ(block.audio.getSample(0, 0), static_cast<float>(index + 2));
+        EXPECT_FLOAT_EQ(block.audio.getSample(1, 63), -static_cast<float>(index + 2));
+    }
+    EXPECT_EQ(bundle.blocks.back().parameters.soloMode, SoloMode::Band3);
+
+    // A band count out of range (little-endian, low byte patched) rejects the
+    // bundle before any cutoff is read
+    MemoryOutputStream written;
+    SpikeBundleFile::write(written, bundle);
+    const MemoryBlock original = written.getMemoryBlock();
+    MemoryBlock corrupted = original;
+    constexpr size_t headerBytes = 48;
+    constexpr size_t numBandsOffset = headerBytes + 5 * 4 + 3 * 4;
+    corrupted[numBandsOffset] = static_cast<char>(CrossoverFrequencies::maxBands + 1);
+    MemoryInputStream intact(original, false);
+    MemoryInputStream rejected(corrupted, false);
+    SpikeBundle reread;
+    EXPECT_TRUE(SpikeBundleFile::read(intact, reread));
+    EXPECT_FALSE(SpikeBundleFile::read(rejected, reread));
+    directory.deleteRecursively();
+}
+
+TEST(SharedSpectrumResourcesTest, InstancesShareImmutableObjectsUntilTheLastRelease) {
+    // A rate no other test prepares at, so every entry below starts out unused
+    const double sampleRate = 37800.0;
+    const int fftSize = 2048;
+    const int defaultGuardBins = 61;  // 6% of 1024 bins
+    std::shared_ptr<const SpectrumBandLayout> layout = SharedSpectrumResources::getBandLayout(sampleRate, fftSize, defaultGuardBins, 96);
+    EXPECT_EQ(layout.get(), SharedSpectrumResources::getBandLayout(sampleRate, fftSize, defaultGuardBins, 96).get());
+    EXPECT_NE(layout.get(), SharedSpectrumResources::getBandLayout(sampleRate, fftSize, 8, 96).get());
+    EXPECT_EQ(layout->bandF0Hz.size(), 96u);
+    EXPECT_EQ(layout->hiGuardBins, defaultGuardBins);
+
+    {
+        TrinityAudioProcessor first;
+        TrinityAudioProcessor second;
+        first.setMemoryRetentionPolicy(MemoryRetentionPolicy::ReleaseAll);
+        second.setMemoryRetentionPolicy(MemoryRetentionPolicy::ReleaseAll);
+        first.prepareToPlay(sampleRate, 512);
+        second.prepareToPlay(sampleRate, 512);
+        using Window = SharedSpectrumResources::Window;
+        const std::shared_ptr<const Window> window = SharedSpectrumResources::getWindow(fftSize, Window::hann, false);
+        EXPECT_EQ(window.use_count(), 3);
+        EXPECT_EQ(layout.use_count(), 3);
+        EXPECT_DOUBLE_EQ(first.getDisplayMaxHz(), layout->displayMaxHz);
+
+        // A different guard moves one instance to its own layout; with no
+        // block in flight nothing can still read the old one, so it goes at once
+        second.setGuardPercent(0.2f);
+        EXPECT_EQ(layout.use_count(), 2);
+        // Sweeping the guard keeps nothing but the current layout alive
+        const std::weak_ptr<const SpectrumBandLayout> widestGuard =
+            SharedSpectrumResources::getBandLayout(sampleRate, fftSize, 204, 96);
+        EXPECT_FALSE(widestGuard.expired());
+        for (int step = 0; step <= 10; ++step)
+        {
+            second.setGuardPercent(0.01f * static_cast<float>(step));
+        }
+        EXPECT_TRUE(widestGuard.expired());
+
+        first.releaseResources();
+        second.releaseResources();
+        EXPECT_EQ(window.use_count(), 1);
+        EXPECT_EQ(layout.use_count(), 1);
+    }
+
+    const std::weak_ptr<const SpectrumBandLayout> released = layout;
+    layout.reset();
+    EXPECT_TRUE(released.expired());
+}
+
+TEST(TrinityProcessorTest, RetainedReleaseRepreparesToTheSameStateAsAFreshInstance) {
+    const int blockSize = 256;
+    Random random(0x43);
+    AudioBuffer<float> warmup(2, blockSize);
+    AudioBuffer<float> probe(2, blockSize);
+    for (int channel = 0; channel < 2; ++channel)
+    {
+        for (int sampleIndex = 0; sampleIndex < blockSize; ++sampleIndex)
+        {
+            warmup.setSample(channel, sampleIndex, random.nextFloat() * 2.0f - 1.0f);
+            probe.setSample(channel, sampleIndex, random.nextFloat() * 2.0f - 1.0f);
+        }
+    }
+    MidiBuffer midi;
+
+    TrinityAudioProcessor reused;
+    ASSERT_EQ(reused.getMemoryRetentionPolicy(), MemoryRetentionPolicy::RetainBuffers);
+    reused.setSoloMode(SoloMode::Band1);
+    reused.prepareToPlay(48000.0, blockSize);
+    for (int block = 0; block < 4; ++block)
+    {
+        AudioBuffer<float> copy(warmup);
+        reused.processBlock(copy, midi);
+    }
+    reused.releaseResources();
+    // Retained: the window is still held (by the processor and this lookup)
+    EXPECT_EQ(SharedSpectrumResources::getWindow(2048, dsp::WindowingFunction<float>::hann, false).use_count(), 2);
+
+    // Same configuration, then a sample-rate switch: both must match a fresh instance
+    for (const double sampleRate : { 48000.0, 44100.0 })
+    {
+        reused.prepareToPlay(sampleRate, blockSize);
+        TrinityAudioProcessor fresh;
+        fresh.setSoloMode(SoloMode::Band1);
+        fresh.prepareToPlay(sampleRate, blockSize);
+        EXPECT_DOUBLE_EQ(reused.getDisplayMaxHz(), fresh.getDisplayMaxHz());
+
+        AudioBuffer<float> reusedOut(probe);
+        AudioBuffer<float> freshOut(probe);
+        reused.processBlock(reusedOut, midi);
+        fresh.processBlock(freshOut, midi);
+        for (int channel = 0; channel < 2; ++channel)
+        {
+            for (int sampleIndex = 0; sampleIndex < blockSize; ++sampleIndex)
+            {
+                ASSERT_EQ(reusedOut.getSample(channel, sampleIndex), freshOut.getSample(channel, sampleIndex))
+                    << "rate " << sampleRate << ", channel " << channel << ", sample " << sampleIndex;
+            }
+        }
+        reused.releaseResources();
+    }
+
+    reused.setMemoryRetentionPolicy(MemoryRetentionPolicy::ReleaseAll);
+    reused.prepareToPlay(48000.0, blockSize);
+    reused.releaseResources();
+    EXPECT_EQ(SharedSpectrumResources::getWindow(2048, dsp::WindowingFunction<float>::hann, false).use_count(), 1);
+}
+
+TEST(TrinityProcessorTest, CrossoverParametersGlideWithoutStepsAndPersist) {
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 480;
+    TrinityAudioProcessor processor;
+    ASSERT_EQ(processor.getParameters().size(), 1 + CrossoverFrequencies::maxCutoffs);
+    processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+    EXPECT_EQ(processor.getCrossoverFrequencies(), CrossoverFrequencies {});
+
+    // A 1 kHz tone through the band sum while both cutoffs glide across it:
+    // no sample-to-sample step much beyond the tone's own slope (0.065)
+    processor.setCrossoverFrequencies(CrossoverFrequencies::withCutoffs({ 800.0f, 1200.0f }));
+    AudioBuffer<float> block(2, blockSize);
+    MidiBuffer midi;
+    double phase = 0.0;
+    float previous = 0.0f;
+    float largestStep = 0.0f;
+    for (int blockIndex = 0; blockIndex < 10; ++blockIndex)
+    {
+        for (int sampleIndex = 0; sampleIndex < blockSize; ++sampleIndex)
+        {
+            const auto tone = static_cast<float>(0.5 * std::sin(phase));
+            phase += MathConstants<double>::twoPi * 1000.0 / sampleRate;
+            block.setSample(0, sampleIndex, tone);
+            block.setSample(1, sampleIndex, tone);
+        }
+        processor.processBlock(block, midi);
+        for (int sampleIndex = 0; sampleIndex < blockSize; ++sampleIndex)
+        {
+            largestStep = jmax(largestStep, std::abs(block.getSample(0, sampleIndex) - previous));
+            previous = block.getSample(0, sampleIndex);
+        }
+        if (blockIndex == 0)
+        {
+            // 10 ms into a 50 ms glide
+            const CrossoverFrequencies live = processor.getCrossoverFrequencies();
+            EXPECT_GT(live.cutoffsHz[0], 250.0f);
+            EXPECT_LT(live.cutoffsHz[0], 800.0f);
+            EXPECT_LT(live.cutoffsHz[1], 2000.0f);
+            EXPECT_GT(live.cutoffsHz[1], 1200.0f);
+        }
+    }
+    EXPECT_LT(largestStep, 0.1f);
+    EXPECT_NEAR(processor.getCrossoverFrequencies().cutoffsHz[0], 800.0f, 0.1f);
+    EXPECT_NEAR(processor.getCrossoverFrequencies().cutoffsHz[1], 1200.0f, 0.1f);
+
+    // The filters really moved: the low band is 6 dB down at its new cutoff
+    processor.setSoloMode(SoloMode::Band1);
+    processor.prepareToPlay(sampleRate, blockSize);
+    MeasurementSettings settings;
+    settings.startHz = 100.0;
+    settings.tonesPerOctave = 12;
+    const MeasuredResponse low = MeasurementAnalysis::measure(kImpulse, settings, sampleRate, 2, blockSize, [&](AudioBuffer<float>& measured)
+    {
+        processor.processBlock(measured, midi);
+    });
+    for (size_t point = 0; point < low.frequencyHz.size(); ++point)
+    {
+        if (std::abs(low.frequencyHz[point] - 800.0) < 20.0)
+        {
+            EXPECT_NEAR(low.magnitudeDb[point], -6.0, 0.5) << low.frequencyHz[point];
+        }
+    }
+
+    // Parameters are the plugin state; colliding cutoffs are pushed apart
+    processor.setCrossoverFrequencies(CrossoverFrequencies::withCutoffs({ 900.0f, 1000.0f }));
+    MemoryBlock state;
+    processor.getStateInformation(state);
+    TrinityAudioProcessor restored;
+    restored.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+    restored.prepareToPlay(sampleRate, blockSize);
+    EXPECT_NEAR(restored.getCrossoverFrequencies().cutoffsHz[0], 900.0f, 0.05f);
+    EXPECT_NEAR(restored.getCrossoverFrequencies().cutoffsHz[1], 900.0f * CrossoverFrequencies::minRatio, 0.05f);
+}
+
+TEST(CrossoverTreeTest, BandsSumFlatForTwoToEightBands) {
+    constexpr double sampleRate = 48000.0;
+    constexpr int length = 16384;
+    const auto magnitudeDbAt = [](const std::vector<float>& response, double frequencyHz)
+    {
+        std::complex<double> sum;
+        for (size_t n = 0; n < response.size(); ++n)
+        {
+            sum += static_cast<double>(response[n])
+                 * std::polar(1.0, -MathConstants<double>::twoPi * frequencyHz * static_cast<double>(n) / sampleRate);
+        }
+        return 20.0 * std::log10(std::abs(sum));
+    };
+
+    for (int numBands = CrossoverFrequencies::minBands; numBands <= CrossoverFrequencies::maxBands; ++numBands)
+    {
+        CrossoverFrequencies frequencies;
+        frequencies.numBands = numBands;
+        frequencies = frequencies.constrainedTo(sampleRate);
+        CrossoverTree crossover;
+        crossover.prepare(sampleRate, 1);
+        crossover.setCutoffs(frequencies);
+        ASSERT_EQ(crossover.getNumBands(), numBands);
+
+        // Impulse responses of the band sum and of the lowest band
+        std::vector<float> sum(length, 0.0f);
+        std::vector<float> low(length, 0.0f);
+        sum[0] = 1.0f;
+        low[0] = 1.0f;
+        std::array<float, CrossoverTree::maxBands> peaks {};
+        CrossoverTree::BandTaps taps;
+        taps.peaks = peaks.data();
+        float* sumChannel = sum.data();
+        crossover.process(&sumChannel, &sumChannel, 1, 0, length, -1, taps);
+        crossover.reset();
+        float* lowChannel = low.data();
+        crossover.process(&lowChannel, &lowChannel, 1, 0, length, 0, taps);
+
+        for (const double frequencyHz : { 30.0, 100.0, 440.0, 1000.0, 2500.0, 5000.0, 9000.0, 15000.0, 19000.0 })
+        {
+            EXPECT_NEAR(magnitudeDbAt(sum, frequencyHz), 0.0, 0.01) << numBands << " bands at " << frequencyHz;
+        }
+        EXPECT_NEAR(magnitudeDbAt(low, frequencies.cutoffsHz[0]), -6.02, 0.05) << numBands << " bands";
+    }
+
+    // Five bands through the processor: every band meters, soloing one plays it
+    constexpr int blockSize = 480;
+    TrinityAudioProcessor processor;
+    CrossoverFrequencies fiveBands = CrossoverFrequencies::withCutoffs({ 200.0f, 800.0f, 3000.0f, 9000.0f });
+    processor.setCrossoverFrequencies(fiveBands);
+    processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+    EXPECT_EQ(processor.getNumBands(), 5);
+    AudioBuffer<float> block(2, blockSize);
+    MidiBuffer midi;
+    XorshiftNoise noise;
+    for (int blockIndex = 0; blockIndex < 20; ++blockIndex)
+    {
+        noise.fill(block.getWritePointer(0), blockSize, 0.25f);
+        block.copyFrom(1, 0, block, 0, 0, blockSize);
+        processor.processBlock(block, midi);
+    }
+    for (int band = 0; band < 5; ++band)
+    {
+        EXPECT_GT(processor.getBandLevel(band), 0.001f) << "band " << band;
+    }
+    EXPECT_EQ(processor.getBandLevel(5), 0.0f);
+
+    processor.setSoloMode(soloModeForBand(3));
+    processor.prepareToPlay(sampleRate, blockSize);
+    MeasurementSettings settings;
+    settings.startHz = 100.0;
+    settings.tonesPerOctave = 12;
+    const MeasuredResponse band4 = MeasurementAnalysis::measure(kImpulse, settings, sampleRate, 2, blockSize, [&](AudioBuffer<float>& measured)
+    {
+        processor.processBlock(measured, midi);
+    });
+    for (size_t point = 0; point < band4.frequencyHz.size(); ++point)
+    {
+        const double frequencyHz = band4.frequencyHz[point];
+        if (frequencyHz > 4000.0 && frequencyHz < 7000.0)
+        {
+            EXPECT_GT(band4.magnitudeDb[point], -3.0) << frequencyHz;
+        }
+        if (frequencyHz < 400.0)
+        {
+            EXPECT_LT(band4.magnitudeDb[point], -40.0) << frequencyHz;
+        }
+    }
+}
+
+TEST(LevelAccumulatorTest, KeepsEveryPeakAndTheExactRmsBetweenReadings) {
+    // Several blocks per reading: an early transient survives quieter blocks
+    LevelAccumulator meter;
+    meter.accumulate(0.9f, 0.0f, 64);
+    meter.accumulate(0.1f, 64 * 0.01f, 64);
+    meter.accumulate(0.2f, 64 * 0.04f, 64);
+    EXPECT_FLOAT_EQ(meter.peek().peak, 0.9f);
+    const LevelReading reading = meter.take();
+    EXPECT_FLOAT_EQ(reading.peak, 0.9f);
+    EXPECT_EQ(reading.numSamples, 192u);
+    EXPECT_NEAR(reading.meanSquare, (0.64f + 2.56f) / 192.0f, 1.0e-6f);
+    const LevelReading empty = meter.take();
+    EXPECT_EQ(empty.peak, 0.0f);
+    EXPECT_EQ(empty.numSamples, 0u);
+
+    // Through the processor: a one-sample click in the first of many blocks
+    // is still there when the meters are read afterwards, and a full-scale
+    // sine reads -3 dB RMS on the total meter
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 480;
+    TrinityAudioProcessor processor;
+    processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+    AudioBuffer<float> block(2, blockSize);
+    MidiBuffer midi;
+    double phase = 0.0;
+    for (int blockIndex = 0; blockIndex < 10; ++blockIndex)
+    {
+        for (int sampleIndex = 0; sampleIndex < blockSize; ++sampleIndex)
+        {
+            const auto tone = static_cast<float>(0.5 * std::sin(phase));
+            phase += MathConstants<double>::twoPi * 1000.0 / sampleRate;
+            block.setSample(0, sampleIndex, tone);
+            block.setSample(1, sampleIndex, tone);
+        }
+        if (blockIndex == 0)
+        {
+            block.setSample(0, 7, 0.95f);
+        }
+        processor.processBlock(block, midi);
+    }
+    const LevelReading total = processor.takeTotalLevel();
+    EXPECT_FLOAT_EQ(total.peak, 0.95f);
+    EXPECT_EQ(total.numSamples, static_cast<uint32_t>(10 * blockSize * 2));
+    EXPECT_NEAR(Decibels::gainToDecibels(total.getRms()), Decibels::gainToDecibels(0.5f / std::sqrt(2.0f)), 0.05f);
+    EXPECT_EQ(processor.takeTotalLevel().numSamples, 0u);
+
+    // 1 kHz sits in the mid band at the default crossover
+    const LevelReading mid = processor.takeBandLevel(1);
+    EXPECT_GT(mid.getRms(), 0.3f);
+    EXPECT_LT(processor.takeBandLevel(0).getRms(), mid.getRms());
+}
+
+TEST(LoudnessMeterTest, MatchesEbuReferenceCasesAndMetersEveryBand) {
+    // Stereo 1 kHz tones as in EBU Tech 3341/3342, fed in 512-frame blocks;
+    // the K-weighting is designed per rate, so every rate reads the same
+    double phase = 0.0;
+    for (const double rate : { 44100.0, 48000.0, 96000.0 })
+    {
+        LoudnessMeter meter;
+        meter.prepare(rate, 2);
+        meter.setNumSignals(1);
+        const auto feed = [&](double levelDbfs, double seconds)
+        {
+            const auto numFrames = static_cast<int>(seconds * rate);
+            const double amplitude = Decibels::decibelsToGain(levelDbfs);
+            const int numLanes = 2 * meter.getNumSignals();
+            std::vector<float> frames(static_cast<size_t>(numLanes * numFrames));
+            for (int frame = 0; frame < numFrames; ++frame)
+            {
+                const auto tone = static_cast<float>(amplitude * std::sin(phase));
+                phase += MathConstants<double>::twoPi * 1000.0 / rate;
+                std::fill_n(frames.begin() + numLanes * frame, numLanes, tone);
+            }
+            for (int frame = 0; frame < numFrames; frame += 512)
+            {
+                meter.process(frames.data() + numLanes * frame, numLanes, jmin(512, numFrames - frame));
+            }
+        };
+
+        // -23 dBFS reads -23 LUFS on every scale, with no range
+        feed(-23.0, 20.0);
+        LoudnessReading reading = meter.getReading(0);
+        EXPECT_NEAR(reading.momentaryLufs, -23.0f, 0.1f) << rate;
+        EXPECT_NEAR(reading.shortTermLufs, -23.0f, 0.1f) << rate;
+        EXPECT_NEAR(reading.integratedLufs, -23.0f, 0.1f) << rate;
+        EXPECT_NEAR(reading.loudnessRangeLu, 0.0f, 0.1f) << rate;
+
+        // Quiet stretches below the relative gate leave integrated loudness alone
+        meter.reset();
+        EXPECT_FALSE(meter.getReading(0).hasIntegrated());
+        feed(-46.0, 10.0);
+        feed(-23.0, 20.0);
+        feed(-46.0, 10.0);
+        EXPECT_NEAR(meter.getReading(0).integratedLufs, -23.0f, 0.15f) << rate;
+
+        // 20 s at -20 then 20 s at -30 spans 10 LU
+        meter.reset();
+        feed(-20.0, 20.0);
+        feed(-30.0, 20.0);
+        EXPECT_NEAR(meter.getReading(0).loudnessRangeLu, 10.0f, 1.0f) << rate;
+
+        // A new band count restarts the bands but not the input
+        meter.setNumSignals(2);
+        feed(-23.0, 5.0);
+        const float inputBefore = meter.getReading(0).integratedLufs;
+        ASSERT_TRUE(meter.getReading(1).hasIntegrated());
+        meter.setNumSignals(3);
+        EXPECT_EQ(meter.getReading(0).integratedLufs, inputBefore) << rate;
+        EXPECT_FALSE(meter.getReading(1).hasIntegrated()) << rate;
+    }
+
+    // Through the processor: the input and each band, from the shared split
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 480;
+    TrinityAudioProcessor processor;
+    processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+    AudioBuffer<float> block(2, blockSize);
+    MidiBuffer midi;
+    const double amplitude = Decibels::decibelsToGain(-23.0);
+    for (int blockIndex = 0; blockIndex < 500; ++blockIndex)
+    {
+        for (int sampleIndex = 0; sampleIndex < blockSize; ++sampleIndex)
+        {
+            const auto tone = static_cast<float>(amplitude * std::sin(phase));
+            phase += MathConstants<double>::twoPi * 1000.0 / sampleRate;
+            block.setSample(0, sampleIndex, tone);
+            block.setSample(1, sampleIndex, tone);
+        }
+        processor.processBlock(block, midi);
+    }
+    const LoudnessReading total = processor.getLoudness(0);
+    EXPECT_NEAR(total.integratedLufs, -23.0f, 0.1f);
+    // 1 kHz is in the mid band, half an LR4 octave below its upper cutoff
+    const LoudnessReading mid = processor.getLoudness(2);
+    EXPECT_LT(mid.integratedLufs, total.integratedLufs);
+    EXPECT_GT(mid.integratedLufs, -24.0f);
+    EXPECT_LT(processor.getLoudness(1).shortTermLufs, -50.0f);
+    EXPECT_LT(processor.getLoudness(3).shortTermLufs, -35.0f);
+
+    processor.resetLoudness();
+    processor.processBlock(block, midi);
+    EXPECT_FALSE(processor.getLoudness(0).hasIntegrated());
+}
+
+#if TRINITY_RT_SANITIZER
+TEST(RealtimeSanitizerTest, RecordsAllocationsAndLocksWithStackTraces) {
+    RealtimeSanitizer::reset();
+    std::vector<float> outside(64); // not real-time: ignored
+    std::mutex mutex;
+    {
+        RealtimeSanitizer::ScopedRealtimeSection realtime;
+        std::vector<float> inside(64);
+        const std::lock_guard<std::mutex> lock(mutex);
+        outside[0] = inside[1];
+    }
+    EXPECT_GE(RealtimeSanitizer::getViolationCount(), 3); // new, lock, delete
+    const std::vector<RealtimeViolation> violations = RealtimeSanitizer::getViolations();
+    ASSERT_FALSE(violations.empty());
+    EXPECT_EQ(violations.front().kind, RealtimeViolationKind::Allocation);
+    EXPECT_EQ(violations.front().bytes, 64 * sizeof(float));
+    EXPECT_TRUE(violations.front().stackTrace.isNotEmpty());
+
+   #if defined(__GLIBC__)
+    // Aligned allocation and blocking waits are intercepted as well
+    RealtimeSanitizer::reset();
+    sem_t semaphore;
+    sem_init(&semaphore, 0, 1);
+    void* aligned = nullptr;
+    {
+        RealtimeSanitizer::ScopedRealtimeSection realtime;
+        ASSERT_EQ(posix_memalign(&aligned, 64, 256), 0);
+        sem_wait(&semaphore);  // available: records without blocking
+    }
+    std::free(aligned);
+    sem_destroy(&semaphore);
+    StringArray functions;
+    for (const RealtimeViolation& violation : RealtimeSanitizer::getViolations())
+    {
+        functions.add(violation.function);
+    }
+    EXPECT_TRUE(functions.contains("posix_memalign")) << functions.joinIntoString(", ");
+    EXPECT_TRUE(functions.contains("sem_wait")) << functions.joinIntoString(", ");
+   #endif
+    RealtimeSanitizer::reset();
+}
+
+TEST(RealtimeSanitizerTest, ProcessBlockNeverAllocatesOrLocksOverRandomizedRun) {
+    constexpr int preparedBlock = 512;
+    constexpr int maxBlock = 2 * preparedBlock; // hosts may exceed the announced size
+    TrinityAudioProcessor processor;
+    processor.setPlayConfigDetails(2, 2, 48000.0, preparedBlock);
+    processor.prepareToPlay(48000.0, preparedBlock);
+    processor.setPipelineCaptureStages(allPipelineStages);
+    // Neither history is allocated until a capture starts
+    EXPECT_EQ(processor.getDebugRecorder().getRingBytes(), 0u);
+    EXPECT_EQ(processor.getSpikeCatcher().getRingBytes(), 0u);
+    TemporaryFile capture(DebugCaptureFile::fileExtension);
+    ASSERT_TRUE(processor.startDebugCapture(capture.getFile()));
+    EXPECT_GT(processor.getDebugRecorder().getRingBytes(), 0u);
+    const File spikeDirectory = File::getSpecialLocation(File::tempDirectory).getNonexistentChildFile("trinity_rt_spikes", "");
+    ASSERT_TRUE(processor.startSpikeCatcher(spikeDirectory, 0.0)); // every block counts as a spike
+
+    AudioBuffer<float> floatStorage(2, maxBlock);
+    AudioBuffer<double> doubleStorage(2, maxBlock);
+    MidiBuffer midi;
+    Random random(0x7e57);
+    RealtimeSanitizer::reset();
+    for (int iteration = 0; iteration < 4000; ++iteration)
+    {
+        const int numSamples = 1 + random.nextInt(maxBlock);
+        processor.setSoloMode(static_cast<SoloMode>(random.nextInt(4)));
+        processor.setFreqSmoothingEnabled(random.nextBool());
+        processor.setBandSmoothingEnabled(random.nextBool());
+        processor.setTaperPercent(random.nextFloat() * 0.2f);
+        processor.setTestEnabled(random.nextInt(4) == 0);
+        processor.setTestType(random.nextInt(6));
+        // Cutoff glides, band-count and layout swaps happen on the audio thread
+        if (random.nextInt(8) == 0)
+        {
+            CrossoverFrequencies crossover;
+            crossover.numBands = CrossoverFrequencies::minBands
+                               + random.nextInt(CrossoverFrequencies::maxBands - CrossoverFrequencies::minBands + 1);
+            for (float& cutoffHz : crossover.cutoffsHz)
+            {
+                cutoffHz = CrossoverFrequencies::minHz * std::pow(CrossoverFrequencies::maxHz / CrossoverFrequencies::minHz, random.nextFloat());
+            }
+            processor.setCrossoverFrequencies(crossover);
+        }
+        if (random.nextInt(8) == 0)
+        {
+            processor.setGuardPercent(0.05f * static_cast<float>(random.nextInt(5)));
+        }
+
+        if (random.nextBool())
+        {
+            for (int channel = 0; channel < 2; ++channel)
+            {
+                for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex)
+                {
+                    floatStorage.setSample(channel, sampleIndex, random.nextFloat() * 2.0f - 1.0f);
+                }
+            }
+            AudioBuffer<float> block(floatStorage.getArrayOfWritePointers(), 2, numSamples);
+            processor.processBlock(block, midi);
+        }
+        else
+        {
+            for (int channel = 0; channel < 2; ++channel)
+            {
+                for (int sampleIndex = 0; sampleIndex < numSamples; ++sampleIndex)
+                {
+                    doubleStorage.setSample(channel, sampleIndex, random.nextDouble() * 2.0 - 1.0);
+                }
+            }
+            AudioBuffer<double> block(doubleStorage.getArrayOfWritePointers(), 2, numSamples);
+            processor.processBlock(block, midi);
+        }
+    }
+    processor.stopDebugCapture();
+    processor.stopSpikeCatcher();
+
+    EXPECT_EQ(RealtimeSanitizer::getViolationCount(), 0) << RealtimeSanitizer::describeViolations();
+    EXPECT_GT(processor.getDebugRecorder().getWrittenCount(), 0u);
+    EXPECT_GT(processor.getSpikeCatcher().getSpikesSeen(), 0u);
+    spikeDirectory.deleteRecursively();
+}
+#endif
+
 TEST(SpectrumProcessingTest, AllowedEndAndZeroing) {
     const double sampleRate = 48000.0;
     const int fftSize = 2048;
@@ -0,0 +1,423 @@
+// Offline spectral and band-level analysis for QC.
+// Runs the processor's spectrum pipeline and crossover metering over audio
+// files (see OfflineBandAnalyzer). Long files are split into chunks with
+// warm-up overlap that run on all cores; chunks are merged in frame order, so
+// the output does not depend on the thread count.
+//
+//   trinity_analyze [--format csv|json] [--frames] [--out DIR] [--threads N]
+//                   [--bands N] [--fft-order N] [--chunk-frames N]
+//                   [--overlap-frames N] [--crossover HZ,HZ,...] files...
+//
+// Writes <name>.stats.csv (per-band and per-meter statistics plus the long-term
+// average spectrum) and, with --frames, <name>.bands.csv with per-frame data;
+// or a single <name>.analysis.json.
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "services/OfflineBandAnalyzer.h"
+
+namespace
+{
+    // "total", then the crossover bands: "low", "mid" (or "mid1", ...), "high"
+    String meterName(int meter, int numMeters)
+    {
+        if (meter == 0)
+        {
+            return "total";
+        }
+        return String(CrossoverFrequencies::bandName(meter - 1, numMeters - 1)).toLowerCase().removeCharacters(" ");
+    }
+
+    struct AnalyzeOptions
+    {
+        OfflineAnalysisSettings settings;
+        bool json { false };
+        bool perFrame { false };
+        int threads { SystemStats::getNumCpus() };
+        File outputDirectory;  // empty: next to each input
+        Array<File> inputs;
+    };
+
+    struct FileJob
+    {
+        File input;
+        double sampleRate { 0.0 };
+        int numChannels { 0 };
+        int64 numFrames { 0 };
+        int numChunks { 0 };
+        std::vector<BandAnalysisChunk> chunks;
+        std::atomic<int> chunksRemaining { 0 };
+        std::atomic<bool> chunkFailed { false };  // a worker could not reopen the file
+        int64 startTicks { 0 };
+    };
+
+    void printUsage()
+    {
+        std::fprintf(stderr,
+                     "usage: trinity_analyze [--format csv|json] [--frames] [--out DIR] [--threads N]\n"
+                     "                       [--bands N] [--fft-order N] [--chunk-frames N]\n"
+                     "                       [--overlap-frames N] [--crossover HZ,HZ,...] files...\n");
+    }
+
+    bool parseOptions(int argc, char* argv[], AnalyzeOptions& options)
+    {
+        const File workingDirectory = File::getCurrentWorkingDirectory();
+        for (int argIndex = 1; argIndex < argc; ++argIndex)
+        {
+            const String arg(argv[argIndex]);
+            const bool hasValue = argIndex + 1 < argc;
+            if (arg == "--frames")
+            {
+                options.perFrame = true;
+            }
+            else if (arg == "--format" && hasValue)
+            {
+                options.json = String(argv[++argIndex]).equalsIgnoreCase("json");
+            }
+            else if (arg == "--out" && hasValue)
+            {
+                options.outputDirectory = workingDirectory.getChildFile(argv[++argIndex]);
+            }
+            else if (arg == "--threads" && hasValue)
+            {
+                options.threads = jmax(1, String(argv[++argIndex]).getIntValue());
+            }
+            else if (arg == "--bands" && hasValue)
+            {
+                options.settings.numBands = jlimit(8, 512, String(argv[++argIndex]).getIntValue());
+            }
+            else if (arg == "--fft-order" && hasValue)
+            {
+                options.settings.fftOrder = jlimit(8, 15, String(argv[++argIndex]).getIntValue());
+            }
+            else if (arg == "--chunk-frames" && hasValue)
+            {
+                options.settings.chunkFrames = jmax(1, String(argv[++argIndex]).getIntValue());
+            }
+            else if (arg == "--overlap-frames" && hasValue)
+            {
+                options.settings.overlapFrames = jmax(0, String(argv[++argIndex]).getIntValue());
+            }
+            else if (arg == "--crossover" && hasValue)
+            {
+                // Ascending cutoffs in Hz, one fewer than the bands: 250,2000 for three
+                const StringArray cutoffs = StringArray::fromTokens(argv[++argIndex], ",", "");
+                if (cutoffs.isEmpty() || cutoffs.size() > CrossoverFrequencies::maxCutoffs)
+                {
+                    return false;
+                }
+                options.settings.crossover.numBands = cutoffs.size() + 1;
+                for (int cutoff = 0; cutoff < cutoffs.size(); ++cutoff)
+                {
+                    options.settings.crossover.cutoffsHz[static_cast<size_t>(cutoff)] = cutoffs[cutoff].getFloatValue();
+                }
+            }
+            else if (arg.startsWith("--"))
+            {
+                return false;
+            }
+            else
+            {
+                options.inputs.add(workingDirectory.getChildFile(arg));
+            }
+        }
+        return !options.inputs.isEmpty();
+    }
+
+    File outputFile(const File& input, const AnalyzeOptions& options, const char* suffix)
+    {
+        const File directory = options.outputDirectory == File() ? input.getParentDirectory()
+                                                                 : options.outputDirectory;
+        return directory.getChildFile(input.getFileNameWithoutExtension() + suffix);
+    }
+
+    // Per-frame meter peaks in dBFS, same layout as BandAnalysisChunk::meterPeaks.
+    std::vector<float> meterPeaksDb(const BandAnalysisChunk& merged)
+    {
+        std::vector<float> peaksDb(merged.meterPeaks.size());
+        for (size_t index = 0; index < peaksDb.size(); ++index)
+        {
+            peaksDb[index] = Decibels::gainToDecibels(merged.meterPeaks[index], -120.0f);
+        }
+        return peaksDb;
+    }
+
+    bool writeText(const File& file, const String& text)
+    {
+        file.getParentDirectory().createDirectory();
+        return file.replaceWithText(text);
+    }
+
+    bool writeCsv(const FileJob& job, const OfflineBandAnalyzer& analyzer, const BandAnalysisChunk& merged,
+                  const AnalyzeOptions& options)
+    {
+        const int numBands = analyzer.getNumBands();
+        const std::vector<float> ltasDb = analyzer.longTermAverageDb(merged);
+        const std::vector<float> peaksDb = meterPeaksDb(merged);
+
+        String stats = "kind,index,f0_hz,f1_hz,mean,min,max,p50,p95,ltas_db\n";
+        for (int band = 0; band < numBands; ++band)
+        {
+            const BandLevelStats level = OfflineBandAnalyzer::columnStats(merged.bands, numBands, band);
+            stats << "band," << band << "," << analyzer.getBandStartHz()[static_cast<size_t>(band)] << ","
+                  << analyzer.getBandEndHz()[static_cast<size_t>(band)] << "," << level.mean << "," << level.min << ","
+                  << level.max << "," << level.p50 << "," << level.p95 << "," << ltasDb[static_cast<size_t>(band)] << "\n";
+        }
+        for (int meter = 0; meter < merged.numMeters; ++meter)
+        {
+            const BandLevelStats level = OfflineBandAnalyzer::columnStats(peaksDb, merged.numMeters, meter);
+            stats << "meter_peak_db," << meterName(meter, merged.numMeters) << ",,," << level.mean << "," << level.min << ","
+                  << level.max << "," << level.p50 << "," << level.p95 << ",\n";
+        }
+        if (!writeText(outputFile(job.input, options, ".stats.csv"), stats))
+        {
+            return false;
+        }
+        if (!options.perFrame)
+        {
+            return true;
+        }
+
+        const double frameSeconds = static_cast<double>(analyzer.getFrameSize()) / job.sampleRate;
+        const File framesFile = outputFile(job.input, options, ".bands.csv");
+        framesFile.deleteFile();
+        FileOutputStream frames(framesFile);
+        if (!frames.openedOk())
+        {
+            return false;
+        }
+        String header = "frame,time_s";
+        for (int meter = 0; meter < merged.numMeters; ++meter)
+        {
+            header << "," << meterName(meter, merged.numMeters) << "_peak_db";
+        }
+        for (int band = 0; band < numBands; ++band)
+        {
+            header << ",band" << band;
+        }
+        frames.writeString(header + "\n");
+        for (int frame = 0; frame < merged.numFrames; ++frame)
+        {
+            String line;
+            line << frame << "," << static_cast<double>(frame) * frameSeconds;
+            for (int meter = 0; meter < merged.numMeters; ++meter)
+            {
+                line << "," << peaksDb[static_cast<size_t>(frame * merged.numMeters + meter)];
+            }
+            for (int band = 0; band < numBands; ++band)
+            {
+                line << "," << merged.bands[static_cast<size_t>(frame) * static_cast<size_t>(numBands) + static_cast<size_t>(band)];
+            }
+            frames.writeString(line + "\n");
+        }
+        return true;
+    }
+
+    var statsToVar(const BandLevelStats& level)
+    {
+        auto object = std::make_unique<DynamicObject>();
+        object->setProperty("mean", level.mean);
+        object->setProperty("min", level.min);
+        object->setProperty("max", level.max);
+        object->setProperty("p50", level.p50);
+        object->setProperty("p95", level.p95);
+        return var(object.release());
+    }
+
+    bool writeJson(const FileJob& job, const OfflineBandAnalyzer& analyzer, const BandAnalysisChunk& merged,
+                   const AnalyzeOptions& options)
+    {
+        const int numBands = analyzer.getNumBands();
+        const std::vector<float> ltasDb = analyzer.longTermAverageDb(merged);
+        const std::vector<float> peaksDb = meterPeaksDb(merged);
+
+        auto root = std::make_unique<DynamicObject>();
+        root->setProperty("file", job.input.getFileName());
+        root->setProperty("sampleRate", job.sampleRate);
+        root->setProperty("channels", job.numChannels);
+        root->setProperty("frameSize", analyzer.getFrameSize());
+        root->setProperty("frames", merged.numFrames);
+        root->setProperty("displayMaxHz", analyzer.getDisplayMaxHz());
+
+        Array<var> bands;
+        for (int band = 0; band < numBands; ++band)
+        {
+            auto entry = std::make_unique<DynamicObject>();
+            entry->setProperty("f0Hz", analyzer.getBandStartHz()[static_cast<size_t>(band)]);
+            entry->setProperty("f1Hz", analyzer.getBandEndHz()[static_cast<size_t>(band)]);
+            entry->setProperty("level", statsToVar(OfflineBandAnalyzer::columnStats(merged.bands, numBands, band)));
+            entry->setProperty("ltasDb", ltasDb[static_cast<size_t>(band)]);
+            bands.add(var(entry.release()));
+        }
+        root->setProperty("bands", bands);
+
+        auto meters = std::make_unique<DynamicObject>();
+        for (int meter = 0; meter < merged.numMeters; ++meter)
+        {
+            meters->setProperty(meterName(meter, merged.numMeters),
+                                statsToVar(OfflineBandAnalyzer::columnStats(peaksDb, merged.numMeters, meter)));
+        }
+        root->setProperty("meterPeakDb", var(meters.release()));
+
+        if (options.perFrame)
+        {
+            Array<var> frames;
+            frames.ensureStorageAllocated(merged.numFrames);
+            for (int frame = 0; frame < merged.numFrames; ++frame)
+            {
+                Array<var> values;
+                for (int meter = 0; meter < merged.numMeters; ++meter)
+                {
+                    values.add(peaksDb[static_cast<size_t>(frame * merged.numMeters + meter)]);
+                }
+                for (int band = 0; band < numBands; ++band)
+                {
+                    values.add(merged.bands[static_cast<size_t>(frame) * static_cast<size_t>(numBands) + static_cast<size_t>(band)]);
+                }
+                frames.add(values);
+            }
+            String frameLayout;
+            for (int meter = 0; meter < merged.numMeters; ++meter)
+            {
+                frameLayout << meterName(meter, merged.numMeters) << "PeakDb,";
+            }
+            frameLayout << "band0..band" << (numBands - 1);
+            root->setProperty("frameLayout", frameLayout);
+            root->setProperty("frameData", frames);
+        }
+
+        return writeText(outputFile(job.input, options, ".analysis.json"), JSON::toString(var(root.release())));
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    AnalyzeOptions options;
+    if (!parseOptions(argc, argv, options))
+    {
+        printUsage();
+        return 2;
+    }
+
+    AudioFormatManager formats;
+    formats.registerBasicFormats();
+
+    // Open every file once up front to size its chunks
+    std::vector<std::unique_ptr<FileJob>> jobs;
+    int failures = 0;
+    for (const File& input : options.inputs)
+    {
+        std::unique_ptr<AudioFormatReader> reader(formats.createReaderFor(input));
+        auto job = std::make_unique<FileJob>();
+        job->input = input;
+        if (reader != nullptr)
+        {
+            job->sampleRate = reader->sampleRate;
+            job->numChannels = static_cast<int>(reader->numChannels);
+            job->numFrames = OfflineBandAnalyzer::countFrames(reader->lengthInSamples, options.settings.fftOrder);
+        }
+        if (reader == nullptr || job->numFrames == 0)
+        {
+            ++failures;
+            std::fprintf(stderr, "%s: %s\n", input.getFullPathName().toRawUTF8(),
+                         reader == nullptr ? "unsupported or unreadable file" : "shorter than one analysis frame");
+            continue;
+        }
+        const int64 chunkFrames = options.settings.chunkFrames;
+        job->numChunks = static_cast<int>((job->numFrames + chunkFrames - 1) / chunkFrames);
+        job->chunks.resize(static_cast<size_t>(job->numChunks));
+        job->chunksRemaining.store(job->numChunks);
+        jobs.push_back(std::move(job));
+    }
+
+    std::printf("file,frames,chunks,audio_s,wall_s,realtime_factor\n");
+    std::fflush(stdout);
+
+    std::mutex outputMutex;
+    std::atomic<int> fileFailures { 0 };
+    std::atomic<int> filesRemaining { static_cast<int>(jobs.size()) };
+    WaitableEvent allDone;
+    if (jobs.empty())
+    {
+        allDone.signal();
+    }
+
+    // The last chunk to finish merges and writes its file; a file with a
+    // missing chunk is reported and not written
+    auto finishFile = [&] (FileJob& job)
+    {
+        if (job.chunkFailed.load())
+        {
+            const std::lock_guard<std::mutex> lock(outputMutex);
+            ++fileFailures;
+            std::fprintf(stderr, "%s: could not reopen the file to analyse a chunk\n", job.input.getFullPathName().toRawUTF8());
+            if (--filesRemaining == 0)
+            {
+                allDone.signal();
+            }
+            return;
+        }
+        std::vector<BandAnalysisChunk> chunks;
+        chunks.swap(job.chunks);
+        const BandAnalysisChunk merged = OfflineBandAnalyzer::mergeChunks(std::move(chunks));
+        const OfflineBandAnalyzer layout(options.settings, job.sampleRate, job.numChannels);
+        const bool written = options.json ? writeJson(job, layout, merged, options)
+                                          : writeCsv(job, layout, merged, options);
+
+        const double audioSeconds = static_cast<double>(job.numFrames * layout.getFrameSize()) / job.sampleRate;
+        const double wallSeconds = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - job.startTicks);
+        const std::lock_guard<std::mutex> lock(outputMutex);
+        if (!written)
+        {
+            ++fileFailures;
+            std::fprintf(stderr, "%s: cannot write output\n", job.input.getFullPathName().toRawUTF8());
+        }
+        std::printf("%s,%d,%d,%.3f,%.3f,%.1f\n", job.input.getFileName().toRawUTF8(), merged.numFrames,
+                    job.numChunks, audioSeconds, wallSeconds, wallSeconds > 0.0 ? audioSeconds / wallSeconds : 0.0);
+        std::fflush(stdout);
+        if (--filesRemaining == 0)
+        {
+            allDone.signal();
+        }
+    };
+
+    ThreadPool pool(options.threads);
+    for (auto& jobPtr : jobs)
+    {
+        FileJob& job = *jobPtr;
+        job.startTicks = Time::getHighResolutionTicks();
+        for (size_t chunkIndex = 0; chunkIndex < job.chunks.size(); ++chunkIndex)
+        {
+            pool.addJob([&, chunkIndex]
+            {
+                AudioFormatManager workerFormats;
+                workerFormats.registerBasicFormats();
+                std::unique_ptr<AudioFormatReader> reader(workerFormats.createReaderFor(job.input));
+                const int64 firstFrame = static_cast<int64>(chunkIndex) * options.settings.chunkFrames;
+                const int numFrames = static_cast<int>(jmin(static_cast<int64>(options.settings.chunkFrames),
+                                                            job.numFrames - firstFrame));
+                if (reader != nullptr)
+                {
+                    OfflineBandAnalyzer analyzer(options.settings, job.sampleRate, job.numChannels);
+                    job.chunks[chunkIndex] = analyzer.analyseChunk(*reader, firstFrame, numFrames);
+                }
+                else
+                {
+                    job.chunkFailed.store(true);
+                }
+                if (--job.chunksRemaining == 0)
+                {
+                    finishFile(job);
+                }
+            });
+        }
+    }
+    allDone.wait(-1);
+
+    return failures + fileFailures.load() == 0 ? 0 : 1;
+}
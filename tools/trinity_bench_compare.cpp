@@ -0,0 +1,238 @@
+// Performance regression gate for trinity_bench.
+// Runs the benchmark binary with repetitions (or reads an existing JSON run)
+// and compares every selected benchmark against a checked-in baseline. Fails
+// when processBlock or a SpectrumProcessing kernel is significantly slower
+// (one-sided Mann-Whitney U) by more than the threshold.
+//
+//   trinity_bench_compare --baseline FILE (--bench EXE | --current FILE)
+//                         [--update-baseline] [--repetitions N] [--min-time S]
+//                         [--filter REGEX] [--threshold F] [--alpha F]
+//
+// Exit codes: 0 pass, 1 regression, 2 usage or I/O error. Baselines are only
+// meaningful on the machine that recorded them; refresh with --update-baseline
+// (or the trinity_update_perf_baseline target) after intended changes.
+
+#include <JuceHeader.h>
+#include <cstdio>
+#include <regex>
+#include <string>
+
+#include "services/BenchmarkComparison.h"
+
+namespace
+{
+    // Representative processBlock configurations plus every spectrum kernel
+    constexpr const char* defaultFilter =
+        "^BM_ProcessBlock/block:(64|256|1024)/rate:48000/channels:2/solo:0$"
+        "|^BM_(ComputeAllowedEndBin|ComputeLogBandEdges|ZeroStrictlyAbove|FrequencySmoothTriangular"
+        "|ApplyCosineTaper|BandMeanPower|AggregateBandsFractional|SmoothBandsInPlace)";
+
+    struct CompareOptions
+    {
+        File baseline;
+        File current;
+        File bench;
+        bool updateBaseline { false };
+        int repetitions { 10 };
+        String minTime { "0.05s" };
+        String filter { defaultFilter };
+        double threshold { 0.10 };
+        double alpha { 0.01 };
+    };
+
+    void printUsage()
+    {
+        std::fprintf(stderr,
+                     "usage: trinity_bench_compare --baseline FILE (--bench EXE | --current FILE)\n"
+                     "                             [--update-baseline] [--repetitions N] [--min-time S]\n"
+                     "                             [--filter REGEX] [--threshold F] [--alpha F]\n");
+    }
+
+    bool parseOptions(int argc, char* argv[], CompareOptions& options)
+    {
+        const File workingDirectory = File::getCurrentWorkingDirectory();
+        for (int argIndex = 1; argIndex < argc; ++argIndex)
+        {
+            const String arg(argv[argIndex]);
+            const bool hasValue = argIndex + 1 < argc;
+            if (arg == "--baseline" && hasValue)
+            {
+                options.baseline = workingDirectory.getChildFile(argv[++argIndex]);
+            }
+            else if (arg == "--current" && hasValue)
+            {
+                options.current = workingDirectory.getChildFile(argv[++argIndex]);
+            }
+            else if (arg == "--bench" && hasValue)
+            {
+                options.bench = workingDirectory.getChildFile(argv[++argIndex]);
+            }
+            else if (arg == "--update-baseline")
+            {
+                options.updateBaseline = true;
+            }
+            else if (arg == "--repetitions" && hasValue)
+            {
+                options.repetitions = jlimit(3, 100, String(argv[++argIndex]).getIntValue());
+            }
+            else if (arg == "--min-time" && hasValue)
+            {
+                options.minTime = argv[++argIndex];
+            }
+            else if (arg == "--filter" && hasValue)
+            {
+                options.filter = argv[++argIndex];
+            }
+            else if (arg == "--threshold" && hasValue)
+            {
+                options.threshold = jmax(0.0, String(argv[++argIndex]).getDoubleValue());
+            }
+            else if (arg == "--alpha" && hasValue)
+            {
+                options.alpha = jlimit(1.0e-6, 0.5, String(argv[++argIndex]).getDoubleValue());
+            }
+            else
+            {
+                return false;
+            }
+        }
+        const bool hasSource = options.bench != File() || options.current != File();
+        return options.baseline != File() && hasSource;
+    }
+
+    // Runs the benchmark binary into a JSON file; returns an error or empty.
+    String runBenchmarks(const CompareOptions& options, const File& output)
+    {
+        StringArray args;
+        args.add(options.bench.getFullPathName());
+        args.add("--benchmark_filter=" + options.filter);
+        args.add("--benchmark_repetitions=" + String(options.repetitions));
+        args.add("--benchmark_min_time=" + options.minTime);
+        args.add("--benchmark_format=console");
+        args.add("--benchmark_out_format=json");
+        args.add("--benchmark_out=" + output.getFullPathName());
+
+        ChildProcess process;
+        if (!process.start(args, ChildProcess::wantStdOut | ChildProcess::wantStdErr))
+        {
+            return "cannot start " + options.bench.getFullPathName();
+        }
+        // Drain output so the child never blocks on a full pipe
+        const String log = process.readAllProcessOutput();
+        process.waitForProcessToFinish(-1);
+        if (process.getExitCode() != 0)
+        {
+            std::fprintf(stderr, "%s\n", log.toRawUTF8());
+            return "benchmark run failed with exit code " + String(process.getExitCode());
+        }
+        return {};
+    }
+
+    bool isSelected(const std::regex& filter, const String& name)
+    {
+        return std::regex_search(name.toStdString(), filter);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    CompareOptions options;
+    if (!parseOptions(argc, argv, options))
+    {
+        printUsage();
+        return 2;
+    }
+
+    std::regex filter;
+    try
+    {
+        filter = std::regex(options.filter.toStdString(), std::regex::extended);
+    }
+    catch (const std::regex_error&)
+    {
+        std::fprintf(stderr, "invalid --filter: %s\n", options.filter.toRawUTF8());
+        return 2;
+    }
+
+    TemporaryFile runFile(".json");
+    File currentFile = options.current;
+    if (options.bench != File())
+    {
+        const String error = runBenchmarks(options, runFile.getFile());
+        if (error.isNotEmpty())
+        {
+            std::fprintf(stderr, "%s\n", error.toRawUTF8());
+            return 2;
+        }
+        currentFile = runFile.getFile();
+    }
+
+    const var currentJson = JSON::parse(currentFile);
+    const BenchmarkComparison::RunTimes currentTimes = BenchmarkComparison::loadRunTimes(currentJson);
+    if (currentTimes.empty())
+    {
+        std::fprintf(stderr, "no benchmark results in %s\n", currentFile.getFullPathName().toRawUTF8());
+        return 2;
+    }
+
+    if (options.updateBaseline)
+    {
+        options.baseline.getParentDirectory().createDirectory();
+        if (!currentFile.copyFileTo(options.baseline))
+        {
+            std::fprintf(stderr, "cannot write %s\n", options.baseline.getFullPathName().toRawUTF8());
+            return 2;
+        }
+        std::fprintf(stderr, "baseline updated: %s (%d benchmarks)\n",
+                     options.baseline.getFullPathName().toRawUTF8(), static_cast<int>(currentTimes.size()));
+        return 0;
+    }
+
+    const var baselineJson = JSON::parse(options.baseline);
+    const BenchmarkComparison::RunTimes baselineTimes = BenchmarkComparison::loadRunTimes(baselineJson);
+    if (baselineTimes.empty())
+    {
+        std::fprintf(stderr, "no benchmark results in %s\n", options.baseline.getFullPathName().toRawUTF8());
+        return 2;
+    }
+    const String baselineHost = baselineJson["context"]["host_name"].toString();
+    const String currentHost = currentJson["context"]["host_name"].toString();
+    if (baselineHost != currentHost)
+    {
+        std::fprintf(stderr, "warning: baseline recorded on '%s', running on '%s'\n",
+                     baselineHost.toRawUTF8(), currentHost.toRawUTF8());
+    }
+
+    int regressions = 0;
+    int missing = 0;
+    std::printf("benchmark,baseline_ns,current_ns,ratio,p_slower,verdict\n");
+    for (const auto& [name, baselineSamples] : baselineTimes)
+    {
+        if (!isSelected(filter, name))
+        {
+            continue;
+        }
+        const auto found = currentTimes.find(name);
+        if (found == currentTimes.end())
+        {
+            ++missing;
+            std::printf("%s,,,,,missing\n", name.toRawUTF8());
+            continue;
+        }
+        const BenchmarkVerdict verdict = BenchmarkComparison::compare(name, baselineSamples, found->second,
+                                                                      options.threshold, options.alpha);
+        regressions += verdict.regressed ? 1 : 0;
+        std::printf("%s,%.1f,%.1f,%.3f,%.4f,%s\n",
+                    name.toRawUTF8(), verdict.baselineMedianNs, verdict.currentMedianNs, verdict.ratio,
+                    verdict.pSlower,
+                    verdict.regressed ? "REGRESSED" : (verdict.improved ? "improved" : "ok"));
+    }
+
+    if (regressions > 0 || missing > 0)
+    {
+        std::fprintf(stderr, "%d regression(s), %d missing benchmark(s) (threshold %.0f%%, alpha %.3f)\n",
+                     regressions, missing, options.threshold * 100.0, options.alpha);
+        return 1;
+    }
+    return 0;
+}
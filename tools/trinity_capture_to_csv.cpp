@@ -0,0 +1,32 @@
+// Converts a binary debug capture into the csvVersion=2 CSV format.
+//
+//   trinity_capture_to_csv <capture.trcap> [output.csv]
+//
+// Without an output path the CSV is written next to the capture.
+
+#include <JuceHeader.h>
+#include <cstdio>
+
+#include "services/DebugCaptureFile.h"
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::fprintf(stderr, "usage: trinity_capture_to_csv <capture%s> [output.csv]\n", DebugCaptureFile::fileExtension);
+        return 2;
+    }
+
+    const File captureFile = File::getCurrentWorkingDirectory().getChildFile(argv[1]);
+    const File csvFile = argc > 2 ? File::getCurrentWorkingDirectory().getChildFile(argv[2])
+                                  : captureFile.withFileExtension(".csv");
+
+    const String error = DebugCaptureFile::convertToCsv(captureFile, csvFile);
+    if (error.isNotEmpty())
+    {
+        std::fprintf(stderr, "%s\n", error.toRawUTF8());
+        return 1;
+    }
+    std::printf("%s\n", csvFile.getFullPathName().toRawUTF8());
+    return 0;
+}
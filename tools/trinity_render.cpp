@@ -0,0 +1,451 @@
+// Offline renderer: runs audio files through TrinityAudioProcessor faster than
+// realtime and writes the processed files. Files are spread over a thread
+// pool with one processor instance per worker; each file reports its
+// realtime factor as CSV on stdout.
+//
+//   trinity_render [--block N] [--threads N] [--solo none|low|mid|high|1..8]
+//                  [--out DIR] [--trace FILE] input files (WAV/AIFF/FLAC)...
+//   trinity_render --replay BUNDLE [--runs N] [--trace FILE]
+//   trinity_render --measure impulse|sweep|mls|multitone [--solo ...] [--rate HZ] [--block N]
+//
+// --trace writes the per-stage processBlock trace as Chrome trace JSON
+// (builds configured with TRINITY_ENABLE_TRACING only).
+// --replay feeds a spike bundle (.trspike, written by the spike catcher) back
+// through a freshly prepared processor with the recorded block sizes and
+// control values, N times, and prints per-block timings as CSV.
+// --measure plays a measurement signal through a fresh processor and prints
+// the crossover's magnitude and phase as CSV, and the measured latency next
+// to the one the processor reports on stderr (exit code 1 if they differ).
+// The latency is always that of the full-band sum, also with --solo.
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "TrinityProcessor.h"
+#include "services/MeasurementAnalysis.h"
+#include "services/SpikeBundleFile.h"
+#include "services/TraceRecorder.h"
+
+namespace
+{
+    struct RenderOptions
+    {
+        int blockSize { 512 };
+        int threads { SystemStats::getNumCpus() };
+        SoloMode soloMode { SoloMode::None };
+        File outputDirectory;  // empty: next to each input
+        File traceFile;        // empty: no trace
+        File replayFile;       // spike bundle; replaces the inputs
+        int replayRuns { 5 };
+        String measureSignal;  // replaces the inputs
+        double measureRate { 48000.0 };
+        Array<File> inputs;
+    };
+
+    struct RenderResult
+    {
+        File output;
+        int numChannels { 0 };
+        double sampleRate { 0.0 };
+        double audioSeconds { 0.0 };
+        double processSeconds { 0.0 };  // processBlock only
+        double totalSeconds { 0.0 };    // including decode and encode
+        String error;
+    };
+
+    void printUsage()
+    {
+        std::fprintf(stderr,
+                     "usage: trinity_render [--block N] [--threads N] [--solo none|low|mid|high|1..8]\n"
+                     "                      [--out DIR] [--trace FILE] files...\n"
+                     "       trinity_render --replay BUNDLE [--runs N] [--trace FILE]\n"
+                     "       trinity_render --measure impulse|sweep|mls|multitone [--solo ...]\n"
+                     "                      [--rate HZ] [--block N]\n");
+    }
+
+    // Band number from 1, or low/mid/high for the bands of the default three-band split
+    SoloMode parseSoloMode(const String& name)
+    {
+        if (name.equalsIgnoreCase("low"))  return SoloMode::Band1;
+        if (name.equalsIgnoreCase("mid"))  return SoloMode::Band2;
+        if (name.equalsIgnoreCase("high")) return SoloMode::Band3;
+        return name.containsOnly("0123456789") ? soloModeForBand(name.getIntValue() - 1) : SoloMode::None;
+    }
+
+    int parseMeasurementSignal(const String& name)
+    {
+        if (name.equalsIgnoreCase("impulse"))   return kImpulse;
+        if (name.equalsIgnoreCase("sweep"))     return kSyncSweep;
+        if (name.equalsIgnoreCase("mls"))       return kMls;
+        if (name.equalsIgnoreCase("multitone")) return kMultitone;
+        return kOff;
+    }
+
+    bool parseOptions(int argc, char* argv[], RenderOptions& options)
+    {
+        const File workingDirectory = File::getCurrentWorkingDirectory();
+        for (int argIndex = 1; argIndex < argc; ++argIndex)
+        {
+            const String arg(argv[argIndex]);
+            const bool hasValue = argIndex + 1 < argc;
+            if (arg == "--block" && hasValue)
+            {
+                options.blockSize = jlimit(16, 65536, String(argv[++argIndex]).getIntValue());
+            }
+            else if (arg == "--threads" && hasValue)
+            {
+                options.threads = jmax(1, String(argv[++argIndex]).getIntValue());
+            }
+            else if (arg == "--solo" && hasValue)
+            {
+                options.soloMode = parseSoloMode(argv[++argIndex]);
+            }
+            else if (arg == "--out" && hasValue)
+            {
+                options.outputDirectory = workingDirectory.getChildFile(argv[++argIndex]);
+            }
+            else if (arg == "--trace" && hasValue)
+            {
+                options.traceFile = workingDirectory.getChildFile(argv[++argIndex]);
+            }
+            else if (arg == "--replay" && hasValue)
+            {
+                options.replayFile = workingDirectory.getChildFile(argv[++argIndex]);
+            }
+            else if (arg == "--runs" && hasValue)
+            {
+                options.replayRuns = jlimit(1, 1000, String(argv[++argIndex]).getIntValue());
+            }
+            else if (arg == "--measure" && hasValue)
+            {
+                options.measureSignal = argv[++argIndex];
+            }
+            else if (arg == "--rate" && hasValue)
+            {
+                options.measureRate = jlimit(8000.0, 384000.0, String(argv[++argIndex]).getDoubleValue());
+            }
+            else if (arg.startsWith("--"))
+            {
+                return false;
+            }
+            else
+            {
+                options.inputs.add(workingDirectory.getChildFile(arg));
+            }
+        }
+        return !options.inputs.isEmpty() || options.replayFile != File() || options.measureSignal.isNotEmpty();
+    }
+
+    // Keep the source bit depth when the output format supports it.
+    int chooseBitDepth(AudioFormat& format, int sourceBits)
+    {
+        const Array<int> depths = format.getPossibleBitDepths();
+        if (depths.contains(sourceBits))
+        {
+            return sourceBits;
+        }
+        return depths.contains(24) ? 24 : depths.getLast();
+    }
+
+    File outputFileFor(const File& input, const RenderOptions& options)
+    {
+        const File directory = options.outputDirectory == File() ? input.getParentDirectory()
+                                                                 : options.outputDirectory;
+        return directory.getChildFile(input.getFileNameWithoutExtension() + "_trinity" + input.getFileExtension());
+    }
+
+    RenderResult renderFile(TrinityAudioProcessor& processor,
+                            AudioFormatManager& formats,
+                            const File& input,
+                            const RenderOptions& options)
+    {
+        RenderResult result;
+        const int64 startTicks = Time::getHighResolutionTicks();
+
+        std::unique_ptr<AudioFormatReader> reader(formats.createReaderFor(input));
+        if (reader == nullptr)
+        {
+            result.error = "unsupported or unreadable file";
+            return result;
+        }
+        result.numChannels = static_cast<int>(reader->numChannels);
+        result.sampleRate = reader->sampleRate;
+        if (result.numChannels < 1 || result.numChannels > 2)
+        {
+            result.error = "only mono and stereo files are supported";
+            return result;
+        }
+
+        AudioFormat* format = formats.findFormatForFileExtension(input.getFileExtension());
+        if (format == nullptr)
+        {
+            result.error = "no writer for " + input.getFileExtension();
+            return result;
+        }
+        result.output = outputFileFor(input, options);
+        result.output.getParentDirectory().createDirectory();
+        result.output.deleteFile();
+        auto stream = std::make_unique<FileOutputStream>(result.output);
+        if (!stream->openedOk())
+        {
+            result.error = "cannot write " + result.output.getFullPathName();
+            return result;
+        }
+        std::unique_ptr<AudioFormatWriter> writer(format->createWriterFor(stream.get(),
+                                                                          reader->sampleRate,
+                                                                          reader->numChannels,
+                                                                          chooseBitDepth(*format, static_cast<int>(reader->bitsPerSample)),
+                                                                          {},
+                                                                          0));
+        if (writer == nullptr)
+        {
+            result.error = "cannot create writer";
+            return result;
+        }
+        stream.release(); // now owned by the writer
+
+        const int blockSize = options.blockSize;
+        processor.setPlayConfigDetails(result.numChannels, result.numChannels, reader->sampleRate, blockSize);
+        processor.prepareToPlay(reader->sampleRate, blockSize);
+        processor.setSoloMode(options.soloMode);
+
+        AudioBuffer<float> buffer(result.numChannels, blockSize);
+        MidiBuffer midi;
+        int64 processTicks = 0;
+        for (int64 position = 0; position < reader->lengthInSamples; position += blockSize)
+        {
+            const int numSamples = static_cast<int>(jmin(static_cast<int64>(blockSize), reader->lengthInSamples - position));
+            reader->read(&buffer, 0, numSamples, position, true, true);
+            AudioBuffer<float> block(buffer.getArrayOfWritePointers(), result.numChannels, numSamples);
+
+            const int64 blockStart = Time::getHighResolutionTicks();
+            processor.processBlock(block, midi);
+            processTicks += Time::getHighResolutionTicks() - blockStart;
+
+            writer->writeFromAudioSampleBuffer(block, 0, numSamples);
+        }
+        processor.releaseResources();
+        writer.reset();
+
+        result.audioSeconds = static_cast<double>(reader->lengthInSamples) / reader->sampleRate;
+        result.processSeconds = Time::highResolutionTicksToSeconds(processTicks);
+        result.totalSeconds = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - startTicks);
+        return result;
+    }
+
+    double realtimeFactor(double audioSeconds, double wallSeconds)
+    {
+        return wallSeconds > 0.0 ? audioSeconds / wallSeconds : 0.0;
+    }
+
+    // Replays a spike bundle; each run starts from a freshly prepared processor
+    // so every run sees the same state sequence.
+    int replaySpikeBundle(const RenderOptions& options)
+    {
+        SpikeBundle bundle;
+        if (!SpikeBundleFile::read(options.replayFile, bundle))
+        {
+            std::fprintf(stderr, "%s: not a valid spike bundle\n", options.replayFile.getFullPathName().toRawUTF8());
+            return 2;
+        }
+
+        TrinityAudioProcessor processor;
+        AudioBuffer<float> work(bundle.numChannels, bundle.preparedBlockSize);
+        MidiBuffer midi;
+        std::vector<std::vector<double>> blockMs(bundle.blocks.size());
+        for (int run = 0; run < options.replayRuns; ++run)
+        {
+            processor.setPlayConfigDetails(bundle.numChannels, bundle.numChannels, bundle.sampleRate, bundle.preparedBlockSize);
+            processor.prepareToPlay(bundle.sampleRate, bundle.preparedBlockSize);
+            for (size_t blockIndex = 0; blockIndex < bundle.blocks.size(); ++blockIndex)
+            {
+                const SpikeBundleBlock& recorded = bundle.blocks[blockIndex];
+                const int numSamples = jmin(recorded.audio.getNumSamples(), work.getNumSamples());
+                for (int channel = 0; channel < bundle.numChannels; ++channel)
+                {
+                    work.copyFrom(channel, 0, recorded.audio, channel, 0, numSamples);
+                }
+                AudioBuffer<float> block(work.getArrayOfWritePointers(), bundle.numChannels, numSamples);
+                processor.applyParameterSnapshot(recorded.parameters);
+
+                const int64 blockStart = Time::getHighResolutionTicks();
+                processor.processBlock(block, midi);
+                const int64 elapsedTicks = Time::getHighResolutionTicks() - blockStart;
+                blockMs[blockIndex].push_back(Time::highResolutionTicksToSeconds(elapsedTicks) * 1000.0);
+            }
+            processor.releaseResources();
+        }
+
+        std::fprintf(stderr, "bundle: %d block(s), %d ch, %.0f Hz, spike %.3f ms (threshold %.3f ms) at block %d\n",
+                     static_cast<int>(bundle.blocks.size()), bundle.numChannels, bundle.sampleRate,
+                     bundle.spikeMs, bundle.thresholdMs, bundle.spikeBlockIndex);
+        std::printf("block,num_samples,budget_ms,recorded_ms,replay_min_ms,replay_median_ms,replay_max_ms\n");
+        for (size_t blockIndex = 0; blockIndex < blockMs.size(); ++blockIndex)
+        {
+            std::vector<double>& times = blockMs[blockIndex];
+            std::sort(times.begin(), times.end());
+            const int numSamples = bundle.blocks[blockIndex].audio.getNumSamples();
+            const bool isSpike = static_cast<int>(blockIndex) == bundle.spikeBlockIndex;
+            std::printf("%d,%d,%.3f,%s,%.3f,%.3f,%.3f\n",
+                        static_cast<int>(blockIndex), numSamples, 1000.0 * numSamples / bundle.sampleRate,
+                        isSpike ? String(bundle.spikeMs, 3).toRawUTF8() : "",
+                        times.front(), times[times.size() / 2], times.back());
+        }
+        return 0;
+    }
+
+    int measureResponse(const RenderOptions& options)
+    {
+        const int signalType = parseMeasurementSignal(options.measureSignal);
+        if (!MeasurementAnalysis::isMeasurementSignal(signalType))
+        {
+            std::fprintf(stderr, "unknown measurement signal '%s'\n", options.measureSignal.toRawUTF8());
+            return 2;
+        }
+
+        constexpr int numChannels = 2;
+        int reportedLatency = 0;
+        const auto measureWith = [&options, signalType, &reportedLatency](SoloMode soloMode)
+        {
+            TrinityAudioProcessor processor;
+            processor.setPlayConfigDetails(numChannels, numChannels, options.measureRate, options.blockSize);
+            processor.prepareToPlay(options.measureRate, options.blockSize);
+            processor.setSoloMode(soloMode);
+            MidiBuffer midi;
+            const MeasuredResponse measured = MeasurementAnalysis::measure(signalType,
+                                                                           MeasurementSettings {},
+                                                                           options.measureRate,
+                                                                           numChannels,
+                                                                           options.blockSize,
+                                                                           [&processor, &midi](AudioBuffer<float>& block)
+                                                                           {
+                                                                               processor.processBlock(block, midi);
+                                                                           });
+            reportedLatency = processor.getLatencySamples();
+            processor.releaseResources();
+            return measured;
+        };
+        const MeasuredResponse response = measureWith(options.soloMode);
+        // A soloed band starts late by its own filter delay, so the latency
+        // check is always made on the full-band sum
+        const MeasuredResponse fullBand = options.soloMode == SoloMode::None ? response : measureWith(SoloMode::None);
+
+        std::fprintf(stderr, "%s at %.0f Hz: %.3f s of audio, latency %d samples (reported %d), peak at %d\n",
+                     options.measureSignal.toRawUTF8(), options.measureRate, response.audioSeconds,
+                     fullBand.latencySamples, reportedLatency, response.peakIndex);
+        if (options.soloMode != SoloMode::None)
+        {
+            std::fprintf(stderr, "soloed band onset at %d samples\n", response.latencySamples);
+        }
+        std::printf("frequency_hz,magnitude_db,phase_deg\n");
+        for (size_t point = 0; point < response.frequencyHz.size(); ++point)
+        {
+            std::printf("%.2f,%.3f,%.2f\n", response.frequencyHz[point], response.magnitudeDb[point], response.phaseDegrees[point]);
+        }
+        // Multitone does not measure latency
+        return fullBand.latencySamples < 0 || fullBand.latencySamples == reportedLatency ? 0 : 1;
+    }
+
+    void writeTraceIfRequested(const RenderOptions& options)
+    {
+        if (options.traceFile == File())
+        {
+            return;
+        }
+        if (!TraceRecorder::isCompiledIn())
+        {
+            std::fprintf(stderr, "--trace ignored: build with -DTRINITY_ENABLE_TRACING=ON\n");
+        }
+        else if (!TraceRecorder::writeChromeTrace(options.traceFile))
+        {
+            std::fprintf(stderr, "cannot write %s\n", options.traceFile.getFullPathName().toRawUTF8());
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    ScopedJuceInitialiser_GUI juceInitialiser;
+    RenderOptions options;
+    if (!parseOptions(argc, argv, options))
+    {
+        printUsage();
+        return 2;
+    }
+
+    if (options.measureSignal.isNotEmpty())
+    {
+        return measureResponse(options);
+    }
+
+    if (options.replayFile != File())
+    {
+        const int exitCode = replaySpikeBundle(options);
+        writeTraceIfRequested(options);
+        return exitCode;
+    }
+
+    const int numWorkers = jmin(options.threads, options.inputs.size());
+    // Processors are created up front so each worker owns exactly one instance
+    std::vector<std::unique_ptr<TrinityAudioProcessor>> processors;
+    for (int worker = 0; worker < numWorkers; ++worker)
+    {
+        processors.push_back(std::make_unique<TrinityAudioProcessor>());
+    }
+
+    std::mutex outputMutex;
+    std::atomic<int> nextInput { 0 };
+    std::atomic<int> failures { 0 };
+    std::atomic<int> workersRemaining { numWorkers };
+    WaitableEvent allDone;
+
+    std::printf("file,channels,sample_rate,audio_s,process_s,total_s,realtime_factor,realtime_factor_total\n");
+    std::fflush(stdout);
+
+    const int64 startTicks = Time::getHighResolutionTicks();
+    ThreadPool pool(numWorkers);
+    for (int worker = 0; worker < numWorkers; ++worker)
+    {
+        pool.addJob([&, worker]
+        {
+            AudioFormatManager formats;
+            formats.registerBasicFormats();
+            for (int inputIndex = nextInput++; inputIndex < options.inputs.size(); inputIndex = nextInput++)
+            {
+                const File& input = options.inputs.getReference(inputIndex);
+                const RenderResult result = renderFile(*processors[static_cast<size_t>(worker)], formats, input, options);
+
+                const std::lock_guard<std::mutex> lock(outputMutex);
+                if (result.error.isNotEmpty())
+                {
+                    ++failures;
+                    std::fprintf(stderr, "%s: %s\n", input.getFullPathName().toRawUTF8(), result.error.toRawUTF8());
+                    continue;
+                }
+                std::printf("%s,%d,%.0f,%.3f,%.3f,%.3f,%.1f,%.1f\n",
+                            input.getFileName().toRawUTF8(), result.numChannels, result.sampleRate,
+                            result.audioSeconds, result.processSeconds, result.totalSeconds,
+                            realtimeFactor(result.audioSeconds, result.processSeconds),
+                            realtimeFactor(result.audioSeconds, result.totalSeconds));
+                std::fflush(stdout);
+            }
+            if (--workersRemaining == 0)
+            {
+                allDone.signal();
+            }
+        });
+    }
+    allDone.wait(-1);
+
+    std::fprintf(stderr, "rendered %d file(s) on %d worker(s) in %.2f s\n",
+                 options.inputs.size() - failures.load(), numWorkers,
+                 Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - startTicks));
+
+    writeTraceIfRequested(options);
+    return failures.load() == 0 ? 0 : 1;
+}